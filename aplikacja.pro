@@ -2,7 +2,7 @@ QT += core gui charts serialport
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
-CONFIG += c++11
+CONFIG += c++17
 
 # The following define makes your compiler emit warnings if you use
 # any Qt feature that has been marked deprecated (the exact warnings
@@ -15,19 +15,77 @@ DEFINES += QT_DEPRECATED_WARNINGS
 # You can also select to disable deprecated APIs only up to a certain version of Qt.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+# Trace messages below this level are compiled out (0 debug, 1 info, 2 warning,
+# 3 none). By default debug builds keep all of them and release builds drop
+# the per-update debug messages.
+#DEFINES += WDS_TRACE_LEVEL=3
+
 SOURCES += \
+    src/CaptureFile.cpp \
+    src/ChannelSchema.cpp \
     src/ChartManager.cpp \
+    src/Cobs.cpp \
+    src/Crc16.cpp \
+    src/Decimator.cpp \
+    src/FilterChain.cpp \
+    src/FrameClock.cpp \
+    src/FrameParser.cpp \
+    src/FrameTimestamper.cpp \
+    src/Histogram.cpp \
+    src/HistoryStore.cpp \
+    src/LogModel.cpp \
+    src/PhysicsEngine.cpp \
+    src/RenderScheduler.cpp \
+    src/ReplayDevice.cpp \
+    src/SampleBlock.cpp \
+    src/SampleBuffer.cpp \
+    src/SampleClock.cpp \
     src/SerialManager.cpp \
+    src/SerialWorker.cpp \
+    src/SessionExporter.cpp \
+    src/SessionFile.cpp \
+    src/SessionRecorder.cpp \
+    src/SignalFilter.cpp \
+    src/StatsMonitor.cpp \
     src/TerminalLogger.cpp \
+    src/Tracer.cpp \
     src/ball.cpp \
     src/main.cpp \
     src/mainwindow.cpp \
     src/platform.cpp
 
 HEADERS += \
+    inc/CaptureFile.h \
+    inc/ChannelSchema.h \
     inc/ChartManager.h \
+    inc/Cobs.h \
+    inc/Crc16.h \
+    inc/Decimator.h \
+    inc/FilterChain.h \
+    inc/FrameClock.h \
+    inc/FrameParser.h \
+    inc/FrameTimestamper.h \
+    inc/Histogram.h \
+    inc/HistoryStore.h \
+    inc/LogModel.h \
+    inc/MpscQueue.h \
+    inc/PhysicsEngine.h \
     inc/SerialManager.h \
+    inc/RenderScheduler.h \
+    inc/ReplayDevice.h \
+    inc/Sample.h \
+    inc/SampleBlock.h \
+    inc/SampleBuffer.h \
+    inc/SampleClock.h \
+    inc/SerialWorker.h \
+    inc/SessionExporter.h \
+    inc/SessionFile.h \
+    inc/SessionRecorder.h \
+    inc/SignalFilter.h \
+    inc/SpscQueue.h \
+    inc/StatsMonitor.h \
     inc/TerminalLogger.h \
+    inc/Tracer.h \
     inc/ball.h \
     inc/mainwindow.h \
     inc/platform.h
@@ -0,0 +1,9 @@
+# All benchmarks, e.g. for CI: qmake bench/bench.pro && make, then run
+# crc16/crc16, pipeline/pipeline and chartrender/chartrender.
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    chartrender \
+    crc16 \
+    pipeline
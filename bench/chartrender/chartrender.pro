@@ -0,0 +1,13 @@
+# Benchmark comparing raster and OpenGL rendering of QtCharts line series.
+# Run with a display (or a virtual one such as Xvfb with Mesa); the OpenGL
+# rows are skipped when no OpenGL context can be created.
+
+QT += testlib charts widgets
+
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+TARGET = chartrender
+
+SOURCES += \
+    tst_chartrender.cpp
@@ -0,0 +1,106 @@
+#include <QtTest>
+#include <QtCharts>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QtMath>
+
+using namespace QtCharts;
+
+/**
+ * @class ChartRenderBenchmark
+ * @brief Measures how long a chart view takes to render a line series.
+ *
+ * Each row builds a chart like the ones in ChartManager (date-time X axis,
+ * antialiased view) with a given number of points and measures a full render
+ * of the view into a pixmap, once with the raster QPainter path and once with
+ * QtCharts' OpenGL series renderer.
+ */
+class ChartRenderBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void render_data();
+    void render();
+
+private:
+    static bool openGLAvailable();
+};
+
+/**
+ * @brief Checks if an OpenGL context can be created on this machine.
+ * @return True if OpenGL rendering is usable, false otherwise.
+ */
+bool ChartRenderBenchmark::openGLAvailable()
+{
+    QOpenGLContext context;
+    QOffscreenSurface surface;
+    surface.create();
+    return context.create() && context.makeCurrent(&surface);
+}
+
+/**
+ * @brief Provides the render modes and point counts to benchmark.
+ */
+void ChartRenderBenchmark::render_data()
+{
+    QTest::addColumn<bool>("openGL");
+    QTest::addColumn<int>("points");
+
+    for (int points : { 1000, 10000, 100000, 1000000 }) {
+        QTest::newRow(qPrintable(QString("raster/%1").arg(points))) << false << points;
+        QTest::newRow(qPrintable(QString("opengl/%1").arg(points))) << true << points;
+    }
+}
+
+/**
+ * @brief Renders a chart view holding the requested number of points.
+ */
+void ChartRenderBenchmark::render()
+{
+    QFETCH(bool, openGL);
+    QFETCH(int, points);
+
+    if (openGL && !openGLAvailable()) {
+        QSKIP("OpenGL is not available");
+    }
+
+    QVector<QPointF> data;
+    data.reserve(points);
+    for (int i = 0; i < points; ++i) {
+        data.append(QPointF(i, 45 * qSin(i * 0.01) + (i % 7) - 3));
+    }
+
+    QLineSeries *series = new QLineSeries();
+    series->setUseOpenGL(openGL);
+    series->replace(data);
+
+    QChart *chart = new QChart();
+    chart->addSeries(series);
+    QDateTimeAxis *axisX = new QDateTimeAxis();
+    axisX->setFormat("hh:mm:ss");
+    axisX->setRange(QDateTime::fromMSecsSinceEpoch(0), QDateTime::fromMSecsSinceEpoch(points));
+    QValueAxis *axisY = new QValueAxis();
+    axisY->setRange(-90, 90);
+    chart->addAxis(axisX, Qt::AlignBottom);
+    chart->addAxis(axisY, Qt::AlignLeft);
+    series->attachAxis(axisX);
+    series->attachAxis(axisY);
+    chart->legend()->hide();
+
+    QChartView view(chart);
+    view.setRenderHint(QPainter::Antialiasing);
+    view.resize(1200, 400);
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+    QBENCHMARK {
+        series->replace(data); // Force the series geometry to be rebuilt
+        QPixmap frame = view.grab();
+        Q_UNUSED(frame);
+    }
+}
+
+QTEST_MAIN(ChartRenderBenchmark)
+
+#include "tst_chartrender.moc"
@@ -0,0 +1,17 @@
+# Microbenchmark comparing the CRC-16-CCITT implementations in Crc16.
+# Build in release mode, e.g. qmake CONFIG+=release && make && ./crc16
+
+TEMPLATE = app
+TARGET = crc16
+
+CONFIG += console c++17
+CONFIG -= app_bundle qt
+
+INCLUDEPATH += ../../inc
+
+SOURCES += \
+    main.cpp \
+    ../../src/Crc16.cpp
+
+HEADERS += \
+    ../../inc/Crc16.h
@@ -0,0 +1,126 @@
+#include "Crc16.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Signature shared by the single-buffer CRC implementations.
+ */
+typedef uint16_t (*CrcFunction)(const char *, std::size_t, uint16_t);
+
+/**
+ * @brief Accumulates results so the compiler cannot drop the measured calls.
+ */
+volatile uint16_t sink;
+
+/**
+ * @brief Measures the average time per byte of one CRC implementation.
+ * @param function The implementation to measure.
+ * @param data The input buffer.
+ * @param length The length of each call in bytes.
+ * @return Nanoseconds per byte.
+ */
+double measure(CrcFunction function, const std::vector<char> &data, std::size_t length)
+{
+    const std::size_t totalBytes = 64 * 1024 * 1024;
+    const std::size_t iterations = totalBytes / length;
+    uint16_t crc = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        crc ^= function(data.data() + (i & 63), length, Crc16::Initial);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    sink = crc;
+
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations * length);
+}
+
+/**
+ * @brief Measures the average time per frame of the batch verification API.
+ * @param data The input buffer.
+ * @param length The length of each frame in bytes.
+ * @param batched True to use Crc16::verify(), false to verify frames one by one.
+ * @return Nanoseconds per frame.
+ */
+double measureBatch(const std::vector<char> &data, std::size_t length, bool batched)
+{
+    const std::size_t batchSize = 64;
+    std::vector<Crc16Frame> frames(batchSize);
+    for (std::size_t i = 0; i < batchSize; ++i) {
+        frames[i].data = data.data() + i;
+        frames[i].length = length;
+        frames[i].expected = Crc16::compute(frames[i].data, length);
+    }
+
+    const std::size_t batches = (16 * 1024 * 1024) / (batchSize * length) + 1;
+    std::size_t matches = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t b = 0; b < batches; ++b) {
+        if (batched) {
+            matches += Crc16::verify(frames.data(), batchSize);
+        } else {
+            for (const Crc16Frame &frame : frames) {
+                matches += Crc16::bitwise(frame.data, frame.length) == frame.expected ? 1 : 0;
+            }
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    sink = static_cast<uint16_t>(matches);
+
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(batches * batchSize);
+}
+
+} // namespace
+
+/**
+ * @brief Runs the CRC microbenchmark.
+ *
+ * Verifies that every implementation agrees with the bitwise reference, then
+ * prints nanoseconds per byte for a range of frame lengths (the ASCII
+ * telemetry frames are roughly 12 to 24 bytes long) and the per-frame cost of
+ * verifying a batch of frames with Crc16::verify() against a loop over the
+ * bitwise implementation.
+ */
+int main()
+{
+    std::vector<char> data(64 * 1024 + 64);
+    std::srand(1);
+    for (char &byte : data) {
+        byte = static_cast<char>(std::rand());
+    }
+
+    for (std::size_t length = 0; length < 300; ++length) {
+        uint16_t expected = Crc16::bitwise(data.data(), length);
+        if (Crc16::bytewise(data.data(), length) != expected
+            || Crc16::slice4(data.data(), length) != expected
+            || Crc16::slice8(data.data(), length) != expected) {
+            std::printf("Mismatch at length %zu\n", length);
+            return 1;
+        }
+    }
+
+    const std::size_t lengths[] = { 8, 16, 24, 64, 256, 4096, 65536 };
+
+    std::printf("%8s %10s %10s %10s %10s %9s\n", "bytes", "bitwise", "bytewise", "slice4", "slice8", "speedup");
+    for (std::size_t length : lengths) {
+        double bitwise = measure(&Crc16::bitwise, data, length);
+        double bytewise = measure(&Crc16::bytewise, data, length);
+        double slice4 = measure(&Crc16::slice4, data, length);
+        double slice8 = measure(&Crc16::slice8, data, length);
+        std::printf("%8zu %8.3fns %8.3fns %8.3fns %8.3fns %8.1fx\n",
+                    length, bitwise, bytewise, slice4, slice8, bitwise / slice8);
+    }
+
+    std::printf("\n%8s %14s %14s %9s\n", "frame", "bitwise/frame", "verify/frame", "speedup");
+    for (std::size_t length : { 16, 24, 32 }) {
+        double single = measureBatch(data, length, false);
+        double batched = measureBatch(data, length, true);
+        std::printf("%8zu %12.2fns %12.2fns %8.1fx\n", length, single, batched, single / batched);
+    }
+    return 0;
+}
@@ -0,0 +1,53 @@
+# Benchmarks of the acquisition-to-render pipeline: CRC, frame decoding,
+# filtering, chart updates, log lines and chart rendering. Runs headless;
+# the charts are rendered offscreen unless QT_QPA_PLATFORM is set. For CI, e.g.
+# ./pipeline -csv -o results.csv,csv
+
+QT += testlib charts widgets
+
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+TARGET = pipeline
+
+INCLUDEPATH += ../../inc
+
+SOURCES += \
+    tst_pipeline.cpp \
+    ../../src/ChannelSchema.cpp \
+    ../../src/ChartManager.cpp \
+    ../../src/Cobs.cpp \
+    ../../src/Crc16.cpp \
+    ../../src/Decimator.cpp \
+    ../../src/FilterChain.cpp \
+    ../../src/FrameParser.cpp \
+    ../../src/Histogram.cpp \
+    ../../src/HistoryStore.cpp \
+    ../../src/LogModel.cpp \
+    ../../src/RenderScheduler.cpp \
+    ../../src/SampleBlock.cpp \
+    ../../src/SampleBuffer.cpp \
+    ../../src/SampleClock.cpp \
+    ../../src/SignalFilter.cpp \
+    ../../src/TerminalLogger.cpp \
+    ../../src/Tracer.cpp
+
+HEADERS += \
+    ../../inc/ChannelSchema.h \
+    ../../inc/ChartManager.h \
+    ../../inc/Cobs.h \
+    ../../inc/Crc16.h \
+    ../../inc/Decimator.h \
+    ../../inc/FilterChain.h \
+    ../../inc/FrameParser.h \
+    ../../inc/Histogram.h \
+    ../../inc/HistoryStore.h \
+    ../../inc/LogModel.h \
+    ../../inc/MpscQueue.h \
+    ../../inc/RenderScheduler.h \
+    ../../inc/SampleBlock.h \
+    ../../inc/SampleBuffer.h \
+    ../../inc/SampleClock.h \
+    ../../inc/SignalFilter.h \
+    ../../inc/TerminalLogger.h \
+    ../../inc/Tracer.h
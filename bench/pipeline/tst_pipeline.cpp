@@ -0,0 +1,477 @@
+#include <QtTest>
+#include <QtCharts>
+#include <QListView>
+#include <QtMath>
+#include "ChartManager.h"
+#include "Crc16.h"
+#include "FilterChain.h"
+#include "FrameParser.h"
+#include "TerminalLogger.h"
+#include <cstring>
+
+using namespace QtCharts;
+
+namespace {
+
+/**
+ * @brief Sample rate of the synthetic data in Hz.
+ */
+const int sampleRate = 1000;
+
+/**
+ * @brief Samples delivered per display frame at the sample rate and 60 Hz.
+ */
+const int frameSamples = sampleRate / 60;
+
+/**
+ * @brief Receives results so the compiler cannot drop the measured calls.
+ */
+volatile uint16_t sink;
+
+/**
+ * @brief Fills a block with roll and pitch samples taken every millisecond.
+ * @param block The block; previous contents are discarded.
+ * @param start The timestamp of the first sample in milliseconds.
+ * @param count The number of samples.
+ */
+void fillBlock(SampleBlock &block, qint64 start, int count)
+{
+    block.reset(2);
+    block.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        double values[2] = { 30 * qSin((start + i) * 0.003), 30 * qCos((start + i) * 0.002) + (i % 7) - 3 };
+        block.append((start + i) * 1000000, values, 2); // Blocks hold nanoseconds
+    }
+}
+
+/**
+ * @brief Feeds a window of data to a chart manager and draws it once.
+ * @param charts The chart manager.
+ * @param start The timestamp of the first sample in milliseconds.
+ * @param window The length of the window in milliseconds.
+ * @return The timestamp following the last sample.
+ */
+qint64 fillCharts(ChartManager &charts, qint64 start, qint64 window)
+{
+    charts.setChartDuration(window);
+    charts.getRenderScheduler()->setMaxRefreshRate(1000 * 1000); // Every tick renders
+
+    SampleBlock block;
+    for (qint64 time = start; time < start + window; time += sampleRate) {
+        fillBlock(block, time, sampleRate);
+        charts.updateCharts(block);
+    }
+    charts.getRenderScheduler()->tick();
+    return start + window;
+}
+
+/**
+ * @brief Makes one second of attitude samples at 1 kHz with a zero roll rate.
+ * @param pitch Gives the pitch of a sample from its index.
+ * @return The samples, timestamped every millisecond from 1 ms on.
+ */
+QVector<Sample> makeSamples(double (*pitch)(int))
+{
+    QVector<Sample> samples(sampleRate);
+    for (int i = 0; i < sampleRate; ++i) {
+        samples[i].timestamp = (i + 1) * 1000000LL; // Time-based filters treat 0 as unset
+        samples[i].channelCount = 2;
+        samples[i].values[0] = 0;
+        samples[i].values[1] = pitch(i);
+    }
+    return samples;
+}
+
+/**
+ * @brief Filters samples in place, in reads of 32 samples as the worker does.
+ * @param description The filter chain, in the syntax of FilterChain.
+ * @param samples The samples.
+ * @return True if the description was valid.
+ */
+bool filterSamples(const QString &description, QVector<Sample> &samples)
+{
+    FilterChain chain;
+    if (!chain.configure(description, ChannelSchema::attitude())) {
+        return false;
+    }
+    for (int offset = 0; offset < samples.size(); offset += 32) {
+        chain.process(samples.data() + offset, qMin(32, samples.size() - offset));
+    }
+    return true;
+}
+
+} // namespace
+
+/**
+ * @class PipelineBenchmark
+ * @brief Measures every stage from received bytes to rendered charts without hardware.
+ *
+ * The stages are timed separately so a regression can be traced to one of
+ * them: the CRC of a frame, decoding a stream of frames in each wire format,
+ * filtering the decoded samples, one display frame of chart updates and log lines, and rendering the chart
+ * views. Charts are rendered offscreen unless QT_QPA_PLATFORM says
+ * otherwise, so the suite runs on machines without a display. The filters
+ * are also checked on known signals, since a fast filter that returns the
+ * wrong values is no use.
+ */
+class PipelineBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void crc16_data();
+    void crc16();
+    void parse_data();
+    void parse();
+    void filter_data();
+    void filter();
+    void filterConstant_data();
+    void filterConstant();
+    void filterOutlier();
+    void filterAttenuation_data();
+    void filterAttenuation();
+    void filterConvergence_data();
+    void filterConvergence();
+    void updateCharts_data();
+    void updateCharts();
+    void logMeasurements();
+    void renderCharts_data();
+    void renderCharts();
+};
+
+/**
+ * @brief Provides the frame lengths to benchmark; text frames are 12 to 24 bytes long.
+ */
+void PipelineBenchmark::crc16_data()
+{
+    QTest::addColumn<int>("length");
+
+    for (int length : { 12, 24, 64 }) {
+        QTest::newRow(qPrintable(QString("%1 bytes").arg(length))) << length;
+    }
+}
+
+/**
+ * @brief Computes the CRC of one frame.
+ */
+void PipelineBenchmark::crc16()
+{
+    QFETCH(int, length);
+
+    QByteArray frame(length, 0);
+    for (int i = 0; i < length; ++i) {
+        frame[i] = static_cast<char>('0' + i % 10);
+    }
+
+    QBENCHMARK {
+        sink = Crc16::compute(frame.constData(), static_cast<std::size_t>(frame.size()));
+    }
+}
+
+/**
+ * @brief Provides the wire formats to benchmark.
+ */
+void PipelineBenchmark::parse_data()
+{
+    QTest::addColumn<bool>("binary");
+    QTest::addColumn<bool>("sequenced");
+
+    QTest::newRow("text") << false << false;
+    QTest::newRow("text/sequenced") << false << true;
+    QTest::newRow("binary") << true << false;
+    QTest::newRow("binary/sequenced") << true << true;
+}
+
+/**
+ * @brief Decodes one second of frames at 1 kHz, delivered in reads of 512 bytes.
+ *
+ * This is the decoding loop of SerialWorker::readSerialData() without the
+ * port: bytes are copied into the parser's buffer and every complete frame
+ * is taken out after each read.
+ */
+void PipelineBenchmark::parse()
+{
+    QFETCH(bool, binary);
+    QFETCH(bool, sequenced);
+
+    QByteArray stream;
+    for (int i = 0; i < sampleRate; ++i) {
+        Frame frame;
+        frame.channelCount = 2;
+        frame.values[0] = qRound(3000 * qSin(i * 0.003)) / 100.0;
+        frame.values[1] = qRound(3000 * qCos(i * 0.002)) / 100.0;
+        frame.sequenced = sequenced;
+        frame.sequence = static_cast<uint32_t>(i);
+        frame.deviceTime = static_cast<uint32_t>(i * 1000);
+
+        if (binary) {
+            char packet[FrameParser::MaxPacketLength];
+            stream.append(packet, static_cast<int>(FrameParser::encodePacket(frame, packet)));
+        } else {
+            QByteArray line = sequenced
+                ? QString("s%1 %2 %3 %4").arg(frame.sequence).arg(frame.deviceTime)
+                      .arg(frame.values[0], 0, 'f', 2).arg(frame.values[1], 0, 'f', 2).toLatin1()
+                : QString("b%1 %2").arg(frame.values[0], 0, 'f', 2).arg(frame.values[1], 0, 'f', 2).toLatin1();
+            uint16_t crc = Crc16::compute(line.constData(), static_cast<std::size_t>(line.size()));
+            stream.append(line).append(' ').append(QByteArray::number(crc, 16)).append("\n\r");
+        }
+    }
+
+    FrameParser parser;
+    int frames = 0;
+    QBENCHMARK {
+        frames = 0;
+        for (int offset = 0; offset < stream.size();) {
+            std::size_t size;
+            char *target = parser.writeBuffer(size);
+            int chunk = qMin(qMin(512, static_cast<int>(size)), stream.size() - offset);
+            std::memcpy(target, stream.constData() + offset, static_cast<std::size_t>(chunk));
+            parser.commit(static_cast<std::size_t>(chunk));
+            offset += chunk;
+
+            Frame frame;
+            FrameParser::Status status;
+            while ((status = parser.next(frame)) != FrameParser::Status::NeedMoreData) {
+                frames += status == FrameParser::Status::Frame ? 1 : 0;
+            }
+        }
+    }
+    QCOMPARE(frames, sampleRate);
+}
+
+/**
+ * @brief Provides the filter chains to benchmark, in the syntax of FilterChain.
+ */
+void PipelineBenchmark::filter_data()
+{
+    QTest::addColumn<QString>("description");
+
+    QTest::newRow("average") << "average(16)";
+    QTest::newRow("median") << "median(9)";
+    QTest::newRow("fir") << "fir(10, 1000, 31)";
+    QTest::newRow("lowpass") << "lowpass(10, 1000)";
+    QTest::newRow("kalman") << "kalman(100, 1)";
+    QTest::newRow("complementary") << "complementary(0.5, Roll) @ Pitch";
+    QTest::newRow("chain") << "median(5); lowpass(10, 1000); kalman(100, 1)";
+}
+
+/**
+ * @brief Filters one second of samples at 1 kHz, in reads of 32 samples.
+ *
+ * This is the filtering step of SerialWorker::queueFrames() without the
+ * port: the stamped samples of every read are filtered in place.
+ */
+void PipelineBenchmark::filter()
+{
+    QFETCH(QString, description);
+
+    QVector<Sample> samples(sampleRate);
+    for (int i = 0; i < sampleRate; ++i) {
+        samples[i].timestamp = (i + 1) * 1000000LL; // Time-based filters treat 0 as unset
+        samples[i].channelCount = 2;
+        samples[i].values[0] = 30 * qSin(i * 0.003) + (i % 7) - 3;
+        samples[i].values[1] = 30 * qCos(i * 0.002) + (i % 5) - 2;
+    }
+
+    FilterChain chain;
+    QVERIFY(chain.configure(description, ChannelSchema::attitude()));
+    QVector<Sample> block;
+    QBENCHMARK {
+        block = samples;
+        chain.reset(); // Every run starts from the same state
+        for (int offset = 0; offset < sampleRate; offset += 32) {
+            chain.process(block.data() + offset, qMin(32, sampleRate - offset));
+        }
+    }
+    sink = static_cast<uint16_t>(block.last().values[1]);
+}
+
+/**
+ * @brief Provides every filter chain of the benchmark.
+ */
+void PipelineBenchmark::filterConstant_data()
+{
+    filter_data();
+}
+
+/**
+ * @brief Checks that a constant signal passes through unchanged.
+ *
+ * The roll rate is zero, so the complementary filter sees a level board.
+ */
+void PipelineBenchmark::filterConstant()
+{
+    QFETCH(QString, description);
+
+    QVector<Sample> samples = makeSamples([](int) { return 12.5; });
+    QVERIFY(filterSamples(description, samples));
+    for (const Sample &sample : samples) {
+        QVERIFY(qAbs(sample.values[0]) < 1e-9);
+        QVERIFY(qAbs(sample.values[1] - 12.5) < 1e-9);
+    }
+}
+
+/**
+ * @brief Checks that the median filter removes a single outlier.
+ */
+void PipelineBenchmark::filterOutlier()
+{
+    QVector<Sample> samples = makeSamples([](int i) { return i == sampleRate / 2 ? 1000.0 : 12.5; });
+    QVERIFY(filterSamples("median(9)", samples));
+    for (const Sample &sample : samples) {
+        QCOMPARE(sample.values[1], 12.5);
+    }
+}
+
+/**
+ * @brief Provides the low-pass filters, all with a cut-off of 10 Hz.
+ */
+void PipelineBenchmark::filterAttenuation_data()
+{
+    QTest::addColumn<QString>("description");
+
+    QTest::newRow("fir") << "fir(10, 1000, 31)";
+    QTest::newRow("lowpass") << "lowpass(10, 1000)";
+}
+
+/**
+ * @brief Checks that a low-pass filter keeps the mean and removes a 250 Hz tone.
+ *
+ * The tone has an amplitude of 10 around a mean of 5; once the filter has
+ * settled, the output may not stray more than 0.1 from the mean.
+ */
+void PipelineBenchmark::filterAttenuation()
+{
+    QFETCH(QString, description);
+
+    QVector<Sample> samples = makeSamples([](int i) { return 5 + 10 * qSin(2 * M_PI * 250 * i / sampleRate + 0.3); });
+    QVERIFY(filterSamples(description, samples));
+    for (int i = sampleRate / 2; i < sampleRate; ++i) {
+        QVERIFY2(qAbs(samples[i].values[1] - 5) < 0.1, qPrintable(QString::number(samples[i].values[1])));
+    }
+}
+
+/**
+ * @brief Provides the angle estimators.
+ */
+void PipelineBenchmark::filterConvergence_data()
+{
+    QTest::addColumn<QString>("description");
+
+    QTest::newRow("kalman") << "kalman(100, 1)";
+    QTest::newRow("complementary") << "complementary(0.05, Roll) @ Pitch";
+}
+
+/**
+ * @brief Checks that an angle estimator follows a step to a constant angle.
+ *
+ * The pitch jumps from 0 to 20 degrees after 100 ms; by the end of the
+ * second the estimate has to be within 0.01 degrees of it.
+ */
+void PipelineBenchmark::filterConvergence()
+{
+    QFETCH(QString, description);
+
+    QVector<Sample> samples = makeSamples([](int i) { return i < sampleRate / 10 ? 0.0 : 20.0; });
+    QVERIFY(filterSamples(description, samples));
+    QVERIFY2(qAbs(samples.last().values[1] - 20) < 0.01, qPrintable(QString::number(samples.last().values[1])));
+}
+
+/**
+ * @brief Provides the chart windows to benchmark, in milliseconds.
+ */
+void PipelineBenchmark::updateCharts_data()
+{
+    QTest::addColumn<qint64>("window");
+
+    for (qint64 window : { 1000, 10000, 60000, 600000 }) {
+        QTest::newRow(qPrintable(QString("%1 s").arg(window / 1000))) << window;
+    }
+}
+
+/**
+ * @brief Adds one display frame of samples to a full window and redraws the series.
+ *
+ * The window is filled at 1 kHz first, so every update has to rebuild the
+ * series of a full window, as in a running session.
+ */
+void PipelineBenchmark::updateCharts()
+{
+    QFETCH(qint64, window);
+
+    ChartManager charts;
+    qint64 time = fillCharts(charts, QDateTime::currentMSecsSinceEpoch() - window, window);
+
+    SampleBlock block;
+    QBENCHMARK {
+        fillBlock(block, time, frameSamples);
+        time += frameSamples;
+        charts.updateCharts(block);
+        charts.getRenderScheduler()->tick();
+    }
+}
+
+/**
+ * @brief Logs one display frame of samples and hands the lines to the view.
+ */
+void PipelineBenchmark::logMeasurements()
+{
+    QListView view;
+    TerminalLogger logger(&view);
+
+    SampleBlock block;
+    qint64 time = QDateTime::currentMSecsSinceEpoch();
+    fillBlock(block, time, frameSamples);
+    QBENCHMARK {
+        logger.logMeasurements(block);
+        logger.flush();
+    }
+}
+
+/**
+ * @brief Provides the chart windows to render, in milliseconds.
+ */
+void PipelineBenchmark::renderCharts_data()
+{
+    updateCharts_data();
+}
+
+/**
+ * @brief Renders both chart views showing a full window.
+ */
+void PipelineBenchmark::renderCharts()
+{
+    QFETCH(qint64, window);
+
+    ChartManager charts;
+    fillCharts(charts, QDateTime::currentMSecsSinceEpoch() - window, window);
+
+    QChartView *views[] = { charts.getRollChartView(), charts.getPitchChartView() };
+    for (QChartView *view : views) {
+        view->resize(1200, 400);
+        view->show();
+        QVERIFY(QTest::qWaitForWindowExposed(view));
+    }
+
+    QBENCHMARK {
+        for (QChartView *view : views) {
+            QPixmap frame = view->grab();
+            Q_UNUSED(frame);
+        }
+    }
+}
+
+/**
+ * @brief Runs the benchmarks, offscreen unless a platform is chosen explicitly.
+ */
+int main(int argc, char *argv[])
+{
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    PipelineBenchmark benchmark;
+    return QTest::qExec(&benchmark, argc, argv);
+}
+
+#include "tst_pipeline.moc"
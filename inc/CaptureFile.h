@@ -0,0 +1,93 @@
+#ifndef CAPTUREFILE_H
+#define CAPTUREFILE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+/**
+ * @class CaptureWriter
+ * @brief The CaptureWriter class records the raw bytes read from a port together with their read times.
+ *
+ * A capture file starts with the 8-byte Magic and holds one record per
+ * read: the read time in nanoseconds on the SampleClock as a little-endian
+ * 64-bit integer, the number of bytes as a little-endian 32-bit integer and
+ * the bytes themselves. Since the bytes are kept exactly as they were read,
+ * including corrupt frames and the way the stream was split into reads,
+ * replaying a capture reproduces the parser's behaviour exactly.
+ */
+class CaptureWriter
+{
+public:
+    static const char Magic[8];                          ///< The first bytes of every capture file.
+    static const int RecordHeaderLength = 12;            ///< Bytes before the data of each record.
+    static const int MaxRecordLength = 16 * 1024 * 1024; ///< Most bytes in one record; longer ones are corrupt.
+
+    /**
+     * @brief Creates a capture file, replacing an existing one.
+     * @param path The file.
+     * @return True if the file could be created.
+     */
+    bool open(const QString &path);
+
+    /**
+     * @brief Closes the file.
+     */
+    void close();
+
+    /**
+     * @brief Checks if a file is open.
+     * @return True while recording.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Appends the bytes of one read.
+     * @param time The read time in nanoseconds on the SampleClock.
+     * @param data The bytes.
+     * @param size The number of bytes, at most MaxRecordLength.
+     * @return True if the record was written.
+     */
+    bool write(qint64 time, const char *data, qint64 size);
+
+private:
+    QFile file; ///< The capture file.
+};
+
+/**
+ * @class CaptureReader
+ * @brief The CaptureReader class reads the records of a capture file in order.
+ */
+class CaptureReader
+{
+public:
+    /**
+     * @brief Opens a capture file.
+     * @param path The file.
+     * @return True if the file could be opened and starts with CaptureWriter::Magic.
+     */
+    bool open(const QString &path);
+
+    /**
+     * @brief Closes the file.
+     */
+    void close();
+
+    /**
+     * @brief Goes back to the first record.
+     */
+    void rewind();
+
+    /**
+     * @brief Reads the next record.
+     * @param time Receives the read time in nanoseconds.
+     * @param data Receives the bytes; its capacity is reused.
+     * @return True if a record was read, false at the end of the file or on a truncated or corrupt record.
+     */
+    bool next(qint64 &time, QByteArray &data);
+
+private:
+    QFile file; ///< The capture file.
+};
+
+#endif // CAPTUREFILE_H
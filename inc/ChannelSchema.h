@@ -0,0 +1,96 @@
+#ifndef CHANNELSCHEMA_H
+#define CHANNELSCHEMA_H
+
+#include <QMetaType>
+#include <QString>
+#include <QVector>
+
+/**
+ * @struct ChannelDescriptor
+ * @brief Name, unit and plotted range of one measured channel.
+ */
+struct ChannelDescriptor
+{
+    QString name;       ///< The display name, e.g. "Roll" or "Accel X".
+    QString unit;       ///< The unit, e.g. "deg"; may be empty.
+    double minimum = 0; ///< The lower end of the plotted range.
+    double maximum = 0; ///< The upper end of the plotted range; equal to minimum to fit the range to the data.
+};
+
+/**
+ * @class ChannelSchema
+ * @brief The ChannelSchema class describes the channels carried by each frame.
+ *
+ * A frame is a list of values; the schema gives the value at each position
+ * a name and a unit. Everything downstream of the parser (sample blocks,
+ * history, charts and log) is sized and labelled from the schema instead of
+ * assuming a fixed set of channels.
+ */
+class ChannelSchema
+{
+public:
+    static const int MaxChannels = 16; ///< Largest number of channels in a frame.
+
+    /**
+     * @brief Constructs a schema without channels.
+     */
+    ChannelSchema();
+
+    /**
+     * @brief Constructs a schema from channel descriptors.
+     * @param channels The channels in frame order; at most MaxChannels are used.
+     */
+    explicit ChannelSchema(const QVector<ChannelDescriptor> &channels);
+
+    /**
+     * @brief Gets the schema of the roll/pitch attitude board.
+     * @return A schema with the channels "Roll" and "Pitch" in degrees.
+     */
+    static ChannelSchema attitude();
+
+    /**
+     * @brief Gets the schema of a 9-axis IMU with temperature.
+     * @return A schema with accelerometer, gyroscope and magnetometer axes and a temperature channel.
+     */
+    static ChannelSchema imu();
+
+    /**
+     * @brief Parses a schema from a comma-separated list.
+     * @param text Channels in the form "Name[unit]", e.g. "Roll[deg], Pitch[deg], Temp[C]".
+     * @return The parsed schema.
+     */
+    static ChannelSchema fromString(const QString &text);
+
+    /**
+     * @brief Formats the schema in the form accepted by fromString().
+     * @return The channel list.
+     */
+    QString toString() const;
+
+    /**
+     * @brief Gets the number of channels.
+     * @return The number of channels.
+     */
+    int channelCount() const;
+
+    /**
+     * @brief Gets a channel descriptor.
+     * @param index The position of the channel in the frame.
+     * @return The descriptor.
+     */
+    const ChannelDescriptor &channel(int index) const;
+
+    /**
+     * @brief Finds a channel by name, ignoring case.
+     * @param name The channel name.
+     * @return The position of the channel, or -1 if there is none.
+     */
+    int indexOf(const QString &name) const;
+
+private:
+    QVector<ChannelDescriptor> channels; ///< The channels in frame order.
+};
+
+Q_DECLARE_METATYPE(ChannelSchema)
+
+#endif // CHANNELSCHEMA_H
@@ -3,6 +3,12 @@
 
 #include <QObject>
 #include <QtCharts>
+#include "ChannelSchema.h"
+#include "RenderScheduler.h"
+#include "Decimator.h"
+#include "Histogram.h"
+#include "HistoryStore.h"
+#include "SampleBlock.h"
 
 using namespace QtCharts;
 
@@ -11,13 +17,40 @@ using namespace QtCharts;
  * @brief The ChartManager class manages the roll and pitch charts.
  *
  * This class is responsible for creating, updating, and providing access
- * to the roll and pitch charts used in the application.
+ * to the roll and pitch charts used in the application. Incoming samples are
+ * buffered and drawn at most once per display frame, as paced by its
+ * RenderScheduler. Before drawing, the samples are decimated so that the
+ * number of points handed to each series is bounded by the plot width.
+ *
+ * The whole session is also kept in a multi-resolution HistoryStore, so the
+ * charts can be zoomed with the mouse wheel and panned by dragging or with
+ * Shift+wheel over hours of data. A double click returns to the live view.
+ *
+ * Samples may carry any number of channels, as described by a
+ * ChannelSchema. All of them are stored; each chart shows one selected
+ * channel, read straight from the column-wise storage.
+ *
+ * Data from several devices can be overlaid on the same charts. Each device
+ * (source) has its own buffers and one series per chart; all sources share
+ * the time axis.
  */
 class ChartManager : public QObject
 {
     Q_OBJECT
 
 public:
+    static const qint64 HistoryBudget = 256 * 1024 * 1024; ///< Memory shared by the histories of all sources, in bytes.
+    static const qint64 MaxLiveDuration = 60 * 1000;         ///< Longest span kept in the sample buffers, in milliseconds.
+
+    /**
+     * @brief How the data series are drawn.
+     */
+    enum class RenderMode
+    {
+        Raster, ///< Series are drawn with an antialiased QPainter, like the rest of the chart.
+        OpenGL  ///< Series are drawn by QtCharts' OpenGL renderer on an overlay.
+    };
+
     /**
      * @brief Constructs a ChartManager object.
      * @param parent The parent QObject, default is nullptr.
@@ -49,21 +82,236 @@ public:
     QChart* getPitchChart() const;
 
     /**
-     * @brief Updates the charts with new roll and pitch values.
-     * @param currentTime The current timestamp in milliseconds.
-     * @param rollValue The roll value.
-     * @param pitchValue The pitch value.
+     * @brief Gets the scheduler that paces chart redraws.
+     * @return A pointer to the render scheduler.
+     */
+    RenderScheduler* getRenderScheduler() const;
+
+    /**
+     * @brief Sets the time span shown on the charts.
+     * @param duration The duration in milliseconds.
+     */
+    void setChartDuration(qint64 duration);
+
+    /**
+     * @brief Gets the time span shown on the charts.
+     * @return The duration in milliseconds.
+     */
+    qint64 getChartDuration() const;
+
+    /**
+     * @brief Gets the time span kept at full resolution in the sample buffers.
+     * @return The chart duration, at most MaxLiveDuration, in milliseconds.
+     */
+    qint64 getLiveDuration() const;
+
+    /**
+     * @brief Zooms the charts in or out around the right edge of the view.
+     * @param factor The factor to scale the shown time span by; below 1 zooms in.
+     */
+    void zoom(double factor);
+
+    /**
+     * @brief Moves the view along the time axis and stops following new data.
+     * @param delta The time to move by in milliseconds; negative values move back in time.
+     */
+    void pan(qint64 delta);
+
+    /**
+     * @brief Returns to the live view that follows the newest sample.
+     */
+    void followLatest();
+
+    /**
+     * @brief Checks if the view follows the newest sample.
+     * @return True if the view is live, false if it has been panned away.
+     */
+    bool isFollowingLatest() const;
+
+    /**
+     * @brief Sets the decimation algorithm applied before drawing.
+     * @param mode The decimation mode.
+     */
+    void setDecimationMode(Decimator::Mode mode);
+
+    /**
+     * @brief Gets the decimation algorithm applied before drawing.
+     * @return The decimation mode.
+     */
+    Decimator::Mode getDecimationMode() const;
+
+    /**
+     * @brief Selects how the data series are drawn.
+     * @param mode The requested render mode.
+     * @return The render mode actually in use.
+     *
+     * Requesting RenderMode::OpenGL falls back to RenderMode::Raster when no
+     * OpenGL context can be created.
+     */
+    RenderMode setRenderMode(RenderMode mode);
+
+    /**
+     * @brief Gets how the data series are drawn.
+     * @return The render mode in use.
+     */
+    RenderMode getRenderMode() const;
+
+    /**
+     * @brief Checks if an OpenGL context can be created on this machine.
+     * @return True if OpenGL rendering is usable, false otherwise.
+     */
+    static bool isOpenGLAvailable();
+
+    /**
+     * @brief Sets the channels carried by the samples and clears the stored data.
+     * @param schema The channel schema.
+     */
+    void setSchema(const ChannelSchema &schema);
+
+    /**
+     * @brief Gets the channels carried by the samples.
+     * @return The channel schema.
      */
-    void updateCharts(qint64 currentTime, double rollValue, double pitchValue);
+    const ChannelSchema &getSchema() const;
+
+    /**
+     * @brief Selects the channel shown on each chart.
+     * @param rollChartChannel The channel shown on the roll chart, -1 for none.
+     * @param pitchChartChannel The channel shown on the pitch chart, -1 for none.
+     */
+    void setDisplayedChannels(int rollChartChannel, int pitchChartChannel);
+
+    /**
+     * @brief Sets the devices whose data is overlaid on the charts and clears the stored data.
+     * @param names The display names of the devices, shown in the legend.
+     */
+    void setSources(const QStringList &names);
+
+    /**
+     * @brief Gets the number of devices whose data is overlaid on the charts.
+     * @return The number of sources.
+     */
+    int getSourceCount() const;
+
+    /**
+     * @brief Updates the charts with a batch of samples.
+     * @param batch The timestamped samples, oldest first, with one column per schema channel.
+     * @param source The index of the device the samples come from.
+     */
+    void updateCharts(const SampleBlock &batch, int source = 0);
+
+    /**
+     * @brief Adds a batch of samples older than the live view to the history only.
+     * @param batch The timestamped samples, oldest first, with one column per schema channel.
+     * @param source The index of the device the samples come from.
+     */
+    void updateHistory(const SampleBlock &batch, int source = 0);
+
+    /**
+     * @brief Gets the time spent preparing the series of each frame.
+     * @return The durations in nanoseconds.
+     */
+    HistogramSnapshot getUpdateTime() const;
+
+    /**
+     * @brief Gets the time spent repainting a chart view.
+     * @return The durations in nanoseconds.
+     */
+    HistogramSnapshot getRepaintTime() const;
+
+    /**
+     * @brief Gets the time from the arrival of new samples until they were painted.
+     * @return The latencies in nanoseconds.
+     */
+    HistogramSnapshot getDisplayLatency() const;
+
+protected:
+    /**
+     * @brief Handles zoom and pan input on the chart views.
+     * @param watched The object receiving the event.
+     * @param event The event.
+     * @return True if the event was consumed, false otherwise.
+     */
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    /**
+     * @brief Redraws the series from the sample buffer and moves the time axes.
+     */
+    void flush();
 
 private:
-    QLineSeries *rollSeries; ///< Series for roll data points.
-    QLineSeries *pitchSeries; ///< Series for pitch data points.
+    /**
+     * @brief Labels a chart and its value axis after the channel it shows.
+     * @param chart The chart.
+     * @param channel The channel shown on the chart, -1 for none.
+     */
+    void applyChannel(QChart *chart, int channel);
+
+    /**
+     * @brief Fits the value axis of a chart to its points if the channel has no fixed range.
+     * @param chart The chart.
+     * @param channel The channel shown on the chart, -1 for none.
+     * @param minimum The smallest value shown, +infinity if there are none.
+     * @param maximum The largest value shown, -infinity if there are none.
+     */
+    void fitValueAxis(QChart *chart, int channel, double minimum, double maximum);
+
+    /**
+     * @brief Adds an empty series to a chart and attaches it to the chart's axes.
+     * @param chart The chart.
+     * @param name The name shown in the legend.
+     * @return The series, owned by the chart.
+     */
+    QLineSeries* addSeries(QChart *chart, const QString &name);
+
+    /**
+     * @brief Gets the time of the oldest data of any device.
+     * @return The timestamp in nanoseconds since the epoch, or 0 if there is no data.
+     */
+    qint64 firstTimestamp() const;
+
+    /**
+     * @brief Records a repaint of one of the chart views.
+     * @param start The SampleClock time the repaint started.
+     * @param end The SampleClock time the repaint ended.
+     */
+    void recordRepaint(qint64 start, qint64 end);
+
+    /**
+     * @struct Source
+     * @brief The data and series of one device.
+     */
+    struct Source
+    {
+        QString name;             ///< Display name of the device.
+        SampleBuffer samples;     ///< Samples inside the chart duration, oldest first.
+        HistoryStore history;     ///< The whole session at several resolutions.
+        QLineSeries *rollSeries;  ///< Series on the roll chart.
+        QLineSeries *pitchSeries; ///< Series on the pitch chart.
+    };
+
     QChart *rollChart; ///< Chart for displaying roll data.
     QChart *pitchChart; ///< Chart for displaying pitch data.
     QChartView *rollChartView; ///< View for the roll
     QChartView *pitchChartView; ///< View for the pitch chart.
-    qint64 chartDuration; ///< Duration for displaying chart data.
+    qint64 chartDuration; ///< Duration for displaying chart data in milliseconds.
+    RenderScheduler *scheduler; ///< Paces redraws to the display frame rate.
+    QVector<Source> sources; ///< The devices shown on the charts.
+    qint64 lastTimestamp; ///< Timestamp of the newest sample received from any source in nanoseconds since the epoch, 0 if none.
+    Decimator::Mode decimationMode; ///< Decimation applied before drawing.
+    RenderMode renderMode; ///< How the data series are drawn.
+    bool followingLatest; ///< Indicates if the view follows the newest sample.
+    qint64 viewEnd; ///< Right edge of the view in nanoseconds since the epoch while panned.
+    int dragX; ///< Last mouse position of a drag in pixels, -1 if not dragging.
+    ChannelSchema schema; ///< The channels carried by the samples.
+    int rollChannel; ///< The channel shown on the roll chart, -1 for none.
+    int pitchChannel; ///< The channel shown on the pitch chart, -1 for none.
+    qint64 pendingSince; ///< SampleClock time the oldest sample not yet drawn arrived, 0 if none.
+    qint64 flushedSince; ///< pendingSince of the last frame until it has been painted, 0 if none.
+    Histogram updateTime; ///< Duration of flush() in nanoseconds.
+    Histogram repaintTime; ///< Duration of the chart view repaints in nanoseconds.
+    Histogram displayLatency; ///< Time from the arrival of samples until they were painted, in nanoseconds.
 };
 
 
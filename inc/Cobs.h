@@ -0,0 +1,45 @@
+#ifndef COBS_H
+#define COBS_H
+
+#include <cstddef>
+
+/**
+ * @class Cobs
+ * @brief The Cobs class implements Consistent Overhead Byte Stuffing.
+ *
+ * COBS rewrites a packet so that it contains no zero bytes, adding one byte
+ * of overhead per 254 bytes of data. A zero byte can then be used as an
+ * unambiguous packet delimiter on a byte stream, and a receiver that starts
+ * in the middle of a packet resynchronises on the next zero.
+ */
+class Cobs
+{
+public:
+    /**
+     * @brief Gets the largest encoded size of a packet.
+     * @param length The length of the packet in bytes.
+     * @return The maximum number of bytes encode() writes, without the delimiter.
+     */
+    static constexpr std::size_t maxEncodedLength(std::size_t length) { return length + length / 254 + 1; }
+
+    /**
+     * @brief Encodes a packet.
+     * @param data The first byte of the packet.
+     * @param length The length of the packet in bytes.
+     * @param out Receives the encoded bytes; must hold maxEncodedLength(length) bytes.
+     * @return The number of bytes written. No delimiter is appended.
+     */
+    static std::size_t encode(const char *data, std::size_t length, char *out);
+
+    /**
+     * @brief Decodes a packet.
+     * @param data The first encoded byte, without the delimiter.
+     * @param length The number of encoded bytes.
+     * @param out Receives the decoded packet; must hold length bytes.
+     * @param decodedLength Receives the length of the decoded packet on success.
+     * @return True if the input is a valid encoding, false otherwise.
+     */
+    static bool decode(const char *data, std::size_t length, char *out, std::size_t &decodedLength);
+};
+
+#endif // COBS_H
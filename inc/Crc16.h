@@ -0,0 +1,87 @@
+#ifndef CRC16_H
+#define CRC16_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @struct Crc16Frame
+ * @brief A buffered frame whose CRC is to be verified.
+ */
+struct Crc16Frame
+{
+    const char *data;  ///< The first byte covered by the CRC.
+    std::size_t length; ///< The number of bytes covered by the CRC.
+    uint16_t expected; ///< The CRC received with the frame.
+};
+
+/**
+ * @class Crc16
+ * @brief The Crc16 class computes CRC-16-CCITT checksums (polynomial 0x1021, initial value 0xFFFF).
+ *
+ * Several implementations with identical results are provided: the original
+ * bit-at-a-time loop, a byte-wise table lookup and slice-by-4/slice-by-8
+ * variants that fold four or eight bytes per step with independent table
+ * lookups. The lookup tables are generated at compile time.
+ */
+class Crc16
+{
+public:
+    static const uint16_t Initial = 0xFFFF;    ///< Initial CRC register value.
+    static const uint16_t Polynomial = 0x1021; ///< CCITT generator polynomial.
+
+    /**
+     * @brief Computes the checksum one bit at a time.
+     * @param data The first byte of the data.
+     * @param length The number of bytes.
+     * @param crc The initial CRC value, used to continue a previous computation.
+     * @return The computed checksum.
+     */
+    static uint16_t bitwise(const char *data, std::size_t length, uint16_t crc = Initial);
+
+    /**
+     * @brief Computes the checksum one byte at a time using a lookup table.
+     * @param data The first byte of the data.
+     * @param length The number of bytes.
+     * @param crc The initial CRC value, used to continue a previous computation.
+     * @return The computed checksum.
+     */
+    static uint16_t bytewise(const char *data, std::size_t length, uint16_t crc = Initial);
+
+    /**
+     * @brief Computes the checksum four bytes at a time.
+     * @param data The first byte of the data.
+     * @param length The number of bytes.
+     * @param crc The initial CRC value, used to continue a previous computation.
+     * @return The computed checksum.
+     */
+    static uint16_t slice4(const char *data, std::size_t length, uint16_t crc = Initial);
+
+    /**
+     * @brief Computes the checksum eight bytes at a time.
+     * @param data The first byte of the data.
+     * @param length The number of bytes.
+     * @param crc The initial CRC value, used to continue a previous computation.
+     * @return The computed checksum.
+     */
+    static uint16_t slice8(const char *data, std::size_t length, uint16_t crc = Initial);
+
+    /**
+     * @brief Computes the checksum with the fastest available implementation.
+     * @param data The first byte of the data.
+     * @param length The number of bytes.
+     * @return The computed checksum.
+     */
+    static uint16_t compute(const char *data, std::size_t length) { return slice8(data, length); }
+
+    /**
+     * @brief Verifies the checksums of many buffered frames in one call.
+     * @param frames The frames to verify.
+     * @param count The number of frames.
+     * @param valid Receives 1 for every frame whose checksum matches and 0 otherwise; may be nullptr.
+     * @return The number of frames whose checksum matches.
+     */
+    static std::size_t verify(const Crc16Frame *frames, std::size_t count, uint8_t *valid = nullptr);
+};
+
+#endif // CRC16_H
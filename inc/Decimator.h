@@ -0,0 +1,63 @@
+#ifndef DECIMATOR_H
+#define DECIMATOR_H
+
+#include <QPointF>
+#include <QVector>
+#include "SampleBuffer.h"
+
+/**
+ * @class Decimator
+ * @brief The Decimator class reduces a sample buffer to the points worth drawing.
+ *
+ * A chart a few hundred pixels wide cannot show more than a few points per
+ * pixel column, so feeding it every raw sample only costs time. The decimator
+ * bounds the number of output points by the view width while keeping the
+ * visual envelope of the signal.
+ */
+class Decimator
+{
+public:
+    /**
+     * @brief Decimation algorithm.
+     */
+    enum class Mode
+    {
+        None,   ///< Every sample is passed through.
+        MinMax, ///< The minimum and maximum of every pixel column, in time order.
+        Lttb    ///< Largest-Triangle-Three-Buckets down-sampling.
+    };
+
+    /**
+     * @brief Decimates one channel of a sample buffer.
+     * @param mode The decimation algorithm.
+     * @param samples The samples, oldest first.
+     * @param channel The position of the channel to plot.
+     * @param width The width of the plot area in pixels.
+     * @param points Receives the points to draw; previous contents are discarded.
+     */
+    static void decimate(Mode mode, const SampleBuffer &samples, int channel, int width, QVector<QPointF> &points);
+
+    /**
+     * @brief Keeps the minimum and maximum of every pixel column.
+     * @param samples The samples, oldest first.
+     * @param channel The position of the channel to plot.
+     * @param width The number of pixel columns.
+     * @param points Receives at most 2 * width points.
+     *
+     * Columns are equal slices of the time span covered by the samples. The
+     * two extremes of each column are emitted in the order they occurred, so
+     * every spike stays visible and the connecting lines stay monotonic in time.
+     */
+    static void minMax(const SampleBuffer &samples, int channel, int width, QVector<QPointF> &points);
+
+    /**
+     * @brief Down-samples with the Largest-Triangle-Three-Buckets algorithm.
+     * @param samples The samples, oldest first.
+     * @param channel The position of the channel to plot.
+     * @param threshold The number of points to keep; at least 3.
+     * @param points Receives at most threshold points.
+     */
+    static void lttb(const SampleBuffer &samples, int channel, int threshold, QVector<QPointF> &points);
+};
+
+#endif // DECIMATOR_H
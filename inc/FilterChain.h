@@ -0,0 +1,72 @@
+#ifndef FILTERCHAIN_H
+#define FILTERCHAIN_H
+
+#include <QString>
+#include <memory>
+#include <vector>
+#include "ChannelSchema.h"
+#include "Sample.h"
+#include "SignalFilter.h"
+
+/**
+ * @class FilterChain
+ * @brief The FilterChain class runs the samples of every read through a configurable series of filters.
+ *
+ * The chain is described by a text with one stage per ';'. A stage is a
+ * filter with its parameters, optionally followed by '@' and the channels
+ * it applies to, separated by '|'; without them it applies to all
+ * channels. For example
+ *
+ *     median(5); lowpass(8, 1000) @ Roll|Pitch; kalman(50, 0.01)
+ *
+ * The filters are:
+ * - average(length): moving average
+ * - median(length): moving median
+ * - fir(cutoff, sampleRate[, taps]): windowed-sinc FIR low-pass, 31 taps by default
+ * - lowpass(cutoff, sampleRate[, q]): second-order IIR low-pass, Butterworth by default
+ * - kalman(processNoise, measurementNoise): two-state angle/rate Kalman filter
+ * - complementary(timeConstant, rateChannel) @ angleChannel: fuses an angle with its rate
+ *
+ * Frequencies are in Hz and times in seconds. Building the chain allocates
+ * the filters; processing samples does not allocate.
+ */
+class FilterChain
+{
+public:
+    /**
+     * @brief Constructs an empty chain, which leaves samples unchanged.
+     */
+    FilterChain();
+
+    /**
+     * @brief Replaces the filters by the ones described by a text.
+     * @param description The stages; an empty text removes all filters.
+     * @param schema The channels of the samples, used to resolve channel names.
+     * @param error Receives a description of the first problem, if not null.
+     * @return True if the text was valid; otherwise the chain is left unchanged.
+     */
+    bool configure(const QString &description, const ChannelSchema &schema, QString *error = nullptr);
+
+    /**
+     * @brief Forgets all past samples, e.g. after a port is reopened.
+     */
+    void reset();
+
+    /**
+     * @brief Runs samples through all filters in place.
+     * @param samples The samples, oldest first.
+     * @param count The number of samples.
+     */
+    void process(Sample *samples, int count);
+
+    /**
+     * @brief Checks if the chain has filters.
+     * @return True if samples pass unchanged.
+     */
+    bool isEmpty() const;
+
+private:
+    std::vector<std::unique_ptr<SignalFilter>> filters; ///< The stages, in processing order.
+};
+
+#endif // FILTERCHAIN_H
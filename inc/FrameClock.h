@@ -0,0 +1,129 @@
+#ifndef FRAMECLOCK_H
+#define FRAMECLOCK_H
+
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QWindow>
+#include "Histogram.h"
+
+/**
+ * @class FrameClock
+ * @brief The FrameClock class delivers display frames on demand, paced to the screen refresh.
+ *
+ * Nothing happens until requestFrame() is called. The clock then asks the
+ * window for an update with QWindow::requestUpdate(), which the platform
+ * delivers in step with the display where it can, and emits frame() when
+ * the update arrives. The update is not requested before one refresh
+ * interval after the previous frame, less the time the platform has been
+ * measured to take to deliver it, so frames follow the refresh rate of the
+ * screen the window is on, 60 Hz or 144 Hz alike. Without further requests
+ * the clock stops, and while the window is minimised or hidden no frames
+ * are delivered at all; a pending request is served once the window is
+ * shown again.
+ *
+ * While frames are requested back to back, gaps of more than one and a
+ * half intervals are counted as dropped frames, and the deviation of every
+ * frame from the interval is recorded as jitter.
+ */
+class FrameClock : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructs an idle FrameClock without a window.
+     * @param parent The parent object.
+     */
+    explicit FrameClock(QObject *parent = nullptr);
+
+    /**
+     * @brief Sets the window that frames are paced to.
+     * @param window The window; without one, a timer at the default refresh rate paces the frames.
+     */
+    void setWindow(QWindow *window);
+
+    /**
+     * @brief Gets the refresh rate frames are paced to.
+     * @return The frames per second.
+     */
+    double getRefreshRate() const;
+
+    /**
+     * @brief Gets the number of frames delivered.
+     * @return The number of frames.
+     */
+    quint64 getFrameCount() const;
+
+    /**
+     * @brief Gets the number of refresh intervals missed between requested frames.
+     * @return The number of frames.
+     */
+    quint64 getDroppedFrames() const;
+
+    /**
+     * @brief Gets the deviation of consecutive frames from the refresh interval.
+     * @return A snapshot of the deviations in nanoseconds.
+     */
+    HistogramSnapshot getFrameJitter() const;
+
+public slots:
+    /**
+     * @brief Requests that frame() is emitted on the next display refresh.
+     */
+    void requestFrame();
+
+signals:
+    /**
+     * @brief Signal emitted once per delivered frame.
+     */
+    void frame();
+
+protected:
+    /**
+     * @brief Watches the window for update requests and exposure changes.
+     * @param watched The object that received the event.
+     * @param event The event.
+     * @return Always false, so the window still handles the event.
+     */
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    static const qint64 DefaultInterval = 16666667; ///< Refresh interval when the rate is unknown, in nanoseconds.
+
+    QPointer<QWindow> window; ///< The window frames are paced to.
+    QTimer holdTimer;         ///< Waits until the refresh interval has passed.
+    qint64 interval;          ///< The refresh interval in nanoseconds.
+    qint64 lastFrame;         ///< SampleClock time of the previous frame, 0 if none.
+    qint64 requestTime;       ///< SampleClock time the outstanding update was requested.
+    qint64 updateLatency;     ///< Average time the window takes to deliver a requested update.
+    bool framePending;        ///< True if a frame was requested since the last one.
+    bool updateRequested;     ///< True while an update of the window is outstanding.
+    bool continuous;          ///< True if the next frame was requested during the previous one.
+    quint64 frameCount;       ///< Number of frames delivered.
+    quint64 droppedFrames;    ///< Number of refresh intervals missed between requested frames.
+    Histogram frameJitter;    ///< Deviation of consecutive frames from the interval in nanoseconds.
+
+    /**
+     * @brief Asks for the next frame if one is pending and the window is visible.
+     */
+    void schedule();
+
+    /**
+     * @brief Emits frame() and updates the statistics.
+     */
+    void deliver();
+
+    /**
+     * @brief Takes the refresh interval from the screen of the window.
+     */
+    void updateInterval();
+
+    /**
+     * @brief Checks if frames can be shown.
+     * @return False while the window is minimised, hidden or not exposed.
+     */
+    bool isVisible() const;
+};
+
+#endif // FRAMECLOCK_H
@@ -0,0 +1,241 @@
+#ifndef FRAMEPARSER_H
+#define FRAMEPARSER_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @struct Frame
+ * @brief A single decoded measurement frame.
+ *
+ * The meaning of each value is given by the channel schema of the device;
+ * the attitude board sends roll and pitch. Devices may also number their
+ * frames and send the time they were sampled, which lets the receiver
+ * detect lost frames and timestamp them without transport jitter.
+ */
+struct Frame
+{
+    static const std::size_t MaxChannels = 16; ///< Largest number of values in a frame.
+
+    std::size_t channelCount;   ///< Number of values in the frame.
+    double values[MaxChannels]; ///< The values in frame order.
+    bool sequenced;             ///< True if sequence and deviceTime were sent.
+    uint32_t sequence;          ///< Frame counter of the device, wrapping at 2^32.
+    uint32_t deviceTime;        ///< Device clock at sampling time in microseconds, wrapping at 2^32.
+};
+
+/**
+ * @class FrameParser
+ * @brief The FrameParser class decodes measurement frames from a byte stream.
+ *
+ * Two wire formats are understood. The text format is a line
+ * "b<value> <value> ... <crc>\n\r" with a hexadecimal CRC, e.g.
+ * "b<roll> <pitch> <crc>\n\r". The binary format is a COBS-encoded packet
+ * terminated by a zero byte; the decoded packet holds a type byte, the
+ * values (see PacketType) and a little-endian CRC over everything before it.
+ * The number of values follows from the packet length. A binary frame with
+ * two floats takes 13 bytes on the wire, against 20 to 30 for the same
+ * values as text. Both formats have a variant that carries the device's
+ * frame sequence number and sampling time: lines starting with 's' instead
+ * of 'b', "s<sequence> <microseconds> <value> ... <crc>\n\r", and packets
+ * with SequencedFlag set in the type byte.
+ *
+ * By default the format is detected from the stream: the first frame that
+ * passes its CRC fixes the format, and it is detected again after
+ * ResyncErrors consecutive bad frames, e.g. when the device is switched to
+ * the other format. Text never contains zero bytes, so the two cannot be
+ * confused once a frame has been validated.
+ *
+ * Incoming bytes are copied into a fixed-size ring buffer and scanned
+ * incrementally for terminators, so every byte is inspected only once no
+ * matter how the stream is chunked. Frames are decoded directly from the
+ * bytes and no heap allocation happens after construction. The class has no
+ * Qt dependency and can be driven from any byte source.
+ */
+class FrameParser
+{
+public:
+    static const std::size_t Capacity = 4096;          ///< Size of the ring buffer in bytes (power of two).
+    static const std::size_t MaxLineLength = 256;      ///< Longest line or encoded packet accepted before resynchronising.
+    static const std::size_t MaxPacketLength = 77;     ///< Longest packet written by encodePacket(), delimiter included.
+    static const std::size_t SequenceHeaderLength = 8; ///< Sequence number and device time in a sequenced packet.
+    static const int ResyncErrors = 16;                ///< Consecutive bad frames after which the format is detected again.
+
+    /**
+     * @brief Wire format of the stream.
+     */
+    enum class Protocol
+    {
+        Auto,   ///< Detect the format from the stream.
+        Text,   ///< "b<value> <value> ... <crc>\n\r" or "s<sequence> <microseconds> <value> ... <crc>\n\r" lines.
+        Binary  ///< COBS-encoded packets delimited by zero bytes.
+    };
+
+    /**
+     * @brief Type byte at the start of a binary packet.
+     */
+    enum PacketType : unsigned char
+    {
+        FloatPacket = 0x01,  ///< Values as little-endian 32-bit floats.
+        FixedPacket = 0x02,  ///< Values as little-endian 16-bit integers in hundredths of a unit.
+        SequencedFlag = 0x80 ///< Added to the type: a little-endian 32-bit sequence number and device time in microseconds precede the values.
+    };
+
+    /**
+     * @brief Result of a call to next().
+     */
+    enum class Status
+    {
+        Frame,          ///< A valid frame was decoded.
+        NeedMoreData,   ///< No complete line is buffered.
+        CrcMismatch,    ///< The line was well formed but the CRC did not match.
+        InvalidCrc,     ///< The CRC field is not a valid hexadecimal number.
+        InvalidFormat,  ///< The line does not have the expected layout.
+        Overflow        ///< A line exceeded MaxLineLength and was dropped.
+    };
+
+    /**
+     * @brief Constructs an empty FrameParser.
+     */
+    FrameParser();
+
+    /**
+     * @brief Gets a pointer to the contiguous free region of the ring buffer.
+     * @param size Receives the number of bytes that may be written at the pointer.
+     * @return A pointer to the first free byte.
+     *
+     * Allows a byte source to read straight into the ring buffer. Call
+     * commit() with the number of bytes actually written.
+     */
+    char *writeBuffer(std::size_t &size);
+
+    /**
+     * @brief Marks bytes written through writeBuffer() as available for parsing.
+     * @param size The number of bytes written.
+     */
+    void commit(std::size_t size);
+
+    /**
+     * @brief Copies bytes into the ring buffer.
+     * @param data The bytes to append.
+     * @param size The number of bytes to append.
+     * @return The number of bytes accepted, which may be less than size if the buffer is full.
+     */
+    std::size_t write(const char *data, std::size_t size);
+
+    /**
+     * @brief Decodes the next complete frame from the ring buffer.
+     * @param frame Receives the decoded frame when Status::Frame is returned.
+     * @return The outcome of the attempt.
+     *
+     * Call repeatedly until Status::NeedMoreData is returned.
+     */
+    Status next(Frame &frame);
+
+    /**
+     * @brief Discards all buffered bytes and restarts format detection.
+     */
+    void reset();
+
+    /**
+     * @brief Sets the expected wire format.
+     * @param protocol The format, or Protocol::Auto to detect it from the stream.
+     */
+    void setProtocol(Protocol protocol);
+
+    /**
+     * @brief Gets the expected wire format.
+     * @return The format passed to setProtocol(), Protocol::Auto by default.
+     */
+    Protocol protocol() const;
+
+    /**
+     * @brief Gets the wire format currently being decoded.
+     * @return The configured format, the detected format, or Protocol::Auto while detection is pending.
+     */
+    Protocol activeProtocol() const;
+
+    /**
+     * @brief Gets the number of buffered bytes that have not been consumed yet.
+     * @return The number of buffered bytes.
+     */
+    std::size_t available() const;
+
+    /**
+     * @brief Parses a single line without its "\n\r" terminator.
+     * @param line The first byte of the line.
+     * @param length The length of the line in bytes.
+     * @param frame Receives the decoded frame on success.
+     * @return Status::Frame on success, otherwise the reason for rejection.
+     */
+    static Status parseLine(const char *line, std::size_t length, Frame &frame);
+
+    /**
+     * @brief Parses a single COBS-encoded packet without its zero delimiter.
+     * @param packet The first encoded byte.
+     * @param length The number of encoded bytes, at most MaxLineLength.
+     * @param frame Receives the decoded frame on success.
+     * @return Status::Frame on success, otherwise the reason for rejection.
+     */
+    static Status parsePacket(const char *packet, std::size_t length, Frame &frame);
+
+    /**
+     * @brief Encodes a frame as a binary float packet.
+     * @param frame The frame to encode.
+     * @param out Receives the packet including its delimiter; must hold MaxPacketLength bytes.
+     * @return The number of bytes written.
+     */
+    static std::size_t encodePacket(const Frame &frame, char *out);
+
+    /**
+     * @brief Parses a decimal floating point number.
+     * @param begin The first byte of the number.
+     * @param end One past the last byte of the number.
+     * @param value Receives the parsed value on success.
+     * @return True if the whole range is a valid number, false otherwise.
+     */
+    static bool parseDouble(const char *begin, const char *end, double &value);
+
+    /**
+     * @brief Parses a 16-bit hexadecimal number with an optional "0x" prefix.
+     * @param begin The first byte of the number.
+     * @param end One past the last byte of the number.
+     * @param value Receives the parsed value on success.
+     * @return True if the whole range is a valid 16-bit number, false otherwise.
+     */
+    static bool parseHex16(const char *begin, const char *end, uint16_t &value);
+
+private:
+    char buffer[Capacity]; ///< Ring buffer holding unconsumed bytes.
+    std::size_t head;      ///< Stream offset of the first unconsumed byte.
+    std::size_t scan;      ///< Stream offset of the next byte to inspect for a terminator.
+    std::size_t tail;      ///< Stream offset one past the last buffered byte.
+    Protocol configured;   ///< The format set with setProtocol().
+    Protocol active;       ///< The format being decoded; Protocol::Auto until one is detected.
+    int errors;            ///< Consecutive bad frames since the last good one.
+
+    /**
+     * @brief Copies a consumed line or packet out of the ring buffer.
+     * @param start The stream offset of its first byte.
+     * @param length Its length in bytes, at most MaxLineLength.
+     * @param out Receives the bytes.
+     */
+    void copyOut(std::size_t start, std::size_t length, char *out) const;
+
+    /**
+     * @brief Updates format detection with the outcome of a decoded line or packet.
+     * @param status The outcome.
+     * @param protocol The format the line or packet was decoded as.
+     * @return The outcome, unchanged.
+     */
+    Status track(Status status, Protocol protocol);
+
+    /**
+     * @brief Gets the byte at the given stream offset.
+     * @param offset The stream offset.
+     * @return The byte stored at that offset.
+     */
+    char at(std::size_t offset) const { return buffer[offset & (Capacity - 1)]; }
+};
+
+#endif // FRAMEPARSER_H
@@ -0,0 +1,83 @@
+#ifndef FRAMETIMESTAMPER_H
+#define FRAMETIMESTAMPER_H
+
+#include <QtGlobal>
+#include "Sample.h"
+
+/**
+ * @class FrameTimestamper
+ * @brief The FrameTimestamper class estimates when the frames of a serial read were sampled.
+ *
+ * A single read often returns several frames, and all of them would get
+ * the same time if they were stamped with the time of the read. Instead,
+ * the frames of a read are spread backwards from the read time at the
+ * estimated frame period, which is tracked across reads. When the device
+ * numbers its frames, frames lost in between are given their slot, too.
+ *
+ * When the device sends its own sampling time, that is used instead: the
+ * device clock is mapped onto the SampleClock with the smallest offset seen
+ * so far, i.e. the one of the frame that reached the host fastest, which
+ * removes the transport and scheduling jitter from the timestamps. The
+ * offset may grow by up to MaxDriftPpm to follow a device clock that runs
+ * slow; a device clock that runs fast lowers it by itself.
+ *
+ * Timestamps never decrease. The class does no locking and must be used
+ * from one thread.
+ */
+class FrameTimestamper
+{
+public:
+    static const qint64 MaxFramePeriod = 1000000000; ///< Longest frame period in nanoseconds; longer gaps between reads are idle time.
+    static const qint64 MaxSequenceGap = 65536;      ///< Larger jumps in the sequence number are taken as a device restart.
+    static const qint64 MaxDriftPpm = 200;           ///< How fast the device clock offset may grow, in parts per million.
+
+    /**
+     * @brief Constructs a FrameTimestamper with no history.
+     */
+    FrameTimestamper();
+
+    /**
+     * @brief Forgets the frame period, the device clock offset and the last sequence number.
+     */
+    void reset();
+
+    /**
+     * @brief Stamps the frames delivered by one read.
+     * @param samples The frames in the order they were received; timestamp and readTime are set.
+     * @param count The number of frames.
+     * @param readTime The time the read returned, in nanoseconds on the SampleClock.
+     */
+    void stamp(Sample *samples, int count, qint64 readTime);
+
+    /**
+     * @brief Gets the estimated time between two frames.
+     * @return The period in nanoseconds, 0 if not known yet.
+     */
+    qint64 framePeriod() const;
+
+    /**
+     * @brief Gets the number of frames the device numbered but that never arrived.
+     * @return The number of lost frames since construction.
+     */
+    quint64 lostFrames() const;
+
+private:
+    qint64 lastRead;       ///< Time of the previous read, -1 if none.
+    qint64 lastStamp;      ///< The newest timestamp handed out.
+    qint64 period;         ///< Estimated frame period in nanoseconds, 0 if unknown.
+    qint64 lastSequence;   ///< Sequence number of the previous frame, -1 if none.
+    qint64 lastDeviceTime; ///< Device time of the previous frame as sent, -1 if none.
+    qint64 deviceElapsed;  ///< Device time since the first frame in nanoseconds, unwrapped.
+    qint64 deviceOffset;   ///< SampleClock time minus deviceElapsed.
+    quint64 lost;          ///< Number of frames missing from the sequence.
+
+    /**
+     * @brief Maps the device time of a frame onto the SampleClock.
+     * @param deviceTime The device time as sent, in microseconds.
+     * @param readTime The time the read returned.
+     * @return The sampling time in nanoseconds on the SampleClock.
+     */
+    qint64 mapDeviceTime(qint64 deviceTime, qint64 readTime);
+};
+
+#endif // FRAMETIMESTAMPER_H
@@ -0,0 +1,123 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <QtGlobal>
+#include <atomic>
+
+/**
+ * @struct HistogramSnapshot
+ * @brief A copy of the counts of a Histogram taken at one point in time.
+ *
+ * Snapshots are plain values. Subtracting an earlier snapshot of the same
+ * histogram gives the distribution of the values recorded in between, and
+ * snapshots of several histograms can be merged.
+ */
+struct HistogramSnapshot
+{
+    static const int SubBucketBits = 3;                               ///< Each power of two is split into 2^SubBucketBits buckets.
+    static const int SubBuckets = 1 << SubBucketBits;                 ///< Number of buckets per power of two.
+    static const int BucketCount = (65 - SubBucketBits) * SubBuckets; ///< Enough buckets for any 64-bit value.
+
+    quint64 count;                ///< Number of recorded values.
+    quint64 sum;                  ///< Sum of the recorded values.
+    quint64 buckets[BucketCount]; ///< Number of values per bucket.
+
+    /**
+     * @brief Constructs an empty snapshot.
+     */
+    HistogramSnapshot();
+
+    /**
+     * @brief Gets the values recorded after an earlier snapshot.
+     * @param earlier An earlier snapshot of the same histogram.
+     * @return The difference of the two snapshots.
+     */
+    HistogramSnapshot since(const HistogramSnapshot &earlier) const;
+
+    /**
+     * @brief Adds the counts of another snapshot.
+     * @param other The snapshot to add.
+     */
+    void merge(const HistogramSnapshot &other);
+
+    /**
+     * @brief Gets the average of the recorded values.
+     * @return The mean, 0 if there are none.
+     */
+    double mean() const;
+
+    /**
+     * @brief Gets the value below which a given fraction of the recorded values lie.
+     * @param fraction The fraction, between 0 and 1.
+     * @return The middle of the bucket holding the percentile, 0 if there are no values.
+     */
+    double percentile(double fraction) const;
+
+    /**
+     * @brief Gets the largest recorded value.
+     * @return The middle of the highest non-empty bucket, 0 if there are no values.
+     */
+    double maximum() const;
+
+    /**
+     * @brief Gets the bucket a value is counted in.
+     * @param value The value.
+     * @return The index of the bucket.
+     */
+    static int bucketOf(quint64 value);
+
+    /**
+     * @brief Gets the smallest value counted in a bucket.
+     * @param bucket The index of the bucket.
+     * @return The lower bound.
+     */
+    static quint64 lowerBound(int bucket);
+
+    /**
+     * @brief Gets the largest value counted in a bucket.
+     * @param bucket The index of the bucket.
+     * @return The upper bound.
+     */
+    static quint64 upperBound(int bucket);
+};
+
+/**
+ * @class Histogram
+ * @brief The Histogram class counts values such as durations in logarithmic buckets.
+ *
+ * Every power of two is split into SubBuckets linear buckets, so values are
+ * resolved to within 12.5% over the whole 64-bit range with a fixed amount of
+ * memory. Recording is a few relaxed atomic increments and never locks or
+ * allocates, so it can be done on the hot path of any thread while another
+ * thread takes snapshots.
+ */
+class Histogram
+{
+public:
+    /**
+     * @brief Constructs an empty Histogram.
+     */
+    Histogram();
+
+    Histogram(const Histogram &) = delete;
+    Histogram &operator=(const Histogram &) = delete;
+
+    /**
+     * @brief Records a value. May be called from any thread.
+     * @param value The value, e.g. a duration in nanoseconds.
+     */
+    void record(quint64 value);
+
+    /**
+     * @brief Copies the current counts. May be called from any thread.
+     * @return The snapshot.
+     */
+    HistogramSnapshot snapshot() const;
+
+private:
+    std::atomic<quint64> count;                                   ///< Number of recorded values.
+    std::atomic<quint64> sum;                                     ///< Sum of the recorded values.
+    std::atomic<quint64> buckets[HistogramSnapshot::BucketCount]; ///< Number of values per bucket.
+};
+
+#endif // HISTOGRAM_H
@@ -0,0 +1,247 @@
+#ifndef HISTORYSTORE_H
+#define HISTORYSTORE_H
+
+#include <QPointF>
+#include <QVector>
+#include "SampleBlock.h"
+
+/**
+ * @class ChunkedSeries
+ * @brief The ChunkedSeries class is an append-only sequence stored in fixed-size chunks.
+ *
+ * Appending never moves existing elements, and the oldest data is released a
+ * whole chunk at a time, which keeps memory accounting simple and eviction
+ * cheap. All chunks but the last are always full.
+ *
+ * @tparam T The element type.
+ */
+template <typename T>
+class ChunkedSeries
+{
+public:
+    static const int ChunkSize = 8192; ///< Number of elements per chunk.
+
+    /**
+     * @brief Appends an element, starting a new chunk if the last one is full.
+     * @param value The element to append.
+     */
+    void append(const T &value)
+    {
+        if (chunks.isEmpty() || chunks.last().size() == ChunkSize) {
+            chunks.append(QVector<T>());
+            chunks.last().reserve(ChunkSize);
+        }
+        chunks.last().append(value);
+    }
+
+    /**
+     * @brief Gets an element by position.
+     * @param index The position, 0 being the oldest retained element.
+     * @return The element at that position.
+     */
+    const T &at(int index) const { return chunks.at(index / ChunkSize).at(index % ChunkSize); }
+
+    /**
+     * @brief Gets the number of retained elements.
+     * @return The number of elements.
+     */
+    int size() const { return chunks.isEmpty() ? 0 : (chunks.size() - 1) * ChunkSize + chunks.last().size(); }
+
+    /**
+     * @brief Gets the number of allocated chunks.
+     * @return The number of chunks.
+     */
+    int chunkCount() const { return chunks.size(); }
+
+    /**
+     * @brief Gets the memory held by the allocated chunks.
+     * @return The number of bytes.
+     */
+    qint64 memoryUsage() const { return static_cast<qint64>(chunks.size()) * ChunkSize * sizeof(T); }
+
+    /**
+     * @brief Releases the oldest chunk.
+     */
+    void dropFirstChunk() { chunks.remove(0); }
+
+    /**
+     * @brief Releases all chunks.
+     */
+    void clear() { chunks.clear(); }
+
+    /**
+     * @brief Finds the first element whose start time is not before the given time.
+     * @param timestamp The time to search for, in nanoseconds since the epoch.
+     * @return The position of that element, or size() if there is none.
+     */
+    int lowerBound(qint64 timestamp) const
+    {
+        int low = 0;
+        int high = size();
+        while (low < high) {
+            int middle = low + (high - low) / 2;
+            if (startOf(at(middle)) < timestamp) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        return low;
+    }
+
+private:
+    QVector<QVector<T>> chunks; ///< The chunks, oldest first.
+
+    static qint64 startOf(qint64 timestamp) { return timestamp; }
+    template <typename U>
+    static qint64 startOf(const U &summary) { return summary.start; }
+};
+
+/**
+ * @struct ChannelSummary
+ * @brief Minimum, maximum and mean of one channel over a time bucket.
+ */
+struct ChannelSummary
+{
+    double min;     ///< The smallest value in the bucket.
+    double max;     ///< The largest value in the bucket.
+    double mean;    ///< The average value in the bucket (the running sum while the bucket is open).
+    qint64 minTime; ///< The timestamp of the smallest value.
+    qint64 maxTime; ///< The timestamp of the largest value.
+};
+
+/**
+ * @struct Bucket
+ * @brief Time and size of one summary bucket; the values are summarised per channel.
+ */
+struct Bucket
+{
+    qint64 start; ///< The start of the bucket in nanoseconds since the epoch.
+    int count;    ///< The number of samples in the bucket.
+};
+
+/**
+ * @class HistoryStore
+ * @brief The HistoryStore class keeps the whole session at several resolutions.
+ *
+ * Every sample is stored at full resolution and folded into min/max/mean
+ * summaries over 10 ms, 100 ms, 1 s and 10 s buckets, forming a pyramid.
+ * Each level keeps its timestamps and the data of every channel in separate
+ * columns, so reading one channel touches only that channel's memory.
+ * A query picks the finest level whose number of points fits the requested
+ * width, so drawing hours of data reads only a few thousand entries. All
+ * levels use chunked storage under a common memory budget; when it is
+ * exceeded, the oldest chunks of the finest levels are released first, and
+ * queries over that period transparently fall back to coarser levels.
+ */
+class HistoryStore
+{
+public:
+    static const int LevelCount = 5; ///< Raw samples plus four summary levels.
+
+    /**
+     * @brief Constructs an empty HistoryStore.
+     * @param channelCount The number of channels per sample.
+     * @param memoryBudget The maximum number of bytes to retain.
+     */
+    explicit HistoryStore(int channelCount = 0, qint64 memoryBudget = 256 * 1024 * 1024);
+
+    /**
+     * @brief Removes all data and sets the number of channels per sample.
+     * @param channelCount The number of channels, at most ChannelSchema::MaxChannels.
+     */
+    void setChannelCount(int channelCount);
+
+    /**
+     * @brief Gets the number of channels per sample.
+     * @return The number of channels.
+     */
+    int channelCount() const;
+
+    /**
+     * @brief Appends a batch of samples. Samples must be appended in timestamp order.
+     * @param block The samples; channels beyond channelCount() are ignored.
+     */
+    void append(const SampleBlock &block);
+
+    /**
+     * @brief Removes all data.
+     */
+    void clear();
+
+    /**
+     * @brief Checks if the store is empty.
+     * @return True if no sample was appended since construction or the last clear().
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief Gets the time of the oldest retained data.
+     * @return The timestamp in nanoseconds since the epoch, or 0 if the store is empty.
+     */
+    qint64 firstTimestamp() const;
+
+    /**
+     * @brief Gets the time of the newest sample.
+     * @return The timestamp in nanoseconds since the epoch, or 0 if the store is empty.
+     */
+    qint64 lastTimestamp() const;
+
+    /**
+     * @brief Gets the memory currently held by the store.
+     * @return The number of bytes.
+     */
+    qint64 memoryUsage() const;
+
+    /**
+     * @brief Gets the bucket length of a level.
+     * @param level The level, 0 being raw samples.
+     * @return The bucket length in nanoseconds, 0 for raw samples.
+     */
+    static qint64 resolution(int level);
+
+    /**
+     * @brief Picks the finest level that covers a time range within a point budget.
+     * @param from The start of the range in nanoseconds since the epoch.
+     * @param to The end of the range in nanoseconds since the epoch.
+     * @param width The width of the view in pixels.
+     * @return The level to read.
+     */
+    int levelFor(qint64 from, qint64 to, int width) const;
+
+    /**
+     * @brief Reads the points of one channel to draw for a time range.
+     * @param from The start of the range in nanoseconds since the epoch.
+     * @param to The end of the range in nanoseconds since the epoch.
+     * @param width The width of the view in pixels.
+     * @param channel The position of the channel.
+     * @param points Receives the points, with the times on the chart axis in milliseconds; previous contents are discarded.
+     * @return The level that was read.
+     */
+    int query(qint64 from, qint64 to, int width, int channel, QVector<QPointF> &points) const;
+
+private:
+    qint64 memoryBudget;                                          ///< The maximum number of bytes to retain.
+    int channels;                                                 ///< Number of channels per sample.
+    ChunkedSeries<qint64> rawTimes;                               ///< Level 0: the timestamp of every sample.
+    QVector<ChunkedSeries<double>> rawValues;                     ///< Level 0: one column of values per channel.
+    ChunkedSeries<Bucket> buckets[LevelCount - 1];                ///< Levels 1 and up: the closed buckets.
+    QVector<ChunkedSeries<ChannelSummary>> summaries[LevelCount - 1]; ///< Levels 1 and up: one column of summaries per channel.
+    Bucket open[LevelCount - 1];                                  ///< The bucket currently being filled on each summary level.
+    QVector<ChannelSummary> openSummaries[LevelCount - 1];        ///< The channel summaries of the open buckets.
+    qint64 newest;                                                ///< The timestamp of the newest sample.
+
+    /**
+     * @brief Appends one sample of a block to all levels.
+     * @param block The block.
+     * @param index The position of the sample in the block.
+     */
+    void append(const SampleBlock &block, int index);
+
+    /**
+     * @brief Releases the oldest chunks of the finest levels until the budget is met.
+     */
+    void enforceBudget();
+};
+
+#endif // HISTORYSTORE_H
@@ -0,0 +1,71 @@
+#ifndef LOGMODEL_H
+#define LOGMODEL_H
+
+#include <QAbstractListModel>
+#include <QVector>
+
+/**
+ * @class LogModel
+ * @brief The LogModel class holds a bounded number of log lines for a list view.
+ *
+ * Lines are stored as Latin-1 text in fixed-size slots of a ring buffer that
+ * is allocated once, so retaining a line costs no allocation and the memory
+ * use is fixed. When the ring is full, the oldest lines are dropped. A
+ * QString is only built in data(), i.e. for the rows a view actually shows.
+ */
+class LogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    static const int LineLength = 256; ///< Maximum length of a line in bytes; longer lines are truncated.
+
+    /**
+     * @brief Constructs an empty LogModel.
+     * @param capacity The maximum number of retained lines.
+     * @param parent The parent object.
+     */
+    explicit LogModel(int capacity = 10000, QObject *parent = nullptr);
+
+    /**
+     * @brief Appends a batch of lines, dropping the oldest lines if the ring is full.
+     * @param lines The lines, each stored in a slot of LineLength bytes.
+     * @param lineLengths The length of each line in bytes.
+     * @param lineCount The number of lines.
+     */
+    void appendLines(const char *lines, const int *lineLengths, int lineCount);
+
+    /**
+     * @brief Removes all lines.
+     */
+    void clear();
+
+    /**
+     * @brief Gets the maximum number of retained lines.
+     * @return The capacity.
+     */
+    int capacity() const;
+
+    /**
+     * @brief Gets the number of rows.
+     * @param parent The parent index; only the invalid root index has rows.
+     * @return The number of retained lines.
+     */
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    /**
+     * @brief Gets the text of a line.
+     * @param index The index of the line, 0 being the oldest retained line.
+     * @param role The requested role; only Qt::DisplayRole is provided.
+     * @return The line as a string, or an invalid QVariant.
+     */
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    QVector<char> text;   ///< Line slots of LineLength bytes each.
+    QVector<int> lengths; ///< Length of the line in each slot.
+    int first;            ///< Slot of the oldest line.
+    int count;            ///< Number of retained lines.
+};
+
+#endif // LOGMODEL_H
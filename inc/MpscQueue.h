@@ -0,0 +1,111 @@
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @class MpscQueue
+ * @brief The MpscQueue class is a bounded lock-free multi-producer/single-consumer queue.
+ *
+ * Any number of threads may call push() while one thread calls pop(),
+ * without any locking. Every slot carries a sequence number that tells
+ * whether it is free for the producer claiming that position or holds an
+ * element for the consumer; producers claim positions by advancing the
+ * tail with a compare-and-swap. A producer that finds the queue full gives
+ * up instead of waiting.
+ *
+ * @tparam T The element type; it must be cheap to copy.
+ * @tparam Capacity The maximum number of queued elements; must be a power of two.
+ */
+template <typename T, std::size_t Capacity>
+class MpscQueue
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    /**
+     * @brief Constructs an empty queue.
+     */
+    MpscQueue() : head(0), tail(0)
+    {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+    /**
+     * @brief Appends an element. May be called from any thread.
+     * @param value The element to append.
+     * @return True if the element was queued, false if the queue is full.
+     */
+    bool push(const T &value)
+    {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot &slot = slots[t & (Capacity - 1)];
+            std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence == t) {
+                if (tail.compare_exchange_weak(t, t + 1, std::memory_order_relaxed)) {
+                    slot.value = value;
+                    slot.sequence.store(t + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (sequence < t) {
+                return false; // The slot still holds the element from one lap ago
+            } else {
+                t = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Removes up to maxCount elements. Must only be called from the consumer thread.
+     * @param values Receives the removed elements.
+     * @param maxCount The maximum number of elements to remove.
+     * @return The number of elements removed.
+     *
+     * Removal stops at the first position a producer has claimed but not
+     * filled yet; the elements behind it are returned by a later call.
+     */
+    std::size_t pop(T *values, std::size_t maxCount)
+    {
+        std::size_t count = 0;
+        while (count < maxCount) {
+            Slot &slot = slots[head & (Capacity - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != head + 1) {
+                break;
+            }
+            values[count++] = slot.value;
+            slot.sequence.store(head + Capacity, std::memory_order_release);
+            ++head;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Gets the maximum number of queued elements.
+     * @return The queue capacity.
+     */
+    static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+    /**
+     * @struct Slot
+     * @brief An element and the sequence number telling who may use it next.
+     */
+    struct Slot
+    {
+        std::atomic<std::size_t> sequence; ///< Its position when free, its position + 1 when filled.
+        T value;                           ///< The element.
+    };
+
+    alignas(64) std::size_t head;              ///< Position of the next element to pop, used by the consumer only.
+    alignas(64) std::atomic<std::size_t> tail; ///< Position of the next slot to claim, advanced by the producers.
+    alignas(64) Slot slots[Capacity];          ///< Element storage.
+};
+
+#endif // MPSCQUEUE_H
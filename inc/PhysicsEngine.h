@@ -0,0 +1,134 @@
+#ifndef PHYSICSENGINE_H
+#define PHYSICSENGINE_H
+
+#include <QtGlobal>
+
+/**
+ * @struct BallState
+ * @brief Where the ball is and what it is doing, in scene coordinates.
+ */
+struct BallState
+{
+    double x;        ///< The horizontal position of the ball's centre.
+    double y;        ///< The vertical position of the ball's centre, growing downwards.
+    double offset;   ///< The distance from the platform centre along the platform while rolling.
+    double velocity; ///< The speed along the platform while rolling, in units per second.
+    bool falling;    ///< True once the ball has rolled off the platform.
+};
+
+/**
+ * @class PhysicsEngine
+ * @brief The PhysicsEngine class simulates the ball rolling on the tilting platform.
+ *
+ * The simulation advances in fixed steps of StepTime, however often it is
+ * called: the elapsed wall time is collected in an accumulator and as many
+ * whole steps are run as fit into it. The result therefore depends only on
+ * the tilt and the elapsed time, not on how fast samples arrive or frames
+ * are drawn, and the cost is bounded by the step rate. For drawing, state()
+ * interpolates between the last two steps by the fraction of a step left in
+ * the accumulator, so the motion is smooth at any display rate.
+ *
+ * The ball is a solid sphere rolling without slipping, which accelerates it
+ * at 5/7 of g sin(tilt) down the slope. Rolling resistance opposes the
+ * motion with a force proportional to the normal force and holds the ball
+ * on a slope too shallow to overcome it; viscous damping adds a drag
+ * proportional to the speed. Past either end of the platform the ball flies
+ * off with its last velocity and falls freely until it reaches the floor.
+ * Distances are in scene units and the platform's tilt in degrees.
+ */
+class PhysicsEngine
+{
+public:
+    static const qint64 StepTime = 5000000;      ///< Length of a simulation step in nanoseconds (200 Hz).
+    static const qint64 MaxFrameTime = 250000000; ///< Longest time simulated per call; longer pauses are skipped.
+
+    /**
+     * @brief Constructs a PhysicsEngine with the ball at rest in the middle of a level platform.
+     */
+    PhysicsEngine();
+
+    /**
+     * @brief Puts the ball at rest in the middle of the platform and empties the accumulator.
+     */
+    void reset();
+
+    /**
+     * @brief Sets where the platform is.
+     * @param centreX The horizontal position of the platform's pivot.
+     * @param centreY The vertical position of the platform's pivot.
+     * @param halfLength The distance from the pivot to either end.
+     */
+    void setPlatform(double centreX, double centreY, double halfLength);
+
+    /**
+     * @brief Sets the tilt of the platform used by the following steps.
+     * @param degrees The angle, positive making the ball roll towards positive offsets.
+     */
+    void setTilt(double degrees);
+
+    /**
+     * @brief Sets the height of the floor a falling ball stops at.
+     * @param y The vertical position of the ball's centre on the floor.
+     */
+    void setFloor(double y);
+
+    /**
+     * @brief Sets the gravitational acceleration.
+     * @param acceleration The acceleration in scene units per second squared.
+     */
+    void setGravity(double acceleration);
+
+    /**
+     * @brief Sets the losses of the rolling ball.
+     * @param rollingResistance The rolling resistance coefficient (resistance over normal force).
+     * @param damping The viscous damping in 1/s.
+     */
+    void setFriction(double rollingResistance, double damping);
+
+    /**
+     * @brief Runs all simulation steps that fit into the elapsed time.
+     * @param elapsed The time since the previous call in nanoseconds.
+     * @return The number of steps run.
+     */
+    int advance(qint64 elapsed);
+
+    /**
+     * @brief Gets the state to draw, interpolated between the last two steps.
+     * @return The interpolated state.
+     */
+    BallState state() const;
+
+    /**
+     * @brief Checks if the ball has rolled off the platform.
+     * @return True if the ball is falling or lies on the floor.
+     */
+    bool hasFallen() const;
+
+    /**
+     * @brief Checks if the ball has come to rest on the floor.
+     * @return True once the falling ball has reached the floor.
+     */
+    bool hasLanded() const;
+
+private:
+    BallState previous;       ///< The state before the last step.
+    BallState current;        ///< The state after the last step.
+    qint64 accumulator;       ///< Elapsed time not simulated yet, in nanoseconds.
+    double centreX;           ///< The horizontal position of the platform's pivot.
+    double centreY;           ///< The vertical position of the platform's pivot.
+    double halfLength;        ///< The distance from the pivot to either end of the platform.
+    double tilt;              ///< The tilt of the platform in radians.
+    double floor;             ///< The vertical position of the ball's centre on the floor.
+    double gravity;           ///< The gravitational acceleration in units per second squared.
+    double rollingResistance; ///< The rolling resistance coefficient.
+    double damping;           ///< The viscous damping in 1/s.
+    double fallVelocityX;     ///< The horizontal speed of the falling ball.
+    double fallVelocityY;     ///< The vertical speed of the falling ball.
+
+    /**
+     * @brief Advances the simulation by one StepTime.
+     */
+    void step();
+};
+
+#endif // PHYSICSENGINE_H
@@ -0,0 +1,69 @@
+#ifndef RENDERSCHEDULER_H
+#define RENDERSCHEDULER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+
+/**
+ * @class RenderScheduler
+ * @brief The RenderScheduler class coalesces redraw requests into display frames.
+ *
+ * Producers call requestFrame() as often as they like. The scheduler is
+ * ticked by an external frame clock (the FrameClock of the main window)
+ * and emits frameReady() on a tick only if a frame was requested since the
+ * last one and the configured maximum refresh rate allows it. Since that
+ * clock stops when no one needs frames, frameRequested() asks it for a
+ * tick whenever a frame becomes pending.
+ */
+class RenderScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructs a RenderScheduler object.
+     * @param parent The parent object.
+     */
+    explicit RenderScheduler(QObject *parent = nullptr);
+
+    /**
+     * @brief Sets the maximum number of frames per second.
+     * @param hz The maximum refresh rate; values below 1 are clamped to 1.
+     */
+    void setMaxRefreshRate(int hz);
+
+    /**
+     * @brief Gets the maximum number of frames per second.
+     * @return The maximum refresh rate.
+     */
+    int maxRefreshRate() const;
+
+    /**
+     * @brief Requests that a frame is rendered on one of the next ticks.
+     */
+    void requestFrame();
+
+public slots:
+    /**
+     * @brief Advances the frame clock, emitting frameReady() if a frame is due.
+     */
+    void tick();
+
+signals:
+    /**
+     * @brief Signal emitted when the pending changes should be rendered.
+     */
+    void frameReady();
+
+    /**
+     * @brief Signal emitted when a pending frame needs another tick.
+     */
+    void frameRequested();
+
+private:
+    QElapsedTimer clock;     ///< Measures the time since the last frame.
+    qint64 minInterval;      ///< Minimum time between two frames in nanoseconds.
+    bool framePending;       ///< Indicates if a frame was requested since the last one.
+};
+
+#endif // RENDERSCHEDULER_H
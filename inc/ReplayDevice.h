@@ -0,0 +1,99 @@
+#ifndef REPLAYDEVICE_H
+#define REPLAYDEVICE_H
+
+#include <QIODevice>
+#include <QTimer>
+#include "CaptureFile.h"
+
+/**
+ * @class ReplayDevice
+ * @brief The ReplayDevice class plays a capture file back as a read-only stream.
+ *
+ * It is a sequential QIODevice like QSerialPort, so SerialWorker reads a
+ * replay exactly like a live port: readyRead() is emitted when bytes become
+ * available and read() returns them. The records of the capture are
+ * released at their recorded times, scaled by the replay speed, or as fast
+ * as the reader keeps up. Since the bytes and their split into reads are
+ * those of the recording, the parser sees the same input every time.
+ */
+class ReplayDevice : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    static const int MaxBurst = 16384; ///< Bytes released per event loop pass when replaying as fast as possible.
+
+    /**
+     * @brief Constructs a closed ReplayDevice.
+     * @param parent The parent object.
+     */
+    explicit ReplayDevice(QObject *parent = nullptr);
+
+    /**
+     * @brief Opens a capture file and starts the replay.
+     * @param path The capture file.
+     * @param speed The replay speed: 1 for real time, N for N times faster, 0 for as fast as possible.
+     * @return True if the file could be opened.
+     */
+    bool openCapture(const QString &path, double speed);
+
+    /**
+     * @brief Stops the replay and closes the capture file.
+     */
+    void close() override;
+
+    /**
+     * @brief Tells QIODevice that the device is a stream.
+     * @return Always true.
+     */
+    bool isSequential() const override;
+
+    /**
+     * @brief Gets the number of released bytes that have not been read.
+     * @return The number of bytes.
+     */
+    qint64 bytesAvailable() const override;
+
+signals:
+    /**
+     * @brief Signal emitted when the last record of the capture has been released.
+     */
+    void finished();
+
+protected:
+    /**
+     * @brief Copies released bytes out.
+     * @param data Receives the bytes.
+     * @param maxSize The maximum number of bytes to copy.
+     * @return The number of bytes copied.
+     */
+    qint64 readData(char *data, qint64 maxSize) override;
+
+    /**
+     * @brief Rejects writes; the device is read-only.
+     * @param data Unused.
+     * @param maxSize Unused.
+     * @return Always -1.
+     */
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private slots:
+    /**
+     * @brief Releases the records that are due and schedules the next one.
+     */
+    void release();
+
+private:
+    CaptureReader reader; ///< The capture being replayed.
+    QTimer timer;         ///< Fires when the next record is due.
+    double speed;         ///< Replay speed, 0 for as fast as possible.
+    qint64 captureStart;  ///< Recorded time of the first record.
+    qint64 replayStart;   ///< SampleClock time the replay started.
+    qint64 nextTime;      ///< Recorded time of the next record.
+    QByteArray nextData;  ///< Bytes of the next record.
+    bool hasNext;         ///< True while nextTime and nextData hold a record.
+    QByteArray released;  ///< Released bytes; those before readPosition have been read.
+    int readPosition;     ///< Offset of the first unread byte in released.
+};
+
+#endif // REPLAYDEVICE_H
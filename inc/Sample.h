@@ -0,0 +1,31 @@
+#ifndef SAMPLE_H
+#define SAMPLE_H
+
+#include <QMetaType>
+#include <QVector>
+#include "ChannelSchema.h"
+
+/**
+ * @struct Sample
+ * @brief A decoded frame together with the time it was acquired.
+ *
+ * This is the fixed-size record handed from the acquisition thread to the
+ * GUI thread. Downstream, samples are collected into a SampleBlock. Both
+ * times are on the SampleClock; the difference between readTime and the
+ * time a sample is consumed is the latency of the pipeline, and the spread
+ * of the differences between consecutive timestamps is the jitter.
+ */
+struct Sample
+{
+    qint64 timestamp;                          ///< Best estimate of the sampling time in nanoseconds, see FrameTimestamper.
+    qint64 readTime;                           ///< Time the read that delivered the frame returned, in nanoseconds.
+    qint64 sequence;                           ///< Frame counter of the device, -1 if the device sends none.
+    qint64 deviceTime;                         ///< Device clock in microseconds as sent (32 bits, wrapping), -1 if none.
+    int channelCount;                          ///< Number of valid entries in values.
+    double values[ChannelSchema::MaxChannels]; ///< The channel values in frame order.
+};
+
+Q_DECLARE_TYPEINFO(Sample, Q_PRIMITIVE_TYPE);
+Q_DECLARE_METATYPE(Sample)
+
+#endif // SAMPLE_H
@@ -0,0 +1,123 @@
+#ifndef SAMPLEBLOCK_H
+#define SAMPLEBLOCK_H
+
+#include <QMetaType>
+#include <QVector>
+#include "Sample.h"
+#include "SampleClock.h"
+
+/**
+ * @class SampleBlock
+ * @brief The SampleBlock class is a batch of samples stored as one column per channel.
+ *
+ * The timestamps and the values of every channel are kept in separate
+ * contiguous arrays (struct of arrays), so code that works on one channel,
+ * such as decimation or statistics, reads only that channel's memory. The
+ * number of channels is set by the schema and is the same for all samples
+ * in the block. Timestamps are kept in nanoseconds, so samples taken at
+ * kilohertz rates stay distinct and ordered. Clearing keeps the allocated
+ * capacity, so a block that is refilled for every batch stops allocating
+ * once it has grown.
+ */
+class SampleBlock
+{
+public:
+    /**
+     * @brief Constructs an empty SampleBlock.
+     * @param channelCount The number of channels.
+     */
+    explicit SampleBlock(int channelCount = 0);
+
+    /**
+     * @brief Removes all samples and sets the number of channels.
+     * @param channelCount The number of channels.
+     */
+    void reset(int channelCount);
+
+    /**
+     * @brief Removes all samples, keeping the number of channels and the capacity.
+     */
+    void clear();
+
+    /**
+     * @brief Reserves space for a number of samples.
+     * @param capacity The number of samples.
+     */
+    void reserve(int capacity);
+
+    /**
+     * @brief Appends a sample.
+     * @param timestamp The acquisition time in nanoseconds since the epoch.
+     * @param values The channel values in frame order.
+     * @param count The number of values; missing channels are set to NaN and extra values are ignored.
+     */
+    void append(qint64 timestamp, const double *values, int count);
+
+    /**
+     * @brief Appends a decoded sample.
+     * @param sample The sample; its timestamp is converted from the SampleClock to nanoseconds since the epoch.
+     */
+    void append(const Sample &sample) { append(SampleClock::toNSecsSinceEpoch(sample.timestamp), sample.values, sample.channelCount); }
+
+    /**
+     * @brief Appends many samples given as columns.
+     * @param timestamps count timestamps in nanoseconds since the epoch.
+     * @param values One column of count values per channel of the block.
+     * @param count The number of samples.
+     */
+    void append(const qint64 *timestamps, const double *const *values, int count);
+
+    /**
+     * @brief Gets the number of samples.
+     * @return The number of samples.
+     */
+    int size() const { return times.size(); }
+
+    /**
+     * @brief Checks if the block is empty.
+     * @return True if the block holds no samples, false otherwise.
+     */
+    bool isEmpty() const { return times.isEmpty(); }
+
+    /**
+     * @brief Gets the number of channels.
+     * @return The number of channels.
+     */
+    int channelCount() const { return columns.size(); }
+
+    /**
+     * @brief Gets the timestamp of a sample.
+     * @param index The position of the sample, 0 being the oldest.
+     * @return The timestamp in nanoseconds since the epoch.
+     */
+    qint64 timestamp(int index) const { return times.at(index); }
+
+    /**
+     * @brief Gets one value of a sample.
+     * @param channel The position of the channel.
+     * @param index The position of the sample, 0 being the oldest.
+     * @return The value.
+     */
+    double value(int channel, int index) const { return columns.at(channel).at(index); }
+
+    /**
+     * @brief Gets the timestamp column.
+     * @return size() timestamps, oldest first.
+     */
+    const qint64 *timestamps() const { return times.constData(); }
+
+    /**
+     * @brief Gets the column of a channel.
+     * @param channel The position of the channel.
+     * @return size() values, oldest first.
+     */
+    const double *channel(int channel) const { return columns.at(channel).constData(); }
+
+private:
+    QVector<qint64> times;           ///< Timestamps in nanoseconds since the epoch.
+    QVector<QVector<double>> columns; ///< One column of values per channel.
+};
+
+Q_DECLARE_METATYPE(SampleBlock)
+
+#endif // SAMPLEBLOCK_H
@@ -0,0 +1,116 @@
+#ifndef SAMPLEBUFFER_H
+#define SAMPLEBUFFER_H
+
+#include <QVector>
+#include "SampleBlock.h"
+
+/**
+ * @class SampleBuffer
+ * @brief The SampleBuffer class is a time-windowed circular buffer of samples.
+ *
+ * Samples are appended at the back and evicted from the front once they are
+ * older than the window, both in amortised constant time without moving the
+ * remaining samples. The timestamps and each channel are stored in separate
+ * rings that share the same positions, so a single channel can be read
+ * without touching the others. The storage grows by doubling when the window
+ * holds more samples than fit, and is otherwise reused, so steady-state
+ * operation does not allocate. It never grows beyond MaxCapacity samples;
+ * once full, the oldest samples are dropped to make room.
+ */
+class SampleBuffer
+{
+public:
+    static const int MaxCapacity = 1 << 20; ///< Most samples held; with MaxChannels channels, 128 MiB of values.
+
+    /**
+     * @brief Constructs an empty SampleBuffer.
+     * @param channelCount The number of channels per sample.
+     * @param initialCapacity The number of samples to reserve; rounded up to a power of two, at most MaxCapacity.
+     */
+    explicit SampleBuffer(int channelCount = 0, int initialCapacity = 4096);
+
+    /**
+     * @brief Removes all samples and sets the number of channels per sample.
+     * @param channelCount The number of channels.
+     */
+    void setChannelCount(int channelCount);
+
+    /**
+     * @brief Gets the number of channels per sample.
+     * @return The number of channels.
+     */
+    int channelCount() const { return channels; }
+
+    /**
+     * @brief Appends a batch of samples. Samples must be appended in timestamp order.
+     * @param block The samples; channels beyond channelCount() are ignored.
+     *
+     * If the buffer would hold more than MaxCapacity samples, the oldest ones are dropped.
+     */
+    void append(const SampleBlock &block);
+
+    /**
+     * @brief Removes all samples older than the given time.
+     * @param timestamp The oldest timestamp to keep, in nanoseconds since the epoch.
+     */
+    void evictBefore(qint64 timestamp);
+
+    /**
+     * @brief Removes all samples.
+     */
+    void clear();
+
+    /**
+     * @brief Gets the number of stored samples.
+     * @return The number of samples.
+     */
+    int size() const { return count; }
+
+    /**
+     * @brief Checks if the buffer is empty.
+     * @return True if no samples are stored, false otherwise.
+     */
+    bool isEmpty() const { return count == 0; }
+
+    /**
+     * @brief Gets the timestamp of a sample.
+     * @param index The position, 0 being the oldest sample.
+     * @return The timestamp in nanoseconds since the epoch.
+     */
+    qint64 timestamp(int index) const { return times.at((head + index) & mask); }
+
+    /**
+     * @brief Gets one value of a sample.
+     * @param channel The position of the channel.
+     * @param index The position, 0 being the oldest sample.
+     * @return The value.
+     */
+    double value(int channel, int index) const { return values.at(channel * (mask + 1) + ((head + index) & mask)); }
+
+    /**
+     * @brief Gets the timestamp of the oldest sample. The buffer must not be empty.
+     * @return The timestamp in nanoseconds since the epoch.
+     */
+    qint64 firstTimestamp() const { return timestamp(0); }
+
+    /**
+     * @brief Gets the timestamp of the newest sample. The buffer must not be empty.
+     * @return The timestamp in nanoseconds since the epoch.
+     */
+    qint64 lastTimestamp() const { return timestamp(count - 1); }
+
+private:
+    QVector<qint64> times;  ///< Circular timestamp storage; its size is always a power of two.
+    QVector<double> values; ///< One circular ring per channel, each times.size() long, back to back.
+    int channels;           ///< Number of channels per sample.
+    int mask;               ///< times.size() - 1, used to wrap positions.
+    int head;               ///< Storage index of the oldest sample.
+    int count;              ///< Number of stored samples.
+
+    /**
+     * @brief Doubles the storage, moving the samples to the front.
+     */
+    void grow();
+};
+
+#endif // SAMPLEBUFFER_H
@@ -0,0 +1,49 @@
+#ifndef SAMPLECLOCK_H
+#define SAMPLECLOCK_H
+
+#include <QtGlobal>
+
+/**
+ * @class SampleClock
+ * @brief The SampleClock class is the monotonic time base of all acquired samples.
+ *
+ * Samples are stamped in nanoseconds on a monotonic clock, which never
+ * jumps when the wall clock is adjusted and has a much finer resolution
+ * than QDateTime. All ports use this clock, so their samples can be
+ * compared directly. For display, a time on this clock is converted to
+ * the wall clock through an offset taken once, when the clock is first
+ * used. Stored samples keep nanoseconds since the epoch; only the chart
+ * axes work in milliseconds.
+ */
+class SampleClock
+{
+public:
+    /**
+     * @brief Gets the current time. May be called from any thread.
+     * @return The time in nanoseconds on the monotonic clock.
+     */
+    static qint64 now();
+
+    /**
+     * @brief Converts a time on this clock to the wall clock.
+     * @param time The time in nanoseconds on the monotonic clock.
+     * @return The time in nanoseconds since the epoch.
+     */
+    static qint64 toNSecsSinceEpoch(qint64 time);
+
+    /**
+     * @brief Converts a time on this clock to the wall clock in milliseconds.
+     * @param time The time in nanoseconds on the monotonic clock.
+     * @return The time in milliseconds since the epoch.
+     */
+    static qint64 toMSecsSinceEpoch(qint64 time);
+
+    /**
+     * @brief Converts a wall-clock time to the position on the time axis of the charts.
+     * @param time The time in nanoseconds since the epoch.
+     * @return The time in milliseconds since the epoch, keeping the fraction, as QDateTimeAxis expects.
+     */
+    static double toChartTime(qint64 time) { return time / 1e6; }
+};
+
+#endif // SAMPLECLOCK_H
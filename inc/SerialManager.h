@@ -3,13 +3,28 @@
 
 #include <QObject>
 #include <QSerialPort>
+#include <QThread>
+#include <QVector>
+#include "ChannelSchema.h"
+#include "Histogram.h"
+#include "SampleBlock.h"
+#include "SerialWorker.h"
 
 /**
  * @class SerialManager
  * @brief The SerialManager class handles serial communication.
  *
- * This class manages reading data from a serial port and emits signals
- * when new data is received or when the serial port is opened or closed.
+ * This class manages reading data from one or more serial ports and emits
+ * signals when new data is received or when a port is opened or closed.
+ * Every port is owned by its own SerialWorker, and all workers live on one
+ * shared acquisition thread whose event loop waits on all port descriptors
+ * at once, so reading and decoding never wait for the GUI thread and adding
+ * a board does not add a thread. Decoded frames are handed over through a
+ * lock-free queue per port and drained in batches. All ports are stamped
+ * from the same clock, so their samples share one time base. A capture file
+ * can be replayed in place of a port, and the raw bytes of any port can be
+ * recorded into one. Samples can be filtered on the acquisition thread
+ * before they are queued (see FilterChain).
  */
 class SerialManager : public QObject
 {
@@ -27,6 +42,35 @@ public:
      */
     ~SerialManager();
 
+    /**
+     * @brief Adds a serial port and starts reading from it.
+     * @param portName The name of the serial port.
+     * @param baudRate The baud rate for the serial communication.
+     * @return The index of the port, used in signals and by getPortStats().
+     */
+    int addPort(const QString &portName, qint32 baudRate);
+
+    /**
+     * @brief Adds a replayed capture file as a port and starts playing it.
+     * @param path The capture file.
+     * @param speed The replay speed: 1 for real time, N for N times faster, 0 for as fast as possible.
+     * @return The index of the port, used in signals and by getPortStats().
+     */
+    int addReplay(const QString &path, double speed);
+
+    /**
+     * @brief Starts recording the raw bytes read from a port.
+     * @param port The index of the port.
+     * @param path The capture file; an existing file is replaced.
+     */
+    void startCapture(int port, const QString &path);
+
+    /**
+     * @brief Stops recording a port.
+     * @param port The index of the port.
+     */
+    void stopCapture(int port);
+
     /**
      * @brief Starts reading data from the specified serial port.
      * @param portName The name of the serial port.
@@ -35,40 +79,129 @@ public:
     void startReading(const QString &portName, qint32 baudRate);
 
     /**
-     * @brief Stops reading data from the serial port.
+     * @brief Stops reading data from all serial ports.
      */
     void stopReading();
 
+    /**
+     * @brief Gets the number of added ports.
+     * @return The number of ports.
+     */
+    int getPortCount() const;
+
+    /**
+     * @brief Gets the name of a port.
+     * @param port The index of the port.
+     * @return The name passed to addPort().
+     */
+    QString getPortName(int port) const;
+
+    /**
+     * @brief Gets the traffic counters of a port.
+     * @param port The index of the port.
+     * @return A snapshot of the counters.
+     */
+    PortStats getPortStats(int port) const;
+
+    /**
+     * @brief Gets the traffic counters of all ports added up.
+     * @return A snapshot of the counters.
+     */
+    PortStats getTotalStats() const;
+
+    /**
+     * @brief Gets the time the workers of all ports spent decoding each read.
+     * @return The durations in nanoseconds.
+     */
+    HistogramSnapshot getParseTime() const;
+
+    /**
+     * @brief Gets the time samples spent between their read and the drain that emitted them.
+     * @return The latencies in nanoseconds.
+     */
+    HistogramSnapshot getLatency() const;
+
+    /**
+     * @brief Gets the number of samples found in a queue per drain.
+     * @return The queue depths.
+     */
+    HistogramSnapshot getQueueDepth() const;
+
+    /**
+     * @brief Sets the channels carried by each frame.
+     * @param schema The channel schema; ChannelSchema::attitude() by default.
+     */
+    void setSchema(const ChannelSchema &schema);
+
+    /**
+     * @brief Gets the channels carried by each frame.
+     * @return The channel schema.
+     */
+    const ChannelSchema &getSchema() const;
+
+    /**
+     * @brief Sets the filters applied to the samples of all ports on the acquisition thread.
+     * @param description The filter stages, see FilterChain; an empty text removes all filters.
+     * @param error Receives a description of the problem if the text is invalid, if not null.
+     * @return True if the filters were valid and have been sent to the workers.
+     */
+    bool setFilters(const QString &description, QString *error = nullptr);
+
 signals:
     /**
-     * @brief Signal emitted when new data is received from the serial port.
-     * @param rollValue The roll value from the data.
-     * @param pitchValue The pitch value from the data.
+     * @brief Signal emitted once per drain with all samples of a port decoded since the previous one.
+     * @param port The index of the port.
+     * @param samples The timestamped samples, oldest first, with one column per schema channel.
+     *
+     * The block is reused between batches, so receivers must not keep a
+     * reference to it.
      */
-    void newData(double rollValue, double pitchValue);
+    void newSamples(int port, const SampleBlock &samples);
 
     /**
-     * @brief Signal emitted when the serial port is opened or closed.
+     * @brief Signal emitted when a serial port is opened or closed.
+     * @param port The index of the port.
      * @param isOpen Indicates if the serial port is open (true) or closed (false).
      */
-    void serialPortOpened(bool isOpen);
+    void serialPortOpened(int port, bool isOpen);
 
-private slots:
+private:
     /**
-     * @brief Slot to read data from the serial port.
+     * @struct Port
+     * @brief A serial port and the batch its samples are collected into.
      */
-    void readSerialData();
+    struct Port
+    {
+        QString name;         ///< The name of the serial port.
+        SerialWorker *worker; ///< Reads and decodes the port on the acquisition thread.
+        SampleBlock batch;    ///< Samples collected by the current drain.
+    };
 
-private:
-    QSerialPort *serial;       ///< The serial port object.
-    QString serialBuffer;      ///< Buffer to store incoming serial data.
+    QThread thread;            ///< The acquisition thread shared by all ports.
+    QVector<Port> ports;       ///< The added ports, in the order they were added.
+    ChannelSchema schema;      ///< The channels carried by each frame.
+    QString filters;           ///< The filter stages applied by every worker; empty for none.
+    Histogram latency;         ///< Read-to-drain latency of every sample in nanoseconds.
+    Histogram queueDepth;      ///< Samples taken from a queue per drain.
+
+    /**
+     * @brief Creates the worker of a new port on the acquisition thread.
+     * @param name The name of the port.
+     * @return The index of the port.
+     */
+    int createPort(const QString &name);
+
+    /**
+     * @brief Sends the current filters and schema to the worker of a port.
+     * @param port The index of the port.
+     */
+    void sendFilters(int port);
 
     /**
-     * @brief Computes the CRC-16-CCITT checksum for the given data.
-     * @param data The data for which the checksum is computed.
-     * @return The computed CRC-16-CCITT checksum.
+     * @brief Drains all frames queued by the worker of a port.
+     * @param port The index of the port.
      */
-    uint16_t crc16_ccitt(const QByteArray &data);
+    void drainQueue(int port);
 };
 
 #endif // SERIALMANAGER_H
@@ -0,0 +1,186 @@
+#ifndef SERIALWORKER_H
+#define SERIALWORKER_H
+
+#include <QObject>
+#include <QSerialPort>
+#include <atomic>
+#include "CaptureFile.h"
+#include "FilterChain.h"
+#include "FrameParser.h"
+#include "FrameTimestamper.h"
+#include "Histogram.h"
+#include "ReplayDevice.h"
+#include "Sample.h"
+#include "SpscQueue.h"
+
+/**
+ * @struct PortStats
+ * @brief Counters describing the traffic on one serial port.
+ */
+struct PortStats
+{
+    quint64 bytesRead;     ///< Bytes read from the port.
+    quint64 frames;        ///< Frames decoded and queued.
+    quint64 crcErrors;     ///< Frames rejected because of a wrong or malformed CRC.
+    quint64 formatErrors;  ///< Frames rejected because of their layout.
+    quint64 overflows;     ///< Runs of bytes dropped because no terminator was found.
+    quint64 droppedFrames; ///< Frames dropped because the queue was full.
+    quint64 lostFrames;    ///< Frames missing from the device's sequence numbers.
+};
+
+/**
+ * @class SerialWorker
+ * @brief The SerialWorker class reads and decodes serial data on an acquisition thread.
+ *
+ * The worker is moved to the acquisition thread by SerialManager, which
+ * may host the workers of several ports. It creates and owns one
+ * QSerialPort on that thread, with its own parser state and statistics,
+ * decodes frames as they arrive, stamps them on the monotonic SampleClock
+ * right after the read (see FrameTimestamper), runs them through the
+ * configured FilterChain and pushes them into a lock-free queue. The
+ * consumer is woken with at most one samplesAvailable() signal per drain,
+ * no matter how many samples were queued in between.
+ *
+ * Instead of a serial port, the worker can read a capture file through a
+ * ReplayDevice; everything after the read is the same. The raw bytes of
+ * every read can also be recorded into a capture file.
+ */
+class SerialWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef SpscQueue<Sample, 8192> SampleQueue; ///< Queue carrying decoded samples to the consumer.
+    static const int MaxReadFrames = 256;        ///< Frames of one read that are stamped together.
+
+    /**
+     * @brief Constructs a SerialWorker object.
+     * @param parent The parent object.
+     */
+    explicit SerialWorker(QObject *parent = nullptr);
+
+    /**
+     * @brief Destructor for SerialWorker.
+     */
+    ~SerialWorker();
+
+    /**
+     * @brief Removes decoded samples from the queue. Must only be called from the consumer thread.
+     * @param samples Receives the removed samples.
+     * @param maxCount The maximum number of samples to remove.
+     * @return The number of samples removed.
+     *
+     * The first call after a samplesAvailable() signal re-arms the signal, so
+     * the consumer should keep calling until it returns 0.
+     */
+    std::size_t takeSamples(Sample *samples, std::size_t maxCount);
+
+    /**
+     * @brief Gets the number of frames dropped because the queue was full.
+     * @return The number of dropped frames.
+     */
+    quint64 droppedFrames() const;
+
+    /**
+     * @brief Gets the traffic counters of the port. May be called from any thread.
+     * @return A snapshot of the counters since the worker was created.
+     */
+    PortStats stats() const;
+
+    /**
+     * @brief Gets the time spent decoding and queueing the frames of each read. May be read from any thread.
+     * @return The histogram of durations in nanoseconds.
+     */
+    const Histogram &parseTime() const;
+
+public slots:
+    /**
+     * @brief Opens the serial port and starts reading.
+     * @param portName The name of the serial port.
+     * @param baudRate The baud rate for the serial communication.
+     */
+    void open(const QString &portName, qint32 baudRate);
+
+    /**
+     * @brief Closes the serial port.
+     */
+    void close();
+
+    /**
+     * @brief Replays a capture file instead of reading a serial port.
+     * @param path The capture file.
+     * @param speed The replay speed: 1 for real time, N for N times faster, 0 for as fast as possible.
+     */
+    void openReplay(const QString &path, double speed);
+
+    /**
+     * @brief Starts recording the bytes read into a capture file.
+     * @param path The capture file; an existing file is replaced.
+     */
+    void startCapture(const QString &path);
+
+    /**
+     * @brief Stops recording.
+     */
+    void stopCapture();
+
+    /**
+     * @brief Replaces the filters applied to every read.
+     * @param description The filter stages, see FilterChain; must have been validated against the schema.
+     * @param schema The channels of the samples.
+     */
+    void setFilters(const QString &description, const ChannelSchema &schema);
+
+signals:
+    /**
+     * @brief Signal emitted when samples were queued after the consumer last drained the queue.
+     */
+    void samplesAvailable();
+
+    /**
+     * @brief Signal emitted when the serial port is opened or closed.
+     * @param isOpen Indicates if the serial port is open (true) or closed (false).
+     */
+    void serialPortOpened(bool isOpen);
+
+private slots:
+    /**
+     * @brief Slot to read data from the serial port.
+     */
+    void readSerialData();
+
+private:
+    /**
+     * @brief Closes the current byte source without emitting any signal.
+     */
+    void closeDevice();
+
+    /**
+     * @brief Stamps and filters the frames collected from a read and pushes them into the queue.
+     * @param readTime The time the read returned.
+     * @return True if at least one frame was queued.
+     */
+    bool queueFrames(qint64 readTime);
+
+    QSerialPort *serial;                 ///< The serial port object, created on the worker thread.
+    ReplayDevice *replay;                ///< Plays capture files back, created on the worker thread.
+    QIODevice *device;                   ///< The open byte source, serial or replay; nullptr if closed.
+    CaptureWriter capture;               ///< Records the bytes read while open.
+    FrameParser parser;                  ///< Incremental parser holding incoming serial data.
+    FrameTimestamper timestamper;        ///< Spreads the frames of a read over their sampling times.
+    FilterChain filters;                 ///< Filters the stamped frames before they are queued.
+    Sample readFrames[MaxReadFrames];    ///< Frames of the current read waiting to be stamped.
+    int readFrameCount;                  ///< Number of entries in readFrames.
+    SampleQueue queue;                   ///< Decoded samples waiting for the consumer.
+    std::atomic<bool> notifyPending;     ///< True while a samplesAvailable() signal is outstanding.
+    std::atomic<quint64> received;       ///< Number of bytes read from the port.
+    std::atomic<quint64> frames;         ///< Number of frames decoded and queued.
+    std::atomic<quint64> crcErrors;      ///< Number of frames with a wrong or malformed CRC.
+    std::atomic<quint64> formatErrors;   ///< Number of frames with an invalid layout.
+    std::atomic<quint64> overflows;      ///< Number of dropped runs without a terminator.
+    std::atomic<quint64> dropped;        ///< Number of frames dropped because the queue was full.
+    std::atomic<quint64> lost;           ///< Number of frames missing from the sequence numbers.
+    Histogram parseDurations;            ///< Time from the end of a read until its frames are queued.
+};
+
+#endif // SERIALWORKER_H
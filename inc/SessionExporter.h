@@ -0,0 +1,60 @@
+#ifndef SESSIONEXPORTER_H
+#define SESSIONEXPORTER_H
+
+#include <QString>
+#include "SessionFile.h"
+
+/**
+ * @class SessionExporter
+ * @brief The SessionExporter class converts recorded sessions into formats for analysis tools.
+ *
+ * Two formats are written. CSV has one row per sample with the timestamp,
+ * the device (when the session has more than one) and every channel. The
+ * columnar export is a directory with one raw little-endian file per
+ * column, which NumPy, MATLAB or pandas load with a single call, and a
+ * columns.json manifest naming the files, types and units. Both are
+ * streamed from the mapped session one chunk at a time through a large
+ * output buffer, so memory use does not depend on the session length and
+ * the disk sees only large sequential writes. Rows appear in the order of
+ * the chunks in the session, which is time order for each device.
+ */
+class SessionExporter
+{
+public:
+    static const int BufferSize = 4 * 1024 * 1024; ///< Bytes collected per write.
+    static const int MaxNumberLength = 32;         ///< Longest number written by formatDouble().
+
+    /**
+     * @brief Exports a session as CSV.
+     * @param session The open session.
+     * @param path The CSV file; an existing file is replaced.
+     * @return True if the whole session was written.
+     */
+    static bool exportCsv(const SessionFile &session, const QString &path);
+
+    /**
+     * @brief Exports a session as one binary file per column.
+     * @param session The open session.
+     * @param directory The directory to write into; created if needed.
+     * @return True if the whole session was written.
+     */
+    static bool exportColumns(const SessionFile &session, const QString &directory);
+
+    /**
+     * @brief Exports a session in the format matching the path.
+     * @param session The open session.
+     * @param path A ".csv" file for CSV, otherwise a directory for the columnar export.
+     * @return True if the whole session was written.
+     */
+    static bool exportSession(const SessionFile &session, const QString &path);
+
+    /**
+     * @brief Writes the shortest text that reads back as the same double.
+     * @param out Receives the text; must hold MaxNumberLength bytes.
+     * @param value The value; NaN is written as an empty field.
+     * @return One past the last byte written.
+     */
+    static char *formatDouble(char *out, double value);
+};
+
+#endif // SESSIONEXPORTER_H
@@ -0,0 +1,157 @@
+#ifndef SESSIONFILE_H
+#define SESSIONFILE_H
+
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "ChannelSchema.h"
+#include "SampleBlock.h"
+
+/**
+ * @struct SessionChunk
+ * @brief Index entry of one chunk of a session file.
+ */
+struct SessionChunk
+{
+    qint64 offset; ///< Position of the chunk header in the file.
+    qint32 source; ///< The index of the device the samples come from.
+    qint32 count;  ///< The number of samples.
+    qint64 first;  ///< The timestamp of the first sample in nanoseconds since the epoch.
+    qint64 last;   ///< The timestamp of the last sample in nanoseconds since the epoch.
+};
+
+/**
+ * @class SessionFile
+ * @brief The SessionFile class reads a recorded session in place through a memory mapping.
+ *
+ * A session file starts with the 8-byte Magic, the lengths of the schema
+ * text and of the source names (32-bit integers) and the texts themselves,
+ * padded to a multiple of 8 bytes. Chunks follow, each holding the samples
+ * of one device: the source index and sample count (32-bit integers), the
+ * timestamp column (64-bit nanoseconds since the epoch) and one column of
+ * doubles per channel. Closing the recording appends an index with one
+ * SessionChunk per chunk and a trailer holding the index position, the chunk
+ * count and IndexMagic. All numbers are little-endian and every column is
+ * 8-byte aligned, so the columns are used straight from the mapping without
+ * parsing or copying. A file whose recording was interrupted has no index;
+ * its chunks are then found by walking them from the header, and a truncated
+ * last chunk is ignored.
+ */
+class SessionFile
+{
+public:
+    static const char Magic[8];               ///< The first bytes of every session file.
+    static const char IndexMagic[8];          ///< The last bytes of a session file with an index.
+    static const int ChunkHeaderLength = 8;   ///< Bytes before the timestamp column of each chunk.
+    static const int IndexEntryLength = 32;   ///< Bytes per chunk in the index.
+    static const int TrailerLength = 24;      ///< Bytes after the index.
+
+    /**
+     * @brief Constructs a closed SessionFile.
+     */
+    SessionFile();
+
+    /**
+     * @brief Opens and maps a session file.
+     * @param path The file.
+     * @return True if the file could be mapped and starts with Magic.
+     */
+    bool open(const QString &path);
+
+    /**
+     * @brief Unmaps and closes the file.
+     */
+    void close();
+
+    /**
+     * @brief Checks if a file is open.
+     * @return True if a session is mapped.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Checks if the session was closed properly.
+     * @return True if the chunks were read from the index, false if they were recovered by walking the file.
+     */
+    bool isIndexed() const;
+
+    /**
+     * @brief Gets the channels of the recorded samples.
+     * @return The channel schema.
+     */
+    const ChannelSchema &schema() const;
+
+    /**
+     * @brief Gets the names of the recorded devices.
+     * @return One name per source index.
+     */
+    const QStringList &sourceNames() const;
+
+    /**
+     * @brief Gets the number of chunks.
+     * @return The number of chunks.
+     */
+    int chunkCount() const;
+
+    /**
+     * @brief Gets the index entry of a chunk.
+     * @param chunk The position of the chunk, 0 being the oldest.
+     * @return The index entry.
+     */
+    const SessionChunk &chunk(int chunk) const;
+
+    /**
+     * @brief Gets the timestamp column of a chunk.
+     * @param chunk The position of the chunk.
+     * @return chunk(chunk).count timestamps in nanoseconds since the epoch, in the mapping.
+     */
+    const qint64 *timestamps(int chunk) const;
+
+    /**
+     * @brief Gets the column of a channel in a chunk.
+     * @param chunk The position of the chunk.
+     * @param channel The position of the channel.
+     * @return chunk(chunk).count values, in the mapping.
+     */
+    const double *values(int chunk, int channel) const;
+
+    /**
+     * @brief Copies the samples of a chunk into a block.
+     * @param chunk The position of the chunk.
+     * @param block Receives the samples; previous contents are discarded.
+     */
+    void read(int chunk, SampleBlock &block) const;
+
+    /**
+     * @brief Gets the size of a chunk.
+     * @param count The number of samples.
+     * @param channelCount The number of channels.
+     * @return The number of bytes including the chunk header.
+     */
+    static qint64 chunkLength(int count, int channelCount);
+
+private:
+    QFile file;                   ///< The session file.
+    const uchar *data;            ///< The mapping of the whole file, or nullptr.
+    qint64 size;                  ///< The size of the mapping in bytes.
+    ChannelSchema sessionSchema;  ///< The channels of the recorded samples.
+    QStringList sources;          ///< The names of the recorded devices.
+    QVector<SessionChunk> chunks; ///< The chunks, oldest first.
+    bool indexed;                 ///< True if the chunks were read from the index.
+
+    /**
+     * @brief Reads the chunk list from the index at the end of the file.
+     * @param dataStart The position of the first chunk.
+     * @return True if a valid index was found.
+     */
+    bool readIndex(qint64 dataStart);
+
+    /**
+     * @brief Builds the chunk list by walking the chunks from the header.
+     * @param dataStart The position of the first chunk.
+     */
+    void scanChunks(qint64 dataStart);
+};
+
+#endif // SESSIONFILE_H
@@ -0,0 +1,92 @@
+#ifndef SESSIONRECORDER_H
+#define SESSIONRECORDER_H
+
+#include <QObject>
+#include <QStringList>
+#include <QThread>
+#include <QVector>
+#include <atomic>
+#include "ChannelSchema.h"
+#include "SampleBlock.h"
+
+class SessionWriter;
+
+/**
+ * @class SessionRecorder
+ * @brief The SessionRecorder class records all received samples into a session file.
+ *
+ * Samples are collected per device into chunks of ChunkSamples samples.
+ * A full chunk is handed to a writer on a background thread, which lays it
+ * out as columns and appends it to the file with a single write, so the
+ * GUI thread never waits for the disk. The file is append-only; stopping
+ * the recording writes the remaining samples and the chunk index, after
+ * which SessionFile opens the session in place. See SessionFile for the
+ * layout.
+ */
+class SessionRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int ChunkSamples = 8192; ///< Samples per device collected before a chunk is written.
+
+    /**
+     * @brief Constructs a SessionRecorder object and starts its writer thread.
+     * @param parent The parent object.
+     */
+    explicit SessionRecorder(QObject *parent = nullptr);
+
+    /**
+     * @brief Stops recording and the writer thread.
+     */
+    ~SessionRecorder();
+
+    /**
+     * @brief Creates a session file and starts recording into it.
+     * @param path The file; an existing file is replaced.
+     * @param schema The channels of the samples.
+     * @param sourceNames The names of the devices, in source index order.
+     * @return True if the file could be created.
+     */
+    bool start(const QString &path, const ChannelSchema &schema, const QStringList &sourceNames);
+
+    /**
+     * @brief Records a batch of samples.
+     * @param samples The timestamped samples, oldest first, with one column per schema channel.
+     * @param source The index of the device the samples come from.
+     */
+    void record(const SampleBlock &samples, int source);
+
+    /**
+     * @brief Writes the remaining samples and the index and closes the file.
+     */
+    void stop();
+
+    /**
+     * @brief Checks if a recording is running.
+     * @return True between start() and stop().
+     */
+    bool isRecording() const;
+
+    /**
+     * @brief Gets the number of bytes written to the current file so far.
+     * @return The number of bytes.
+     */
+    quint64 bytesWritten() const;
+
+private:
+    QThread thread;               ///< The writer thread.
+    SessionWriter *writer;        ///< Writes the file on the writer thread.
+    QVector<SampleBlock> pending; ///< The chunk being collected for each device.
+    int channelCount;             ///< The number of channels of the schema.
+    bool recording;               ///< True between start() and stop().
+    std::atomic<quint64> written; ///< Bytes written by the writer thread.
+
+    /**
+     * @brief Hands the collected samples of a device to the writer thread.
+     * @param source The index of the device.
+     */
+    void submit(int source);
+};
+
+#endif // SESSIONRECORDER_H
@@ -0,0 +1,324 @@
+#ifndef SIGNALFILTER_H
+#define SIGNALFILTER_H
+
+#include <QVector>
+#include "ChannelSchema.h"
+#include "Sample.h"
+
+/**
+ * @class SignalFilter
+ * @brief The SignalFilter class is the base of the filters applied to samples on the acquisition thread.
+ *
+ * A filter is configured once and then processes the samples of every read
+ * in place, oldest first. All state lives in fixed-size members, so
+ * processing never allocates. The per-sample work runs over the channels
+ * in a flat loop over arrays indexed by channel, which the compiler can
+ * vectorise; channels that are not selected are computed along and then
+ * left unchanged. Samples with fewer channels than the filter was
+ * configured for are passed through. Filters are primed with the first
+ * sample after a reset, so a constant input comes out unchanged from the
+ * start instead of rising from zero.
+ */
+class SignalFilter
+{
+public:
+    /**
+     * @brief Constructs a filter.
+     * @param channelCount The number of channels of the samples; at most ChannelSchema::MaxChannels.
+     * @param channels The channels to filter, one bit per channel position.
+     */
+    SignalFilter(int channelCount, quint32 channels);
+
+    /**
+     * @brief Destructor for SignalFilter.
+     */
+    virtual ~SignalFilter();
+
+    /**
+     * @brief Forgets all past samples; the next sample primes the filter again.
+     */
+    virtual void reset() = 0;
+
+    /**
+     * @brief Filters samples in place.
+     * @param samples The samples, oldest first.
+     * @param count The number of samples.
+     */
+    virtual void process(Sample *samples, int count) = 0;
+
+protected:
+    int channelCount;                          ///< The number of channels processed per sample.
+    bool selected[ChannelSchema::MaxChannels]; ///< True for every channel whose filtered value is kept.
+};
+
+/**
+ * @class MovingAverageFilter
+ * @brief Replaces every value by the mean of the last values of its channel.
+ *
+ * The sum is updated incrementally and recomputed once per pass through
+ * the history, so rounding errors cannot build up.
+ */
+class MovingAverageFilter : public SignalFilter
+{
+public:
+    static const int MaxLength = 64; ///< Longest window in samples.
+
+    /**
+     * @brief Constructs a moving average.
+     * @param channelCount The number of channels of the samples.
+     * @param channels The channels to filter, one bit per channel position.
+     * @param length The number of samples averaged, between 1 and MaxLength.
+     */
+    MovingAverageFilter(int channelCount, quint32 channels, int length);
+
+    /**
+     * @brief Forgets all past samples; the next sample primes the filter again.
+     */
+    void reset() override;
+
+    /**
+     * @brief Filters samples in place.
+     * @param samples The samples, oldest first.
+     * @param count The number of samples.
+     */
+    void process(Sample *samples, int count) override;
+
+private:
+    int length;                                            ///< The number of samples averaged.
+    int position;                                          ///< The history row the next sample goes into.
+    bool primed;                                           ///< True once the history holds real samples.
+    double sum[ChannelSchema::MaxChannels];                ///< The sum of the history per channel.
+    double history[MaxLength][ChannelSchema::MaxChannels]; ///< The last length samples, one row per sample.
+};
+
+/**
+ * @class MedianFilter
+ * @brief Replaces every value by the median of the last values of its channel.
+ *
+ * Removes single outliers such as a corrupted reading without smearing
+ * steps, at the cost of a partial sort per value, which does not vectorise.
+ */
+class MedianFilter : public SignalFilter
+{
+public:
+    static const int MaxLength = 31; ///< Longest window in samples.
+
+    /**
+     * @brief Constructs a median filter.
+     * @param channelCount The number of channels of the samples.
+     * @param channels The channels to filter, one bit per channel position.
+     * @param length The number of samples the median is taken over, odd and at most MaxLength.
+     */
+    MedianFilter(int channelCount, quint32 channels, int length);
+
+    /**
+     * @brief Forgets all past samples; the next sample primes the filter again.
+     */
+    void reset() override;
+
+    /**
+     * @brief Filters samples in place.
+     * @param samples The samples, oldest first.
+     * @param count The number of samples.
+     */
+    void process(Sample *samples, int count) override;
+
+private:
+    int length;                                            ///< The number of samples the median is taken over.
+    int position;                                          ///< The history row the next sample goes into.
+    bool primed;                                           ///< True once the history holds real samples.
+    double history[ChannelSchema::MaxChannels][MaxLength]; ///< The last length values, one row per channel.
+};
+
+/**
+ * @class FirFilter
+ * @brief Convolves every channel with a set of coefficients.
+ *
+ * The history is stored twice in a row, so the last samples are always
+ * contiguous and the convolution is a plain multiply-add over taps and
+ * channels without wrap-around.
+ */
+class FirFilter : public SignalFilter
+{
+public:
+    static const int MaxTaps = 64; ///< Most coefficients.
+
+    /**
+     * @brief Constructs an FIR filter.
+     * @param channelCount The number of channels of the samples.
+     * @param channels The channels to filter, one bit per channel position.
+     * @param coefficients The coefficients, newest sample first; at most MaxTaps are used.
+     */
+    FirFilter(int channelCount, quint32 channels, const QVector<double> &coefficients);
+
+    /**
+     * @brief Designs a low-pass filter with a Hamming-windowed sinc.
+     * @param cutoff The cut-off frequency in Hz, above 0 and below half the sample rate.
+     * @param sampleRate The sample rate in Hz.
+     * @param taps The number of coefficients, at most MaxTaps.
+     * @return The coefficients, scaled to a gain of 1 for constant input.
+     */
+    static QVector<double> lowPass(double cutoff, double sampleRate, int taps);
+
+    /**
+     * @brief Forgets all past samples; the next sample primes the filter again.
+     */
+    void reset() override;
+
+    /**
+     * @brief Filters samples in place.
+     * @param samples The samples, oldest first.
+     * @param count The number of samples.
+     */
+    void process(Sample *samples, int count) override;
+
+private:
+    int taps;                                                ///< The number of coefficients.
+    int position;                                            ///< The history row the next sample goes into.
+    bool primed;                                             ///< True once the history holds real samples.
+    double coefficients[MaxTaps];                            ///< The coefficients, newest sample first.
+    double history[2 * MaxTaps][ChannelSchema::MaxChannels]; ///< The last taps samples, stored twice.
+};
+
+/**
+ * @class BiquadFilter
+ * @brief Runs every channel through a second-order IIR section.
+ *
+ * The section is computed in transposed direct form II, which needs two
+ * state values per channel and behaves well numerically.
+ */
+class BiquadFilter : public SignalFilter
+{
+public:
+    /**
+     * @brief Constructs a biquad from normalised coefficients (a0 = 1).
+     * @param channelCount The number of channels of the samples.
+     * @param channels The channels to filter, one bit per channel position.
+     * @param b0 Feed-forward coefficient of the current input.
+     * @param b1 Feed-forward coefficient of the previous input.
+     * @param b2 Feed-forward coefficient of the input before.
+     * @param a1 Feedback coefficient of the previous output.
+     * @param a2 Feedback coefficient of the output before.
+     */
+    BiquadFilter(int channelCount, quint32 channels, double b0, double b1, double b2, double a1, double a2);
+
+    /**
+     * @brief Creates a second-order low-pass filter.
+     * @param channelCount The number of channels of the samples.
+     * @param channels The channels to filter, one bit per channel position.
+     * @param cutoff The cut-off frequency in Hz.
+     * @param sampleRate The sample rate in Hz.
+     * @param q The quality factor; 0.7071 gives a Butterworth response.
+     * @return The filter.
+     */
+    static BiquadFilter *lowPass(int channelCount, quint32 channels, double cutoff, double sampleRate, double q);
+
+    /**
+     * @brief Forgets all past samples; the next sample primes the filter again.
+     */
+    void reset() override;
+
+    /**
+     * @brief Filters samples in place.
+     * @param samples The samples, oldest first.
+     * @param count The number of samples.
+     */
+    void process(Sample *samples, int count) override;
+
+private:
+    double b0;                             ///< Feed-forward coefficient of the current input.
+    double b1;                             ///< Feed-forward coefficient of the previous input.
+    double b2;                             ///< Feed-forward coefficient of the input before.
+    double a1;                             ///< Feedback coefficient of the previous output.
+    double a2;                             ///< Feedback coefficient of the output before.
+    bool primed;                           ///< True once the state has been set from a sample.
+    double z1[ChannelSchema::MaxChannels]; ///< First state value per channel.
+    double z2[ChannelSchema::MaxChannels]; ///< Second state value per channel.
+};
+
+/**
+ * @class KalmanFilter
+ * @brief Estimates every channel as an angle that changes at a slowly varying rate.
+ *
+ * Each channel has its own two-state Kalman filter (angle and rate) whose
+ * time step is taken from the sample timestamps, so irregular sampling is
+ * handled correctly. The rate is modelled as a random walk: the larger the
+ * process noise compared with the measurement noise, the faster and the
+ * noisier the estimate.
+ */
+class KalmanFilter : public SignalFilter
+{
+public:
+    /**
+     * @brief Constructs a Kalman filter.
+     * @param channelCount The number of channels of the samples.
+     * @param channels The channels to filter, one bit per channel position.
+     * @param processNoise The spectral density of the rate's random walk, in unit^2/s^3.
+     * @param measurementNoise The variance of a measured value, in unit^2.
+     */
+    KalmanFilter(int channelCount, quint32 channels, double processNoise, double measurementNoise);
+
+    /**
+     * @brief Forgets all past samples; the next sample primes the filter again.
+     */
+    void reset() override;
+
+    /**
+     * @brief Filters samples in place.
+     * @param samples The samples, oldest first.
+     * @param count The number of samples.
+     */
+    void process(Sample *samples, int count) override;
+
+private:
+    double processNoise;                      ///< Spectral density of the rate's random walk.
+    double measurementNoise;                  ///< Variance of a measured value.
+    qint64 lastTime;                          ///< Timestamp of the previous sample, 0 before the first.
+    double angle[ChannelSchema::MaxChannels]; ///< Estimated value per channel.
+    double rate[ChannelSchema::MaxChannels];  ///< Estimated rate of change per channel, per second.
+    double p00[ChannelSchema::MaxChannels];   ///< Variance of the value estimate.
+    double p01[ChannelSchema::MaxChannels];   ///< Covariance of value and rate.
+    double p11[ChannelSchema::MaxChannels];   ///< Variance of the rate estimate.
+};
+
+/**
+ * @class ComplementaryFilter
+ * @brief Fuses an absolute but noisy angle with a smooth but drifting rate.
+ *
+ * The integrated rate, e.g. from a gyroscope, is trusted over short times
+ * and the angle, e.g. from an accelerometer, over long ones; the time
+ * constant sets the crossover. The result replaces the angle channel.
+ */
+class ComplementaryFilter : public SignalFilter
+{
+public:
+    /**
+     * @brief Constructs a complementary filter.
+     * @param channelCount The number of channels of the samples.
+     * @param angleChannel The channel with the angle, which receives the result.
+     * @param rateChannel The channel with the rate of the angle, in angle units per second.
+     * @param timeConstant The crossover time constant in seconds.
+     */
+    ComplementaryFilter(int channelCount, int angleChannel, int rateChannel, double timeConstant);
+
+    /**
+     * @brief Forgets all past samples; the next sample primes the filter again.
+     */
+    void reset() override;
+
+    /**
+     * @brief Filters samples in place.
+     * @param samples The samples, oldest first.
+     * @param count The number of samples.
+     */
+    void process(Sample *samples, int count) override;
+
+private:
+    int angleChannel;    ///< The channel with the angle.
+    int rateChannel;     ///< The channel with the rate.
+    double timeConstant; ///< The crossover time constant in seconds.
+    qint64 lastTime;     ///< Timestamp of the previous sample, 0 before the first.
+    double angle;        ///< The fused angle.
+};
+
+#endif // SIGNALFILTER_H
@@ -0,0 +1,98 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @class SpscQueue
+ * @brief The SpscQueue class is a bounded lock-free single-producer/single-consumer queue.
+ *
+ * One thread may call push() and one other thread may call pop() concurrently
+ * without any locking. The head and tail counters live on separate cache lines
+ * and each side keeps a cached copy of the other side's counter, so the shared
+ * counters are only read when the cached value says the queue looks full or
+ * empty.
+ *
+ * @tparam T The element type; it must be cheap to copy.
+ * @tparam Capacity The maximum number of queued elements; must be a power of two.
+ */
+template <typename T, std::size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    /**
+     * @brief Constructs an empty queue.
+     */
+    SpscQueue() : head(0), cachedTail(0), tail(0), cachedHead(0) {}
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    /**
+     * @brief Appends an element. Must only be called from the producer thread.
+     * @param value The element to append.
+     * @return True if the element was queued, false if the queue is full.
+     */
+    bool push(const T &value)
+    {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cachedHead == Capacity) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t - cachedHead == Capacity) {
+                return false;
+            }
+        }
+        items[t & (Capacity - 1)] = value;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Removes up to maxCount elements. Must only be called from the consumer thread.
+     * @param values Receives the removed elements.
+     * @param maxCount The maximum number of elements to remove.
+     * @return The number of elements removed.
+     */
+    std::size_t pop(T *values, std::size_t maxCount)
+    {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        std::size_t available = cachedTail - h;
+        if (available < maxCount) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            available = cachedTail - h;
+        }
+        std::size_t count = available < maxCount ? available : maxCount;
+        for (std::size_t i = 0; i < count; ++i) {
+            values[i] = items[(h + i) & (Capacity - 1)];
+        }
+        head.store(h + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief Gets the number of queued elements.
+     * @return A snapshot of the queue depth; exact only when both sides are idle.
+     */
+    std::size_t size() const
+    {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Gets the maximum number of queued elements.
+     * @return The queue capacity.
+     */
+    static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+    alignas(64) std::atomic<std::size_t> head; ///< Index of the next element to pop, written by the consumer.
+    std::size_t cachedTail;                    ///< Consumer's last observed value of tail.
+    alignas(64) std::atomic<std::size_t> tail; ///< Index of the next free slot, written by the producer.
+    std::size_t cachedHead;                    ///< Producer's last observed value of head.
+    alignas(64) T items[Capacity];             ///< Element storage.
+};
+
+#endif // SPSCQUEUE_H
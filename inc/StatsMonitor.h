@@ -0,0 +1,151 @@
+#ifndef STATSMONITOR_H
+#define STATSMONITOR_H
+
+#include <QAbstractTableModel>
+#include <QFile>
+#include <QTimer>
+#include <QVector>
+#include <functional>
+#include "Histogram.h"
+
+/**
+ * @class StatsMonitor
+ * @brief The StatsMonitor class shows pipeline counters and timings in a table.
+ *
+ * Metrics are registered as functions that read a counter or take a
+ * histogram snapshot, so the measured code only increments atomics and
+ * knows nothing about the monitor. On every update, which happens
+ * periodically once start() has been called, each metric is read and the
+ * values since the previous update are shown: counters as totals or rates,
+ * histograms as rate, mean, median, 99th percentile and maximum. Every
+ * update can also be appended to a CSV or JSON Lines file.
+ */
+class StatsMonitor : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    typedef std::function<quint64()> CounterSource;             ///< Reads a monotonically increasing counter.
+    typedef std::function<HistogramSnapshot()> HistogramSource; ///< Takes a snapshot of a histogram.
+
+    /**
+     * @brief Columns of the table.
+     */
+    enum Column
+    {
+        NameColumn,       ///< The name of the metric.
+        ValueColumn,      ///< The total or rate of a counter, the recordings per second of a histogram.
+        MeanColumn,       ///< The average of a histogram.
+        MedianColumn,     ///< The median of a histogram.
+        PercentileColumn, ///< The 99th percentile of a histogram.
+        MaximumColumn,    ///< The maximum of a histogram.
+        ColumnCount       ///< Number of columns.
+    };
+
+    /**
+     * @brief Constructs a StatsMonitor without metrics.
+     * @param parent The parent object.
+     */
+    explicit StatsMonitor(QObject *parent = nullptr);
+
+    /**
+     * @brief Adds a counter.
+     * @param name The name shown in the table, marked with QT_TRANSLATE_NOOP("StatsMonitor", ...); exported untranslated.
+     * @param source Reads the counter.
+     * @param perSecond True to show the rate of increase, false to show the total.
+     */
+    void addCounter(const QString &name, CounterSource source, bool perSecond);
+
+    /**
+     * @brief Adds a histogram.
+     * @param name The name shown in the table, including the unit, marked with QT_TRANSLATE_NOOP("StatsMonitor", ...); exported untranslated.
+     * @param source Takes a snapshot of the histogram.
+     * @param scale The recorded values are divided by this for display, e.g. 1000 to show nanoseconds as microseconds.
+     */
+    void addHistogram(const QString &name, HistogramSource source, double scale = 1.0);
+
+    /**
+     * @brief Sets the file every update is appended to.
+     * @param path The file; CSV if it ends in ".csv", JSON Lines otherwise. An empty path stops exporting.
+     * @return True if the file could be opened.
+     */
+    bool setExportFile(const QString &path);
+
+    /**
+     * @brief Shows the column titles and metric names in the current language.
+     */
+    void retranslate();
+
+    /**
+     * @brief Starts updating periodically.
+     * @param interval The time between updates in milliseconds.
+     */
+    void start(int interval = 1000);
+
+    /**
+     * @brief Gets the number of rows.
+     * @param parent The parent index; only the invalid root index has rows.
+     * @return The number of metrics.
+     */
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    /**
+     * @brief Gets the number of columns.
+     * @param parent The parent index; only the invalid root index has columns.
+     * @return ColumnCount.
+     */
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    /**
+     * @brief Gets the text of a cell.
+     * @param index The cell.
+     * @param role The requested role; Qt::DisplayRole and Qt::TextAlignmentRole are provided.
+     * @return The cell contents, or an invalid QVariant.
+     */
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief Gets the title of a column.
+     * @param section The column.
+     * @param orientation Only horizontal headers have titles.
+     * @param role The requested role; only Qt::DisplayRole is provided.
+     * @return The title, or an invalid QVariant.
+     */
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+public slots:
+    /**
+     * @brief Reads all metrics, refreshes the table and exports the values.
+     */
+    void update();
+
+private:
+    /**
+     * @struct Metric
+     * @brief A registered metric and the values shown for it.
+     */
+    struct Metric
+    {
+        QString name;               ///< The name shown in the table.
+        CounterSource counter;      ///< Reads the counter, empty for histograms.
+        HistogramSource histogram;  ///< Takes a snapshot, empty for counters.
+        bool perSecond;             ///< Show the rate of a counter rather than its total.
+        double scale;               ///< Divisor applied to histogram values.
+        quint64 lastCount;          ///< The counter at the previous update.
+        HistogramSnapshot last;     ///< The histogram at the previous update.
+        double values[ColumnCount]; ///< The numbers shown, indexed by column; NameColumn is unused.
+    };
+
+    QVector<Metric> metrics; ///< The registered metrics, in table order.
+    QTimer timer;            ///< Triggers the periodic updates.
+    qint64 lastUpdate;       ///< SampleClock time of the previous update, 0 if none.
+    QFile exportFile;        ///< The file updates are appended to, if open.
+    bool exportCsv;          ///< True for CSV, false for JSON Lines.
+
+    /**
+     * @brief Appends the current values to the export file.
+     */
+    void exportValues();
+};
+
+#endif // STATSMONITOR_H
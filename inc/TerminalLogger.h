@@ -1,45 +1,90 @@
 #ifndef TERMINALLOGGER_H
 #define TERMINALLOGGER_H
 
+#include <QByteArray>
+#include <QListView>
 #include <QObject>
-#include <QPlainTextEdit>
+#include <QStringList>
+#include <QVector>
+#include "ChannelSchema.h"
+#include "LogModel.h"
+#include "SampleBlock.h"
 
 /**
  * @class TerminalLogger
- * @brief The TerminalLogger class logs pitch and roll measurements to a QPlainTextEdit widget.
+ * @brief The TerminalLogger class logs measurements to a list view.
  *
- * This class is responsible for displaying pitch and roll measurements in a
- * QPlainTextEdit widget. It provides a method to log measurements and ensures
- * that the widget is properly initialized.
+ * Measurements are formatted straight into a preallocated staging buffer
+ * and handed to a LogModel once per UI frame by flush(). The model keeps
+ * only the most recent lines in a fixed ring, and the list view only builds
+ * text for the rows it shows, so neither memory use nor the cost of an
+ * update grows during a long session.
  */
 class TerminalLogger : public QObject
 {
     Q_OBJECT
 
 public:
+    static const int MaxLines = 10000;  ///< Number of lines retained in the view.
+    static const int MaxPending = 4096; ///< Number of lines staged between two flushes.
+
     /**
      * @brief Constructs a TerminalLogger object.
-     * @param plainTextEdit The QPlainTextEdit widget where logs will be displayed.
+     * @param listView The list view where logs will be displayed.
      * @param parent The parent object.
      *
-     * This constructor initializes the TerminalLogger with the given QPlainTextEdit
-     * widget. The widget must be valid and not null.
+     * This constructor attaches a LogModel to the given list view. The view
+     * must be valid and not null.
+     */
+    TerminalLogger(QListView *listView, QObject *parent = nullptr);
+
+    /**
+     * @brief Sets the channels carried by the samples.
+     * @param schema The channel schema; ChannelSchema::attitude() by default.
+     */
+    void setSchema(const ChannelSchema &schema);
+
+    /**
+     * @brief Sets the names of the devices the measurements come from.
+     * @param names The device names; with more than one, every line is tagged with its device.
      */
-    TerminalLogger(QPlainTextEdit *plainTextEdit, QObject *parent = nullptr);
+    void setSources(const QStringList &names);
 
     /**
-     * @brief Logs a measurement to the QPlainTextEdit widget.
-     * @param pitch The pitch value to log.
-     * @param roll The roll value to log.
+     * @brief Logs a batch of measurements.
+     * @param samples The timestamped samples, oldest first.
+     * @param source The index of the device the samples come from.
      *
-     * This method logs the given pitch and roll values along with a timestamp
-     * to the QPlainTextEdit widget. Each log entry includes the current time
-     * in the format "hh:mm:ss" followed by the pitch and roll values.
+     * Each log entry includes the acquisition time in the format "hh:mm:ss"
+     * followed by the name and value of every channel. The entries are
+     * shown on the next flush().
      */
-    void logMeasurement(double pitch, double roll);
+    void logMeasurements(const SampleBlock &samples, int source = 0);
+
+public slots:
+    /**
+     * @brief Moves the staged lines into the view. Meant to be called once per UI frame.
+     */
+    void flush();
 
 private:
-    QPlainTextEdit *plainTextEdit; ///< The QPlainTextEdit widget where logs are displayed.
+    QListView *listView;          ///< The list view where logs are displayed.
+    LogModel *model;              ///< The retained lines.
+    QVector<char> pending;        ///< Staged lines, LogModel::LineLength bytes each.
+    QVector<int> pendingLengths;  ///< Length of each staged line.
+    int pendingCount;             ///< Number of staged lines.
+    qint64 clockSecond;           ///< The second that clockText was formatted for.
+    char clockText[8];            ///< The "hh:mm:ss" text of clockSecond.
+    QVector<QByteArray> labels;   ///< The " <name>: " prefix of every channel.
+    QVector<QByteArray> tags;     ///< The " [<device>]" tag of every source, empty with a single source.
+
+    /**
+     * @brief Formats one sample of a block into the next staging slot.
+     * @param samples The block.
+     * @param index The position of the sample in the block.
+     * @param tag The device tag written after the time.
+     */
+    void stage(const SampleBlock &samples, int index, const QByteArray &tag);
 };
 
 #endif // TERMINALLOGGER_H
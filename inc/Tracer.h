@@ -0,0 +1,187 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QString>
+#include <atomic>
+#include <type_traits>
+
+/**
+ * @brief Lowest level compiled into the program.
+ *
+ * Trace calls below it are removed by the compiler, arguments included.
+ * Release builds keep Info and above unless the build overrides it, e.g.
+ * with DEFINES += WDS_TRACE_LEVEL=3 to remove all tracing.
+ */
+#ifndef WDS_TRACE_LEVEL
+#ifdef QT_NO_DEBUG
+#define WDS_TRACE_LEVEL 1
+#else
+#define WDS_TRACE_LEVEL 0
+#endif
+#endif
+
+/**
+ * @class Tracer
+ * @brief The Tracer class records diagnostic messages from any thread without slowing it down.
+ *
+ * A message is a format string literal with %1, %2, ... placeholders and up
+ * to MaxArguments numbers. The calling thread only copies the pointer, the
+ * numbers and a timestamp into a lock-free queue; a background thread
+ * started by start() formats the records and writes them out. Messages are
+ * filtered twice: levels below WDS_TRACE_LEVEL are compiled out, and the
+ * rest are only recorded for the categories and level enabled at run time,
+ * which costs two relaxed atomic loads when disabled. When the queue is
+ * full, records are dropped and counted rather than blocking the caller.
+ */
+class Tracer
+{
+public:
+    /**
+     * @brief Severity of a message.
+     */
+    enum Level
+    {
+        Debug,   ///< Per-update details, e.g. every position of the ball.
+        Info,    ///< Occasional events such as a port being opened.
+        Warning, ///< Something went wrong.
+        Off      ///< Above all messages; disables tracing.
+    };
+
+    /**
+     * @brief Part of the program a message comes from; categories are bit flags.
+     */
+    enum Category : quint32
+    {
+        Serial = 0x01,   ///< Serial ports and frame decoding.
+        Graphics = 0x02, ///< The platform and ball scene.
+        Physics = 0x04,  ///< The ball simulation.
+        Charts = 0x08,   ///< Chart rendering.
+        Storage = 0x10,  ///< Recording, replay and export.
+        AllCategories = 0x1f
+    };
+
+    static const Level CompiledLevel = static_cast<Level>(WDS_TRACE_LEVEL); ///< Lowest level compiled in.
+    static const int MaxArguments = 4; ///< Most numbers a message can carry.
+
+    /**
+     * @brief Records a message at Debug level.
+     * @param category The category of the message.
+     * @param format The message with %1, %2, ... placeholders; must be a string literal.
+     * @param args The numbers for the placeholders.
+     */
+    template <typename... Args>
+    static void debug(Category category, const char *format, Args... args)
+    {
+        trace<Debug>(category, format, args...);
+    }
+
+    /**
+     * @brief Records a message at Info level.
+     * @param category The category of the message.
+     * @param format The message with %1, %2, ... placeholders; must be a string literal.
+     * @param args The numbers for the placeholders.
+     */
+    template <typename... Args>
+    static void info(Category category, const char *format, Args... args)
+    {
+        trace<Info>(category, format, args...);
+    }
+
+    /**
+     * @brief Records a message at Warning level.
+     * @param category The category of the message.
+     * @param format The message with %1, %2, ... placeholders; must be a string literal.
+     * @param args The numbers for the placeholders.
+     */
+    template <typename... Args>
+    static void warning(Category category, const char *format, Args... args)
+    {
+        trace<Warning>(category, format, args...);
+    }
+
+    /**
+     * @brief Records a message if its level is compiled in and its category and level are enabled.
+     * @tparam level The level of the message.
+     * @param category The category of the message.
+     * @param format The message with %1, %2, ... placeholders; must be a string literal.
+     * @param args The numbers for the placeholders.
+     */
+    template <Level level, typename... Args>
+    static void trace(Category category, const char *format, Args... args)
+    {
+        static_assert(sizeof...(Args) <= MaxArguments, "Too many trace arguments");
+        static_assert((std::is_arithmetic<Args>::value && ...), "Trace arguments must be numbers");
+        if constexpr (level >= CompiledLevel && level < Off) {
+            if (isEnabled(category, level)) {
+                const double values[MaxArguments + 1] = { static_cast<double>(args)... };
+                write(level, category, format, values, static_cast<int>(sizeof...(Args)));
+            }
+        }
+    }
+
+    /**
+     * @brief Checks if messages of a category and level are recorded.
+     * @param category The category.
+     * @param level The level.
+     * @return True if both are enabled at run time.
+     */
+    static bool isEnabled(Category category, Level level)
+    {
+        return (enabledCategories.load(std::memory_order_relaxed) & category) != 0
+            && level >= enabledLevel.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Sets the categories that are recorded.
+     * @param categories A combination of Category flags; 0 disables tracing.
+     */
+    static void setCategories(quint32 categories);
+
+    /**
+     * @brief Sets the lowest level that is recorded.
+     * @param level The level; levels below CompiledLevel stay removed.
+     */
+    static void setLevel(Level level);
+
+    /**
+     * @brief Parses a list of category names.
+     * @param names Comma-separated names such as "graphics,physics", or "all".
+     * @param ok Set to false if a name is unknown, if not null.
+     * @return The combined Category flags of the known names.
+     */
+    static quint32 parseCategories(const QString &names, bool *ok = nullptr);
+
+    /**
+     * @brief Starts the thread that writes the recorded messages.
+     * @param path The file to append to; empty for standard error.
+     * @return True if the file could be opened.
+     */
+    static bool start(const QString &path = QString());
+
+    /**
+     * @brief Writes the remaining messages and stops the writing thread.
+     */
+    static void stop();
+
+    /**
+     * @brief Gets the number of messages dropped because the queue was full.
+     * @return The number of messages.
+     */
+    static quint64 droppedRecords();
+
+private:
+    static std::atomic<quint32> enabledCategories; ///< Category flags recorded at run time.
+    static std::atomic<int> enabledLevel;          ///< Lowest level recorded at run time.
+
+    /**
+     * @brief Queues a message for the writing thread.
+     * @param level The level of the message.
+     * @param category The category of the message.
+     * @param format The message with placeholders.
+     * @param values The numbers for the placeholders.
+     * @param count The number of values.
+     */
+    static void write(Level level, Category category, const char *format, const double *values, int count);
+};
+
+#endif // TRACER_H
@@ -42,9 +42,11 @@ public:
     void stopMovement();
 
     /**
-     * @brief Makes the ball fall.
+     * @brief Moves the falling ball.
+     * @param x The x-coordinate of the ball.
+     * @param y The y-coordinate of the ball.
      */
-    void fall();
+    void fall(double x, double y);
 
     /**
      * @brief Checks if the ball is falling.
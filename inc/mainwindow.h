@@ -6,7 +6,11 @@
 #include <QTimer>
 #include <QDateTimeAxis>
 #include "ChartManager.h"
+#include "FrameClock.h"
 #include "SerialManager.h"
+#include "PhysicsEngine.h"
+#include "SessionRecorder.h"
+#include "StatsMonitor.h"
 #include "TerminalLogger.h"
 #include "platform.h"
 #include "ball.h"
@@ -40,6 +44,61 @@ public:
      */
     ~MainWindow();
 
+    /**
+     * @brief Starts reading from a set of serial ports.
+     * @param portNames The names of the serial ports; the first one drives the platform.
+     * @param baudRate The baud rate used on every port.
+     */
+    void openPorts(const QStringList &portNames, qint32 baudRate);
+
+    /**
+     * @brief Replays a set of capture files in place of serial ports.
+     * @param paths The capture files; the first one drives the platform.
+     * @param speed The replay speed: 1 for real time, N for N times faster, 0 for as fast as possible.
+     */
+    void openReplays(const QStringList &paths, double speed);
+
+    /**
+     * @brief Records the raw bytes of the open ports into capture files.
+     * @param paths One capture file per port, in the order the ports were opened.
+     */
+    void startCapture(const QStringList &paths);
+
+    /**
+     * @brief Sets the file the statistics are exported to once per update.
+     * @param path The file; CSV if it ends in ".csv", JSON Lines otherwise.
+     * @return True if the file could be opened.
+     */
+    bool setStatsFile(const QString &path);
+
+    /**
+     * @brief Sets the channels carried by each frame.
+     * @param schema The channels, in frame order.
+     */
+    void setSchema(const ChannelSchema &schema);
+
+    /**
+     * @brief Sets the filters applied to the samples of all ports as they are read.
+     * @param description The filter stages, see FilterChain.
+     * @param error Receives a description of the problem if the text is invalid, if not null.
+     * @return True if the filters were valid.
+     */
+    bool setFilters(const QString &description, QString *error = nullptr);
+
+    /**
+     * @brief Records the samples of the open ports into a session file.
+     * @param path The file; an existing file is replaced.
+     * @return True if the file could be created.
+     */
+    bool startRecording(const QString &path);
+
+    /**
+     * @brief Shows a recorded session on the charts.
+     * @param path The session file.
+     * @return True if the file could be opened.
+     */
+    bool openSession(const QString &path);
+
 private slots:
     /**
      * @brief Starts the countdown timer.
@@ -64,24 +123,16 @@ private slots:
     void updateAnimation();
 
     /**
-     * @brief Updates the charts with new roll and pitch values.
-     * @param rollValue The roll value.
-     * @param pitchValue The pitch value.
-     */
-    void updateCharts(double rollValue, double pitchValue);
-
-    /**
-     * @brief Updates the ball position based on the pitch value.
-     * @param pitch The pitch value.
+     * @brief Updates the charts, log and platform with a batch of samples.
+     * @param port The index of the port the samples come from.
+     * @param samples The timestamped samples, oldest first, with one column per schema channel.
      */
-    void updateBallPosition(double pitch);
+    void updateCharts(int port, const SampleBlock &samples);
 
     /**
-     * @brief Calculates the new ball position based on the pitch value.
-     * @param pitch The pitch value.
-     * @return The new ball position.
+     * @brief Advances the ball simulation to the current time and moves the ball.
      */
-    double calculateBallPosition(double pitch);
+    void updateBallPosition();
 
     /**
      * @brief Decreases the platform width.
@@ -95,9 +146,10 @@ private slots:
 
     /**
      * @brief Updates the LED indicator based on the serial port status.
+     * @param port The index of the port.
      * @param isOpen The status of the serial port.
      */
-    void updateLedIndicator(bool isOpen);
+    void updateLedIndicator(int port, bool isOpen);
 
     /**
      * @brief Decreases the time scale of the charts.
@@ -115,26 +167,60 @@ private slots:
      */
     void changeLanguage(const QString &language);
 
+    /**
+     * @brief Changes the decimation applied to the charts.
+     * @param index The index of the selected entry in the decimation combo box.
+     */
+    void changeDecimationMode(int index);
+
+    /**
+     * @brief Switches the charts and the balance view between raster and OpenGL rendering.
+     * @param enabled True to request OpenGL rendering, false for raster rendering.
+     */
+    void toggleOpenGL(bool enabled);
+
 private:
     Ui::MainWindow *ui;                     ///< UI object for the main window.
     ChartManager *chartManager;             ///< Manages roll and pitch charts.
     SerialManager *serialManager;           ///< Manages serial communication.
     TerminalLogger *terminalLogger;         ///< Logs terminal output.
-    QTimer *animationTimer;                 ///< Timer for updating animations.
+    StatsMonitor *statsMonitor;             ///< Shows the pipeline statistics.
+    SessionRecorder *sessionRecorder;       ///< Records the received samples.
+    FrameClock *frameClock;                 ///< Delivers the display frames that update animations.
     QTimer *clockTimer;                     ///< Timer for updating the clock.
     QLabel *ledIndicator;                   ///< LED indicator for serial status.
+    QVector<bool> portOpen;                 ///< The status of every opened serial port.
     qint64 chartDuration;                   ///< Duration for displaying chart data.
     bool isCounting;                        ///< Indicates if the countdown is active.
+    int pitchChannel;                       ///< The channel that tilts the platform, -1 if the schema has none.
     QGraphicsScene *scene;                  ///< Scene for the graphical items.
     Platform *platform;                     ///< Platform object in the scene.
     Ball *ball;                             ///< Ball object in the scene.
     QTime startTime;                        ///< Start time for the countdown.
     QTranslator translator;                 ///< Translator for language changes.
+    PhysicsEngine physics;                  ///< Simulates the ball on the platform.
+    qint64 lastPhysicsUpdate;               ///< SampleClock time the simulation was last advanced to.
 
     /**
      * @brief Applies the time scale to the charts.
      */
     void applyTimeScale();
+
+    /**
+     * @brief Registers the pipeline metrics with the statistics panel.
+     */
+    void setupStats();
+
+    /**
+     * @brief Sets the names of the decimation modes in the current language.
+     */
+    void retranslateDecimationModes();
+
+    /**
+     * @brief Selects the viewport the balance view is drawn on.
+     * @param openGL True for an OpenGL viewport, false for a raster widget.
+     */
+    void setSceneViewport(bool openGL);
 };
 
 #endif // MAINWINDOW_H
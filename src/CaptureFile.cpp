@@ -0,0 +1,122 @@
+#include "CaptureFile.h"
+#include <QtEndian>
+#include <algorithm>
+
+const char CaptureWriter::Magic[8] = { 'W', 'D', 'S', 'C', 'A', 'P', '\0', '\1' };
+const int CaptureWriter::RecordHeaderLength;
+const int CaptureWriter::MaxRecordLength;
+
+/**
+ * @brief Creates a capture file, replacing an existing one.
+ * @param path The file.
+ * @return True if the file could be created.
+ */
+bool CaptureWriter::open(const QString &path)
+{
+    close();
+    file.setFileName(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    return file.write(Magic, sizeof(Magic)) == sizeof(Magic);
+}
+
+/**
+ * @brief Closes the file.
+ */
+void CaptureWriter::close()
+{
+    file.close();
+}
+
+/**
+ * @brief Checks if a file is open.
+ * @return True while recording.
+ */
+bool CaptureWriter::isOpen() const
+{
+    return file.isOpen();
+}
+
+/**
+ * @brief Appends the bytes of one read.
+ * @param time The read time in nanoseconds on the SampleClock.
+ * @param data The bytes.
+ * @param size The number of bytes, at most MaxRecordLength.
+ * @return True if the record was written.
+ *
+ * The record goes through QFile's buffer, so a read costs a copy and only
+ * every few kilobytes a system call.
+ */
+bool CaptureWriter::write(qint64 time, const char *data, qint64 size)
+{
+    if (!file.isOpen() || size <= 0 || size > MaxRecordLength) {
+        return false;
+    }
+    uchar header[RecordHeaderLength];
+    qToLittleEndian<qint64>(time, header);
+    qToLittleEndian<quint32>(static_cast<quint32>(size), header + 8);
+    return file.write(reinterpret_cast<const char *>(header), RecordHeaderLength) == RecordHeaderLength
+        && file.write(data, size) == size;
+}
+
+/**
+ * @brief Opens a capture file.
+ * @param path The file.
+ * @return True if the file could be opened and starts with CaptureWriter::Magic.
+ */
+bool CaptureReader::open(const QString &path)
+{
+    close();
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    char magic[sizeof(CaptureWriter::Magic)];
+    if (file.read(magic, sizeof(magic)) != sizeof(magic)
+        || !std::equal(magic, magic + sizeof(magic), CaptureWriter::Magic)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Closes the file.
+ */
+void CaptureReader::close()
+{
+    file.close();
+}
+
+/**
+ * @brief Goes back to the first record.
+ */
+void CaptureReader::rewind()
+{
+    file.seek(sizeof(CaptureWriter::Magic));
+}
+
+/**
+ * @brief Reads the next record.
+ * @param time Receives the read time in nanoseconds.
+ * @param data Receives the bytes; its capacity is reused.
+ * @return True if a record was read, false at the end of the file or on a truncated or corrupt record.
+ *
+ * A record whose length exceeds CaptureWriter::MaxRecordLength or the rest
+ * of the file is corrupt and ends the capture.
+ */
+bool CaptureReader::next(qint64 &time, QByteArray &data)
+{
+    uchar header[CaptureWriter::RecordHeaderLength];
+    if (file.read(reinterpret_cast<char *>(header), sizeof(header)) != sizeof(header)) {
+        return false;
+    }
+    time = qFromLittleEndian<qint64>(header);
+    qint64 size = qFromLittleEndian<quint32>(header + 8);
+    if (size > CaptureWriter::MaxRecordLength || size > file.size() - file.pos()) {
+        return false;
+    }
+    data.resize(static_cast<int>(size));
+    return file.read(data.data(), size) == size;
+}
@@ -0,0 +1,126 @@
+#include "ChannelSchema.h"
+#include <QStringList>
+
+const int ChannelSchema::MaxChannels;
+
+/**
+ * @brief Constructs a schema without channels.
+ */
+ChannelSchema::ChannelSchema()
+{
+}
+
+/**
+ * @brief Constructs a schema from channel descriptors.
+ * @param channels The channels in frame order; at most MaxChannels are used.
+ */
+ChannelSchema::ChannelSchema(const QVector<ChannelDescriptor> &channels)
+    : channels(channels.mid(0, MaxChannels))
+{
+}
+
+/**
+ * @brief Gets the schema of the roll/pitch attitude board.
+ * @return A schema with the channels "Roll" and "Pitch" in degrees.
+ *
+ * This is the layout of the original "b<roll> <pitch> <crc>" frames. Both
+ * channels are plotted from -90 to 90 degrees.
+ */
+ChannelSchema ChannelSchema::attitude()
+{
+    return ChannelSchema({ { "Roll", "deg", -90, 90 }, { "Pitch", "deg", -90, 90 } });
+}
+
+/**
+ * @brief Gets the schema of a 9-axis IMU with temperature.
+ * @return A schema with accelerometer, gyroscope and magnetometer axes and a temperature channel.
+ *
+ * The plotted ranges are fitted to the data.
+ */
+ChannelSchema ChannelSchema::imu()
+{
+    return ChannelSchema({
+        { "Accel X", "g" },   { "Accel Y", "g" },   { "Accel Z", "g" },
+        { "Gyro X", "dps" },  { "Gyro Y", "dps" },  { "Gyro Z", "dps" },
+        { "Mag X", "uT" },    { "Mag Y", "uT" },    { "Mag Z", "uT" },
+        { "Temperature", "C" }
+    });
+}
+
+/**
+ * @brief Parses a schema from a comma-separated list.
+ * @param text Channels in the form "Name[unit]", e.g. "Roll[deg], Pitch[deg], Temp[C]".
+ * @return The parsed schema.
+ *
+ * The unit and its brackets are optional. Empty entries are skipped. The
+ * plotted ranges of parsed channels are fitted to the data.
+ */
+ChannelSchema ChannelSchema::fromString(const QString &text)
+{
+    QVector<ChannelDescriptor> parsed;
+    const QStringList entries = text.split(',');
+    for (const QString &entry : entries) {
+        QString name = entry.trimmed();
+        QString unit;
+        int open = name.indexOf('[');
+        if (open >= 0 && name.endsWith(']')) {
+            unit = name.mid(open + 1, name.size() - open - 2).trimmed();
+            name = name.left(open).trimmed();
+        }
+        if (!name.isEmpty()) {
+            ChannelDescriptor descriptor;
+            descriptor.name = name;
+            descriptor.unit = unit;
+            parsed.append(descriptor);
+        }
+    }
+    return ChannelSchema(parsed);
+}
+
+/**
+ * @brief Formats the schema in the form accepted by fromString().
+ * @return The channel list.
+ */
+QString ChannelSchema::toString() const
+{
+    QStringList entries;
+    for (const ChannelDescriptor &descriptor : channels) {
+        entries.append(descriptor.unit.isEmpty() ? descriptor.name
+                                                 : QString("%1[%2]").arg(descriptor.name, descriptor.unit));
+    }
+    return entries.join(", ");
+}
+
+/**
+ * @brief Gets the number of channels.
+ * @return The number of channels.
+ */
+int ChannelSchema::channelCount() const
+{
+    return channels.size();
+}
+
+/**
+ * @brief Gets a channel descriptor.
+ * @param index The position of the channel in the frame.
+ * @return The descriptor.
+ */
+const ChannelDescriptor &ChannelSchema::channel(int index) const
+{
+    return channels.at(index);
+}
+
+/**
+ * @brief Finds a channel by name, ignoring case.
+ * @param name The channel name.
+ * @return The position of the channel, or -1 if there is none.
+ */
+int ChannelSchema::indexOf(const QString &name) const
+{
+    for (int i = 0; i < channels.size(); ++i) {
+        if (channels.at(i).name.compare(name, Qt::CaseInsensitive) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
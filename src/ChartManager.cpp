@@ -1,21 +1,105 @@
 #include "ChartManager.h"
+#include "SampleClock.h"
+#include "Tracer.h"
+#include <QMouseEvent>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QWheelEvent>
+#include <QtMath>
+#include <QtNumeric>
+#include <functional>
+
+namespace {
+
+/**
+ * @brief Nanoseconds per millisecond; sample times are in nanoseconds, durations and the axes in milliseconds.
+ */
+const qint64 NSecsPerMSec = 1000000;
+
+/**
+ * @brief Widens a value range to include a set of points.
+ * @param points The points.
+ * @param minimum The lower end of the range, updated in place.
+ * @param maximum The upper end of the range, updated in place.
+ *
+ * Missing values (NaN) are ignored.
+ */
+void extendRange(const QVector<QPointF> &points, double &minimum, double &maximum)
+{
+    for (const QPointF &point : points) {
+        if (point.y() < minimum) { // NaN never compares smaller or larger
+            minimum = point.y();
+        }
+        if (point.y() > maximum) {
+            maximum = point.y();
+        }
+    }
+}
+
+/**
+ * @class TimedChartView
+ * @brief A chart view that reports when each repaint of its viewport starts and ends.
+ */
+class TimedChartView : public QChartView
+{
+public:
+    /**
+     * @brief Constructs a TimedChartView.
+     * @param chart The chart to show.
+     * @param painted Called with the SampleClock start and end time of every repaint.
+     */
+    TimedChartView(QChart *chart, std::function<void(qint64, qint64)> painted)
+        : QChartView(chart), painted(painted)
+    {
+    }
+
+protected:
+    /**
+     * @brief Paints the chart and reports the time it took.
+     * @param event The paint event.
+     */
+    void paintEvent(QPaintEvent *event) override
+    {
+        qint64 start = SampleClock::now();
+        QChartView::paintEvent(event);
+        painted(start, SampleClock::now());
+    }
+
+private:
+    std::function<void(qint64, qint64)> painted; ///< Receives the repaint times.
+};
+
+} // namespace
+
+const qint64 ChartManager::HistoryBudget;
+const qint64 ChartManager::MaxLiveDuration;
 
 /**
  * @brief Constructs a ChartManager object.
  * @param parent The parent QObject, default is nullptr.
  *
  * This constructor initializes the roll and pitch charts, sets up their views,
- * and configures the axes and series for both charts.
+ * and configures the axes for both charts. The charts start with a single
+ * source.
  */
 ChartManager::ChartManager(QObject *parent)
     : QObject(parent)
-    , rollSeries(new QLineSeries())
-    , pitchSeries(new QLineSeries())
     , rollChart(new QChart())
     , pitchChart(new QChart())
-    , rollChartView(new QChartView(rollChart))
-    , pitchChartView(new QChartView(pitchChart))
+    , rollChartView(new TimedChartView(rollChart, [this](qint64 start, qint64 end) { recordRepaint(start, end); }))
+    , pitchChartView(new TimedChartView(pitchChart, [this](qint64 start, qint64 end) { recordRepaint(start, end); }))
     , chartDuration(20 * 1000) // 20 seconds in milliseconds
+    , scheduler(new RenderScheduler(this))
+    , lastTimestamp(0)
+    , decimationMode(Decimator::Mode::MinMax)
+    , renderMode(RenderMode::Raster)
+    , followingLatest(true)
+    , viewEnd(0)
+    , dragX(-1)
+    , rollChannel(-1)
+    , pitchChannel(-1)
+    , pendingSince(0)
+    , flushedSince(0)
 {
     // Configure roll chart
     QDateTimeAxis *axisXRoll = new QDateTimeAxis();
@@ -26,11 +110,8 @@ ChartManager::ChartManager(QObject *parent)
     axisYRoll->setRange(-90, 90);
     axisYRoll->setTitleText("Roll Angle");
 
-    rollChart->addSeries(rollSeries);
     rollChart->addAxis(axisXRoll, Qt::AlignBottom);
     rollChart->addAxis(axisYRoll, Qt::AlignLeft);
-    rollSeries->attachAxis(axisXRoll);
-    rollSeries->attachAxis(axisYRoll);
     rollChart->setTitle("Roll Angle");
     rollChart->legend()->hide();
 
@@ -43,17 +124,23 @@ ChartManager::ChartManager(QObject *parent)
     axisYPitch->setRange(-90, 90);
     axisYPitch->setTitleText("Pitch Angle");
 
-    pitchChart->addSeries(pitchSeries);
     pitchChart->addAxis(axisXPitch, Qt::AlignBottom);
     pitchChart->addAxis(axisYPitch, Qt::AlignLeft);
-    pitchSeries->attachAxis(axisXPitch);
-    pitchSeries->attachAxis(axisYPitch);
     pitchChart->setTitle("Pitch Angle");
     pitchChart->legend()->hide();
 
     // Set antialiasing for chart views
     rollChartView->setRenderHint(QPainter::Antialiasing);
     pitchChartView->setRenderHint(QPainter::Antialiasing);
+
+    connect(scheduler, &RenderScheduler::frameReady, this, &ChartManager::flush);
+
+    // Zoom and pan input
+    rollChartView->viewport()->installEventFilter(this);
+    pitchChartView->viewport()->installEventFilter(this);
+
+    setSources(QStringList(QString()));
+    setSchema(ChannelSchema::attitude());
 }
 
 /**
@@ -89,32 +176,444 @@ QChart* ChartManager::getPitchChart() const {
 }
 
 /**
- * @brief Updates the charts with new roll and pitch values.
- * @param currentTime The current timestamp in milliseconds.
- * @param rollValue The roll value.
- * @param pitchValue The pitch value.
+ * @brief Gets the scheduler that paces chart redraws.
+ * @return A pointer to the render scheduler.
+ *
+ * The scheduler must be ticked by the owner's frame clock for the charts to
+ * be redrawn.
+ */
+RenderScheduler* ChartManager::getRenderScheduler() const {
+    return scheduler;
+}
+
+/**
+ * @brief Sets the time span shown on the charts.
+ * @param duration The duration in milliseconds.
+ *
+ * The new duration takes effect on the next frame.
+ */
+void ChartManager::setChartDuration(qint64 duration) {
+    chartDuration = duration;
+    scheduler->requestFrame();
+}
+
+/**
+ * @brief Gets the time span shown on the charts.
+ * @return The duration in milliseconds.
+ */
+qint64 ChartManager::getChartDuration() const {
+    return chartDuration;
+}
+
+/**
+ * @brief Gets the time span kept at full resolution in the sample buffers.
+ * @return The chart duration, at most MaxLiveDuration, in milliseconds.
+ *
+ * Wider views are drawn from the histories, whose memory is bounded, so
+ * zooming out does not keep every raw sample of the view.
+ */
+qint64 ChartManager::getLiveDuration() const {
+    return qMin(chartDuration, MaxLiveDuration);
+}
+
+/**
+ * @brief Zooms the charts in or out around the right edge of the view.
+ * @param factor The factor to scale the shown time span by; below 1 zooms in.
+ *
+ * The span is kept between one second and one day. Spans longer than
+ * MaxLiveDuration are drawn from the history.
+ */
+void ChartManager::zoom(double factor) {
+    setChartDuration(qBound<qint64>(1000, qRound64(chartDuration * factor), 24 * 3600 * 1000));
+}
+
+/**
+ * @brief Moves the view along the time axis and stops following new data.
+ * @param delta The time to move by in milliseconds; negative values move back in time.
+ *
+ * Panning past the newest sample returns to the live view.
+ */
+void ChartManager::pan(qint64 delta) {
+    qint64 end = (followingLatest ? lastTimestamp : viewEnd) + delta * NSecsPerMSec;
+    if (end >= lastTimestamp) {
+        followLatest();
+        return;
+    }
+    followingLatest = false;
+    viewEnd = qMax(end, firstTimestamp() + chartDuration * NSecsPerMSec / 2);
+    scheduler->requestFrame();
+}
+
+/**
+ * @brief Returns to the live view that follows the newest sample.
+ */
+void ChartManager::followLatest() {
+    followingLatest = true;
+    scheduler->requestFrame();
+}
+
+/**
+ * @brief Checks if the view follows the newest sample.
+ * @return True if the view is live, false if it has been panned away.
+ */
+bool ChartManager::isFollowingLatest() const {
+    return followingLatest;
+}
+
+/**
+ * @brief Handles zoom and pan input on the chart views.
+ * @param watched The object receiving the event.
+ * @param event The event.
+ * @return True if the event was consumed, false otherwise.
  *
- * This method appends new data points to the roll and pitch series, and removes
- * old data points that fall outside the specified chart duration. It also updates
- * the x-axis range of both charts to keep the data within the visible range.
+ * The mouse wheel zooms, Shift+wheel or a horizontal wheel pans by a tenth
+ * of the view per step, dragging with the left button pans by the dragged
+ * distance and a double click returns to the live view.
  */
-void ChartManager::updateCharts(qint64 currentTime, double rollValue, double pitchValue) {
-    // Append new data points
-    rollSeries->append(currentTime, rollValue);
-    pitchSeries->append(currentTime, pitchValue);
+bool ChartManager::eventFilter(QObject *watched, QEvent *event) {
+    QWidget *viewport = qobject_cast<QWidget*>(watched);
+    if (!viewport) {
+        return QObject::eventFilter(watched, event);
+    }
 
-    // Remove old data points outside the chart duration
-    while (!rollSeries->points().isEmpty() && rollSeries->points().first().x() < currentTime - chartDuration) {
-        rollSeries->remove(0);
+    switch (event->type()) {
+    case QEvent::Wheel: {
+        QWheelEvent *wheel = static_cast<QWheelEvent*>(event);
+        int steps = (wheel->angleDelta().x() != 0 ? wheel->angleDelta().x() : wheel->angleDelta().y()) / 120;
+        if (steps == 0) {
+            return true;
+        }
+        if (wheel->angleDelta().x() != 0 || (wheel->modifiers() & Qt::ShiftModifier)) {
+            pan(-steps * chartDuration / 10);
+        } else {
+            zoom(steps > 0 ? qPow(0.8, steps) : qPow(1.25, -steps));
+        }
+        return true;
+    }
+    case QEvent::MouseButtonPress: {
+        QMouseEvent *mouse = static_cast<QMouseEvent*>(event);
+        if (mouse->button() == Qt::LeftButton) {
+            dragX = mouse->pos().x();
+            return true;
+        }
+        break;
+    }
+    case QEvent::MouseMove: {
+        QMouseEvent *mouse = static_cast<QMouseEvent*>(event);
+        if (dragX >= 0 && (mouse->buttons() & Qt::LeftButton)) {
+            int dx = mouse->pos().x() - dragX;
+            dragX = mouse->pos().x();
+            pan(-dx * chartDuration / qMax(1, viewport->width()));
+            return true;
+        }
+        break;
     }
+    case QEvent::MouseButtonRelease:
+        dragX = -1;
+        break;
+    case QEvent::MouseButtonDblClick:
+        followLatest();
+        return true;
+    default:
+        break;
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+/**
+ * @brief Sets the decimation algorithm applied before drawing.
+ * @param mode The decimation mode.
+ *
+ * The new mode takes effect on the next frame.
+ */
+void ChartManager::setDecimationMode(Decimator::Mode mode) {
+    decimationMode = mode;
+    scheduler->requestFrame();
+}
 
-    while (!pitchSeries->points().isEmpty() && pitchSeries->points().first().x() < currentTime - chartDuration) {
-        pitchSeries->remove(0);
+/**
+ * @brief Gets the decimation algorithm applied before drawing.
+ * @return The decimation mode.
+ */
+Decimator::Mode ChartManager::getDecimationMode() const {
+    return decimationMode;
+}
+
+/**
+ * @brief Selects how the data series are drawn.
+ * @param mode The requested render mode.
+ * @return The render mode actually in use.
+ *
+ * In OpenGL mode QtCharts draws all line series on an OpenGL widget placed
+ * over the plot area, while axes, grid and titles are still painted by the
+ * chart view. The GPU then rasterises the lines, which scales much better
+ * with the number of points than the antialiased QPainter path. On machines
+ * without a GPU driver, Mesa's software rasteriser still provides a context;
+ * if no context can be created at all, the raster path is kept.
+ */
+ChartManager::RenderMode ChartManager::setRenderMode(RenderMode mode) {
+    if (mode == RenderMode::OpenGL && !isOpenGLAvailable()) {
+        Tracer::warning(Tracer::Graphics, "OpenGL is not available, falling back to raster rendering");
+        mode = RenderMode::Raster;
+    }
+
+    renderMode = mode;
+    for (const Source &source : qAsConst(sources)) {
+        source.rollSeries->setUseOpenGL(mode == RenderMode::OpenGL);
+        source.pitchSeries->setUseOpenGL(mode == RenderMode::OpenGL);
+    }
+    scheduler->requestFrame();
+    return renderMode;
+}
+
+/**
+ * @brief Gets how the data series are drawn.
+ * @return The render mode in use.
+ */
+ChartManager::RenderMode ChartManager::getRenderMode() const {
+    return renderMode;
+}
+
+/**
+ * @brief Checks if an OpenGL context can be created on this machine.
+ * @return True if OpenGL rendering is usable, false otherwise.
+ *
+ * The check creates a throw-away context and makes it current on an
+ * offscreen surface. The result is cached after the first call.
+ */
+bool ChartManager::isOpenGLAvailable() {
+    static int available = -1;
+    if (available == -1) {
+        QOpenGLContext context;
+        QOffscreenSurface surface;
+        surface.setFormat(context.format());
+        surface.create();
+        available = context.create() && surface.isValid() && context.makeCurrent(&surface) ? 1 : 0;
+        if (available) {
+            Tracer::info(Tracer::Graphics, "OpenGL is available for chart rendering");
+            context.doneCurrent();
+        }
+    }
+    return available == 1;
+}
+
+/**
+ * @brief Sets the channels carried by the samples and clears the stored data.
+ * @param schema The channel schema.
+ *
+ * The roll chart shows the channel named "Roll" and the pitch chart the
+ * channel named "Pitch". If the schema has no such channels, the first two
+ * channels are shown instead.
+ */
+void ChartManager::setSchema(const ChannelSchema &schema) {
+    this->schema = schema;
+    for (Source &source : sources) {
+        source.samples.setChannelCount(schema.channelCount());
+        source.history.setChannelCount(schema.channelCount());
     }
+    lastTimestamp = 0;
+    followingLatest = true;
+
+    int roll = schema.indexOf("Roll");
+    int pitch = schema.indexOf("Pitch");
+    if (roll < 0 || pitch < 0) {
+        roll = schema.channelCount() > 0 ? 0 : -1;
+        pitch = schema.channelCount() > 1 ? 1 : -1;
+    }
+    setDisplayedChannels(roll, pitch);
+}
+
+/**
+ * @brief Gets the channels carried by the samples.
+ * @return The channel schema.
+ */
+const ChannelSchema &ChartManager::getSchema() const {
+    return schema;
+}
+
+/**
+ * @brief Selects the channel shown on each chart.
+ * @param rollChartChannel The channel shown on the roll chart, -1 for none.
+ * @param pitchChartChannel The channel shown on the pitch chart, -1 for none.
+ *
+ * All channels stay stored, so switching channels also shows their past data.
+ */
+void ChartManager::setDisplayedChannels(int rollChartChannel, int pitchChartChannel) {
+    rollChannel = rollChartChannel < schema.channelCount() ? rollChartChannel : -1;
+    pitchChannel = pitchChartChannel < schema.channelCount() ? pitchChartChannel : -1;
+    applyChannel(rollChart, rollChannel);
+    applyChannel(pitchChart, pitchChannel);
+    scheduler->requestFrame();
+}
+
+/**
+ * @brief Sets the devices whose data is overlaid on the charts and clears the stored data.
+ * @param names The display names of the devices, shown in the legend.
+ *
+ * Every device gets its own sample buffer, history and one series on each
+ * chart. The history memory budget is shared equally between the devices.
+ * The legend is only shown when there is more than one device.
+ */
+void ChartManager::setSources(const QStringList &names) {
+    for (const Source &source : qAsConst(sources)) {
+        rollChart->removeSeries(source.rollSeries);
+        pitchChart->removeSeries(source.pitchSeries);
+        delete source.rollSeries;
+        delete source.pitchSeries;
+    }
+    sources.clear();
+
+    const int count = qMax(names.size(), 1);
+    const qint64 budget = HistoryBudget / count;
+    for (int i = 0; i < count; ++i) {
+        Source source;
+        source.name = names.value(i);
+        source.samples.setChannelCount(schema.channelCount());
+        source.history = HistoryStore(schema.channelCount(), budget);
+        source.rollSeries = addSeries(rollChart, source.name);
+        source.pitchSeries = addSeries(pitchChart, source.name);
+        sources.append(source);
+    }
+
+    rollChart->legend()->setVisible(count > 1);
+    pitchChart->legend()->setVisible(count > 1);
+    lastTimestamp = 0;
+    followingLatest = true;
+    scheduler->requestFrame();
+}
+
+/**
+ * @brief Gets the number of devices whose data is overlaid on the charts.
+ * @return The number of sources.
+ */
+int ChartManager::getSourceCount() const {
+    return sources.size();
+}
+
+/**
+ * @brief Updates the charts with a batch of samples.
+ * @param batch The timestamped samples, oldest first, with one column per schema channel.
+ * @param source The index of the device the samples come from.
+ *
+ * The samples are only stored in the sample buffer and the history of the
+ * device here and a frame is requested from the render scheduler; the
+ * charts are updated in flush(). All devices share one time base, so the
+ * newest timestamp of any device marks the right edge of the live view.
+ * Samples that have left the live view are evicted here as well, so the
+ * sample buffer stays bounded while no frames are drawn, e.g. while the
+ * window is minimised.
+ */
+void ChartManager::updateCharts(const SampleBlock &batch, int source) {
+    if (batch.isEmpty() || source < 0 || source >= sources.size()) {
+        return;
+    }
+    Source &target = sources[source];
+    target.samples.append(batch);
+    target.history.append(batch);
+    lastTimestamp = qMax(lastTimestamp, batch.timestamp(batch.size() - 1));
+    target.samples.evictBefore(lastTimestamp - getLiveDuration() * NSecsPerMSec);
+    if (pendingSince == 0) {
+        pendingSince = SampleClock::now();
+    }
+    scheduler->requestFrame();
+}
+
+/**
+ * @brief Adds a batch of samples older than the live view to the history only.
+ * @param batch The timestamped samples, oldest first, with one column per schema channel.
+ * @param source The index of the device the samples come from.
+ *
+ * Used when loading recorded data: samples that the live view would evict
+ * right away skip the sample buffer and are only shown when the view is
+ * zoomed out or panned back, from the history. The newest samples must
+ * still go through updateCharts().
+ */
+void ChartManager::updateHistory(const SampleBlock &batch, int source) {
+    if (batch.isEmpty() || source < 0 || source >= sources.size()) {
+        return;
+    }
+    sources[source].history.append(batch);
+    lastTimestamp = qMax(lastTimestamp, batch.timestamp(batch.size() - 1));
+    scheduler->requestFrame();
+}
+
+/**
+ * @brief Redraws the series from the sample buffer and moves the time axes.
+ *
+ * In the live view this method evicts samples that fall outside the live
+ * span (see getLiveDuration()) from the sample buffer of every device,
+ * decimates the remaining ones to the width of the plot area and hands the
+ * result to the device's roll and pitch series with a single bulk replace()
+ * each. The number of points drawn is therefore bounded by the view width,
+ * not by the number of samples in the window. When the view has been panned,
+ * or zoomed out beyond what the sample buffer still holds, the points are
+ * read from the history store at the resolution that fits the view instead.
+ * It also updates the x-axis range of both charts to the shown time span,
+ * taking the newest sample (or the current time before any data arrived) as
+ * the right edge of the live view. The views are then scheduled for a single
+ * asynchronous repaint instead of being repainted synchronously. The time
+ * this method takes is recorded.
+ */
+void ChartManager::flush() {
+    qint64 flushStart = SampleClock::now();
+    flushedSince = pendingSince;
+    pendingSince = 0;
+
+    const qint64 duration = chartDuration * NSecsPerMSec;
+    qint64 liveTime = lastTimestamp != 0 ? lastTimestamp : SampleClock::toNSecsSinceEpoch(SampleClock::now());
+    qint64 currentTime = followingLatest ? liveTime : viewEnd;
+    qint64 startTime = currentTime - duration;
+
+    int rollWidth = rollChart->plotArea().isEmpty() ? rollChartView->width() : qRound(rollChart->plotArea().width());
+    int pitchWidth = pitchChart->plotArea().isEmpty() ? pitchChartView->width() : qRound(pitchChart->plotArea().width());
+    QVector<QPointF> rollPoints;
+    QVector<QPointF> pitchPoints;
+    double rollMinimum = qInf();
+    double rollMaximum = -qInf();
+    double pitchMinimum = qInf();
+    double pitchMaximum = -qInf();
+
+    for (Source &source : sources) {
+        SampleBuffer &samples = source.samples;
+        const HistoryStore &history = source.history;
+        rollPoints.clear();
+        pitchPoints.clear();
+
+        bool liveCovered = !samples.isEmpty() && samples.firstTimestamp() <= qMax(startTime, history.firstTimestamp());
+
+        // Remove old samples outside the live span
+        samples.evictBefore(liveTime - getLiveDuration() * NSecsPerMSec);
+
+        if (followingLatest && (liveCovered || history.isEmpty())) {
+            // Decimate the shown channels to the plot width
+            if (rollChannel >= 0) {
+                Decimator::decimate(decimationMode, samples, rollChannel, rollWidth, rollPoints);
+            }
+            if (pitchChannel >= 0) {
+                Decimator::decimate(decimationMode, samples, pitchChannel, pitchWidth, pitchPoints);
+            }
+        } else {
+            // Read only the history level that fits the view
+            if (rollChannel >= 0) {
+                history.query(startTime, currentTime, rollWidth, rollChannel, rollPoints);
+            }
+            if (pitchChannel >= 0) {
+                history.query(startTime, currentTime, pitchWidth, pitchChannel, pitchPoints);
+            }
+        }
+
+        // Replace the series contents in one go
+        source.rollSeries->replace(rollPoints);
+        source.pitchSeries->replace(pitchPoints);
+        extendRange(rollPoints, rollMinimum, rollMaximum);
+        extendRange(pitchPoints, pitchMinimum, pitchMaximum);
+    }
+    fitValueAxis(rollChart, rollChannel, rollMinimum, rollMaximum);
+    fitValueAxis(pitchChart, pitchChannel, pitchMinimum, pitchMaximum);
 
     // Update the x-axis range
-    QDateTime minTime = QDateTime::fromMSecsSinceEpoch(currentTime - chartDuration);
-    QDateTime maxTime = QDateTime::fromMSecsSinceEpoch(currentTime);
+    QDateTime minTime = QDateTime::fromMSecsSinceEpoch(startTime / NSecsPerMSec);
+    QDateTime maxTime = QDateTime::fromMSecsSinceEpoch(currentTime / NSecsPerMSec);
 
     QDateTimeAxis *axisXRoll = qobject_cast<QDateTimeAxis*>(rollChart->axes(Qt::Horizontal).first());
     if (axisXRoll) {
@@ -128,7 +627,140 @@ void ChartManager::updateCharts(qint64 currentTime, double rollValue, double pit
         axisXPitch->setMax(maxTime);
     }
 
-    // Repaint the chart views
-    rollChartView->repaint();
-    pitchChartView->repaint();
+    // Schedule a repaint of the chart views
+    rollChartView->viewport()->update();
+    pitchChartView->viewport()->update();
+
+    updateTime.record(static_cast<quint64>(SampleClock::now() - flushStart));
+}
+
+/**
+ * @brief Gets the time spent preparing the series of each frame.
+ * @return The durations in nanoseconds.
+ */
+HistogramSnapshot ChartManager::getUpdateTime() const {
+    return updateTime.snapshot();
+}
+
+/**
+ * @brief Gets the time spent repainting a chart view.
+ * @return The durations in nanoseconds.
+ *
+ * In OpenGL mode the series are drawn on an overlay and are not included.
+ */
+HistogramSnapshot ChartManager::getRepaintTime() const {
+    return repaintTime.snapshot();
+}
+
+/**
+ * @brief Gets the time from the arrival of new samples until they were painted.
+ * @return The latencies in nanoseconds.
+ *
+ * This is measured from the first updateCharts() call after a frame until
+ * the end of the first repaint after the next frame.
+ */
+HistogramSnapshot ChartManager::getDisplayLatency() const {
+    return displayLatency.snapshot();
+}
+
+/**
+ * @brief Records a repaint of one of the chart views.
+ * @param start The SampleClock time the repaint started.
+ * @param end The SampleClock time the repaint ended.
+ */
+void ChartManager::recordRepaint(qint64 start, qint64 end) {
+    repaintTime.record(static_cast<quint64>(end - start));
+    if (flushedSince != 0) {
+        displayLatency.record(static_cast<quint64>(end - flushedSince));
+        flushedSince = 0;
+    }
+}
+
+/**
+ * @brief Labels a chart and its value axis after the channel it shows.
+ * @param chart The chart.
+ * @param channel The channel shown on the chart, -1 for none.
+ *
+ * Channels with a fixed range get it here; the others are fitted to the
+ * data on every frame.
+ */
+void ChartManager::applyChannel(QChart *chart, int channel) {
+    QValueAxis *axisY = qobject_cast<QValueAxis*>(chart->axes(Qt::Vertical).first());
+    if (channel < 0) {
+        chart->setTitle(QString());
+        if (axisY) {
+            axisY->setTitleText(QString());
+        }
+        return;
+    }
+
+    const ChannelDescriptor &descriptor = schema.channel(channel);
+    chart->setTitle(descriptor.name);
+    if (axisY) {
+        axisY->setTitleText(descriptor.unit.isEmpty() ? descriptor.name
+                                                      : QString("%1 [%2]").arg(descriptor.name, descriptor.unit));
+        if (descriptor.minimum < descriptor.maximum) {
+            axisY->setRange(descriptor.minimum, descriptor.maximum);
+        }
+    }
+}
+
+/**
+ * @brief Fits the value axis of a chart to its points if the channel has no fixed range.
+ * @param chart The chart.
+ * @param channel The channel shown on the chart, -1 for none.
+ * @param minimum The smallest value shown, +infinity if there are none.
+ * @param maximum The largest value shown, -infinity if there are none.
+ *
+ * A flat signal gets a range of one unit around its value.
+ */
+void ChartManager::fitValueAxis(QChart *chart, int channel, double minimum, double maximum) {
+    if (channel < 0 || schema.channel(channel).minimum < schema.channel(channel).maximum) {
+        return;
+    }
+    if (minimum > maximum) {
+        return; // Nothing to fit
+    }
+    if (minimum == maximum) {
+        minimum -= 0.5;
+        maximum += 0.5;
+    }
+
+    QValueAxis *axisY = qobject_cast<QValueAxis*>(chart->axes(Qt::Vertical).first());
+    if (axisY) {
+        double margin = (maximum - minimum) * 0.05;
+        axisY->setRange(minimum - margin, maximum + margin);
+    }
+}
+
+/**
+ * @brief Adds an empty series to a chart and attaches it to the chart's axes.
+ * @param chart The chart.
+ * @param name The name shown in the legend.
+ * @return The series, owned by the chart.
+ */
+QLineSeries* ChartManager::addSeries(QChart *chart, const QString &name) {
+    QLineSeries *series = new QLineSeries();
+    series->setName(name);
+    series->setUseOpenGL(renderMode == RenderMode::OpenGL);
+    chart->addSeries(series);
+    const QList<QAbstractAxis*> axes = chart->axes();
+    for (QAbstractAxis *axis : axes) {
+        series->attachAxis(axis);
+    }
+    return series;
+}
+
+/**
+ * @brief Gets the time of the oldest data of any device.
+ * @return The timestamp in nanoseconds since the epoch, or 0 if there is no data.
+ */
+qint64 ChartManager::firstTimestamp() const {
+    qint64 first = 0;
+    for (const Source &source : sources) {
+        if (!source.history.isEmpty() && (first == 0 || source.history.firstTimestamp() < first)) {
+            first = source.history.firstTimestamp();
+        }
+    }
+    return first;
 }
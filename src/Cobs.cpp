@@ -0,0 +1,68 @@
+#include "Cobs.h"
+
+/**
+ * @brief Encodes a packet.
+ * @param data The first byte of the packet.
+ * @param length The length of the packet in bytes.
+ * @param out Receives the encoded bytes; must hold maxEncodedLength(length) bytes.
+ * @return The number of bytes written. No delimiter is appended.
+ *
+ * Every run of up to 254 non-zero bytes is prefixed with a code byte holding
+ * the distance to the next zero (or to the end of the run); the zeros
+ * themselves are dropped.
+ */
+std::size_t Cobs::encode(const char *data, std::size_t length, char *out)
+{
+    std::size_t code = 0;  // Position of the pending code byte
+    std::size_t write = 1;
+    unsigned char distance = 1;
+
+    for (std::size_t i = 0; i < length; ++i) {
+        if (data[i] != 0) {
+            out[write++] = data[i];
+            ++distance;
+        }
+        if (data[i] == 0 || distance == 0xFF) {
+            out[code] = static_cast<char>(distance);
+            code = write++;
+            distance = 1;
+        }
+    }
+    out[code] = static_cast<char>(distance);
+    return write;
+}
+
+/**
+ * @brief Decodes a packet.
+ * @param data The first encoded byte, without the delimiter.
+ * @param length The number of encoded bytes.
+ * @param out Receives the decoded packet; must hold length bytes.
+ * @param decodedLength Receives the length of the decoded packet on success.
+ * @return True if the input is a valid encoding, false otherwise.
+ *
+ * The input is rejected if it contains a zero byte or a code byte points
+ * past its end.
+ */
+bool Cobs::decode(const char *data, std::size_t length, char *out, std::size_t &decodedLength)
+{
+    std::size_t read = 0;
+    std::size_t write = 0;
+
+    while (read < length) {
+        unsigned char code = static_cast<unsigned char>(data[read++]);
+        if (code == 0 || read + code - 1 > length) {
+            return false;
+        }
+        for (unsigned char i = 1; i < code; ++i) {
+            if (data[read] == 0) {
+                return false;
+            }
+            out[write++] = data[read++];
+        }
+        if (code != 0xFF && read < length) {
+            out[write++] = 0; // A code below 0xFF stands for a zero, except at the very end
+        }
+    }
+    decodedLength = write;
+    return true;
+}
@@ -0,0 +1,182 @@
+#include "Decimator.h"
+#include "SampleClock.h"
+#include <cmath>
+
+namespace {
+
+/**
+ * @brief Gets the point to draw for one sample.
+ * @param samples The samples.
+ * @param channel The position of the channel to plot.
+ * @param index The position of the sample.
+ * @return The point, with the time on the chart axis in milliseconds.
+ */
+QPointF pointAt(const SampleBuffer &samples, int channel, int index)
+{
+    return QPointF(SampleClock::toChartTime(samples.timestamp(index)), samples.value(channel, index));
+}
+
+/**
+ * @brief Appends the extremes of one pixel column in the order they occurred.
+ * @param samples The samples, oldest first.
+ * @param channel The position of the channel to plot.
+ * @param minIndex The position of the column minimum.
+ * @param maxIndex The position of the column maximum.
+ * @param points The points to append to.
+ */
+void appendExtremes(const SampleBuffer &samples, int channel, int minIndex, int maxIndex, QVector<QPointF> &points)
+{
+    int first = qMin(minIndex, maxIndex);
+    int second = qMax(minIndex, maxIndex);
+    points.append(pointAt(samples, channel, first));
+    if (second != first) {
+        points.append(pointAt(samples, channel, second));
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Decimates one channel of a sample buffer.
+ * @param mode The decimation algorithm.
+ * @param samples The samples, oldest first.
+ * @param channel The position of the channel to plot.
+ * @param width The width of the plot area in pixels.
+ * @param points Receives the points to draw; previous contents are discarded.
+ *
+ * Buffers that already fit within the point budget of the chosen mode are
+ * passed through unchanged. LTTB keeps two points per pixel column, the same
+ * budget as min/max.
+ */
+void Decimator::decimate(Mode mode, const SampleBuffer &samples, int channel, int width, QVector<QPointF> &points)
+{
+    width = qMax(width, 2);
+    if (mode == Mode::None || samples.size() <= 2 * width) {
+        points.clear();
+        points.reserve(samples.size());
+        for (int i = 0; i < samples.size(); ++i) {
+            points.append(pointAt(samples, channel, i));
+        }
+    } else if (mode == Mode::MinMax) {
+        minMax(samples, channel, width, points);
+    } else {
+        lttb(samples, channel, 2 * width, points);
+    }
+}
+
+/**
+ * @brief Keeps the minimum and maximum of every pixel column.
+ * @param samples The samples, oldest first.
+ * @param channel The position of the channel to plot.
+ * @param width The number of pixel columns.
+ * @param points Receives at most 2 * width points.
+ *
+ * A single pass over the samples tracks the extremes of the current column
+ * and flushes them when the next column starts.
+ */
+void Decimator::minMax(const SampleBuffer &samples, int channel, int width, QVector<QPointF> &points)
+{
+    points.clear();
+    if (samples.isEmpty()) {
+        return;
+    }
+    points.reserve(2 * width);
+
+    const qint64 start = samples.firstTimestamp();
+    const double span = qMax(1.0, static_cast<double>(samples.lastTimestamp() - start));
+    const double columnsPerNs = (width - 1) / span;
+
+    int column = -1;
+    int minIndex = 0;
+    int maxIndex = 0;
+    for (int i = 0; i < samples.size(); ++i) {
+        const double value = samples.value(channel, i);
+        int sampleColumn = static_cast<int>((samples.timestamp(i) - start) * columnsPerNs);
+        if (sampleColumn != column) {
+            if (column >= 0) {
+                appendExtremes(samples, channel, minIndex, maxIndex, points);
+            }
+            column = sampleColumn;
+            minIndex = maxIndex = i;
+        } else if (value < samples.value(channel, minIndex)) {
+            minIndex = i;
+        } else if (value > samples.value(channel, maxIndex)) {
+            maxIndex = i;
+        }
+    }
+
+    appendExtremes(samples, channel, minIndex, maxIndex, points);
+}
+
+/**
+ * @brief Down-samples with the Largest-Triangle-Three-Buckets algorithm.
+ * @param samples The samples, oldest first.
+ * @param channel The position of the channel to plot.
+ * @param threshold The number of points to keep; at least 3.
+ * @param points Receives at most threshold points.
+ *
+ * The first and last samples are always kept. The samples in between are
+ * split into threshold - 2 buckets of equal size, and from each bucket the
+ * sample forming the largest triangle with the previously selected point and
+ * the average of the next bucket is kept. This preserves peaks and the shape
+ * of the curve much better than taking every n-th sample.
+ */
+void Decimator::lttb(const SampleBuffer &samples, int channel, int threshold, QVector<QPointF> &points)
+{
+    points.clear();
+    const int count = samples.size();
+    threshold = qMax(threshold, 3);
+    if (count <= threshold) {
+        points.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            points.append(pointAt(samples, channel, i));
+        }
+        return;
+    }
+    points.reserve(threshold);
+
+    const qint64 origin = samples.firstTimestamp(); // Keeps the times small enough to sum as doubles
+    const double bucketSize = static_cast<double>(count - 2) / (threshold - 2);
+    int selected = 0;
+    points.append(pointAt(samples, channel, 0));
+
+    for (int bucket = 0; bucket < threshold - 2; ++bucket) {
+        // Average of the next bucket (or the last sample for the final bucket)
+        int nextStart = static_cast<int>((bucket + 1) * bucketSize) + 1;
+        int nextEnd = qMin(static_cast<int>((bucket + 2) * bucketSize) + 1, count);
+        double averageX = 0;
+        double averageY = 0;
+        if (nextStart >= count - 1) {
+            averageX = samples.timestamp(count - 1) - origin;
+            averageY = samples.value(channel, count - 1);
+        } else {
+            for (int i = nextStart; i < nextEnd; ++i) {
+                averageX += samples.timestamp(i) - origin;
+                averageY += samples.value(channel, i);
+            }
+            averageX /= (nextEnd - nextStart);
+            averageY /= (nextEnd - nextStart);
+        }
+
+        // Point of the current bucket with the largest triangle area
+        int start = static_cast<int>(bucket * bucketSize) + 1;
+        int end = qMin(static_cast<int>((bucket + 1) * bucketSize) + 1, count - 1);
+        const double ax = samples.timestamp(selected) - origin;
+        const double ay = samples.value(channel, selected);
+        double maxArea = -1;
+        int best = start;
+        for (int i = start; i < end; ++i) {
+            double area = std::fabs((ax - averageX) * (samples.value(channel, i) - ay)
+                                    - (ax - (samples.timestamp(i) - origin)) * (averageY - ay));
+            if (area > maxArea) {
+                maxArea = area;
+                best = i;
+            }
+        }
+
+        selected = best;
+        points.append(pointAt(samples, channel, selected));
+    }
+
+    points.append(pointAt(samples, channel, count - 1));
+}
@@ -0,0 +1,176 @@
+#include "FilterChain.h"
+#include <QRegularExpression>
+#include <QtMath>
+#include <QtNumeric>
+#include <QStringList>
+
+namespace {
+
+/**
+ * @brief Parses the numeric parameters of a stage.
+ * @param arguments The parameters as text.
+ * @param minimum The number of required parameters.
+ * @param maximum The number of allowed parameters.
+ * @param values Receives the numbers.
+ * @return True if the number of parameters is right and all are finite numbers.
+ */
+bool parseNumbers(const QStringList &arguments, int minimum, int maximum, QVector<double> &values)
+{
+    if (arguments.size() < minimum || arguments.size() > maximum) {
+        return false;
+    }
+    for (const QString &argument : arguments) {
+        bool ok;
+        values.append(argument.toDouble(&ok));
+        if (!ok || !qIsFinite(values.last())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Checks the parameters of a low-pass filter.
+ * @param values The cut-off frequency, the sample rate and optionally one more parameter.
+ * @return True if the cut-off lies strictly between 0 and half the sample rate.
+ */
+bool isValidLowPass(const QVector<double> &values)
+{
+    return values[1] > 0 && values[0] > 0 && values[0] < values[1] / 2;
+}
+
+} // namespace
+
+/**
+ * @brief Constructs an empty chain, which leaves samples unchanged.
+ */
+FilterChain::FilterChain()
+{
+}
+
+/**
+ * @brief Replaces the filters by the ones described by a text.
+ * @param description The stages; an empty text removes all filters.
+ * @param schema The channels of the samples, used to resolve channel names.
+ * @param error Receives a description of the first problem, if not null.
+ * @return True if the text was valid; otherwise the chain is left unchanged.
+ *
+ * Filter and channel names are not case sensitive. Parameters must be
+ * finite and in range; in particular, low-pass cut-offs must lie strictly
+ * between 0 and half the sample rate, since outside of it the filters
+ * would not pass anything or would turn every value into NaN.
+ */
+bool FilterChain::configure(const QString &description, const ChannelSchema &schema, QString *error)
+{
+    static const QRegularExpression stagePattern("^(\\w+)\\s*\\(([^)]*)\\)\\s*(?:@(.*))?$");
+    const int channelCount = schema.channelCount();
+    const quint32 allChannels = channelCount >= 32 ? 0xffffffffu : (1u << channelCount) - 1;
+
+    std::vector<std::unique_ptr<SignalFilter>> parsed;
+    auto fail = [error](const QString &message) {
+        if (error) {
+            *error = message;
+        }
+        return false;
+    };
+
+    for (const QString &text : description.split(';', Qt::SkipEmptyParts)) {
+        const QString stage = text.trimmed();
+        if (stage.isEmpty()) {
+            continue;
+        }
+        QRegularExpressionMatch match = stagePattern.match(stage);
+        if (!match.hasMatch()) {
+            return fail(QString("Cannot parse filter \"%1\"").arg(stage));
+        }
+        const QString kind = match.captured(1).toLower();
+        QStringList arguments;
+        for (const QString &argument : match.captured(2).split(',', Qt::SkipEmptyParts)) {
+            arguments.append(argument.trimmed());
+        }
+
+        quint32 channels = allChannels;
+        int channelsNamed = 0;
+        const QString channelList = match.captured(3).trimmed();
+        if (!channelList.isEmpty()) {
+            channels = 0;
+            for (const QString &name : channelList.split('|', Qt::SkipEmptyParts)) {
+                const int channel = schema.indexOf(name.trimmed());
+                if (channel < 0) {
+                    return fail(QString("Unknown channel \"%1\" in filter \"%2\"").arg(name.trimmed(), stage));
+                }
+                channels |= 1u << channel;
+                ++channelsNamed;
+            }
+        }
+
+        QVector<double> values;
+        if (kind == "average" && parseNumbers(arguments, 1, 1, values)
+            && values[0] >= 1 && values[0] <= MovingAverageFilter::MaxLength) {
+            parsed.emplace_back(new MovingAverageFilter(channelCount, channels, qRound(values[0])));
+        } else if (kind == "median" && parseNumbers(arguments, 1, 1, values)
+                   && values[0] >= 1 && values[0] <= MedianFilter::MaxLength) {
+            parsed.emplace_back(new MedianFilter(channelCount, channels, qRound(values[0])));
+        } else if (kind == "fir" && parseNumbers(arguments, 2, 3, values) && isValidLowPass(values)
+                   && (values.size() < 3 || (values[2] >= 1 && values[2] <= FirFilter::MaxTaps))) {
+            const int taps = values.size() > 2 ? qRound(values[2]) : 31;
+            parsed.emplace_back(new FirFilter(channelCount, channels, FirFilter::lowPass(values[0], values[1], taps)));
+        } else if (kind == "lowpass" && parseNumbers(arguments, 2, 3, values) && isValidLowPass(values)
+                   && (values.size() < 3 || values[2] > 0)) {
+            const double q = values.size() > 2 ? values[2] : M_SQRT1_2;
+            parsed.emplace_back(BiquadFilter::lowPass(channelCount, channels, values[0], values[1], q));
+        } else if (kind == "kalman" && parseNumbers(arguments, 2, 2, values) && values[0] >= 0 && values[1] > 0) {
+            parsed.emplace_back(new KalmanFilter(channelCount, channels, values[0], values[1]));
+        } else if (kind == "complementary" && arguments.size() == 2 && channelsNamed == 1
+                   && parseNumbers(arguments.mid(0, 1), 1, 1, values) && values[0] >= 0) {
+            const int rateChannel = schema.indexOf(arguments[1]);
+            if (rateChannel < 0) {
+                return fail(QString("Unknown channel \"%1\" in filter \"%2\"").arg(arguments[1], stage));
+            }
+            int angleChannel = 0;
+            while (!((channels >> angleChannel) & 1)) {
+                ++angleChannel;
+            }
+            parsed.emplace_back(new ComplementaryFilter(channelCount, angleChannel, rateChannel, values[0]));
+        } else {
+            return fail(QString("Invalid filter \"%1\"").arg(stage));
+        }
+    }
+
+    filters = std::move(parsed);
+    return true;
+}
+
+/**
+ * @brief Forgets all past samples, e.g. after a port is reopened.
+ */
+void FilterChain::reset()
+{
+    for (const std::unique_ptr<SignalFilter> &filter : filters) {
+        filter->reset();
+    }
+}
+
+/**
+ * @brief Runs samples through all filters in place.
+ * @param samples The samples, oldest first.
+ * @param count The number of samples.
+ *
+ * Each filter processes the whole block before the next one starts, so
+ * its state stays in cache while it runs.
+ */
+void FilterChain::process(Sample *samples, int count)
+{
+    for (const std::unique_ptr<SignalFilter> &filter : filters) {
+        filter->process(samples, count);
+    }
+}
+
+/**
+ * @brief Checks if the chain has filters.
+ * @return True if samples pass unchanged.
+ */
+bool FilterChain::isEmpty() const
+{
+    return filters.empty();
+}
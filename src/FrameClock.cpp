@@ -0,0 +1,201 @@
+#include "FrameClock.h"
+#include "SampleClock.h"
+#include <QEvent>
+#include <QScreen>
+
+const qint64 FrameClock::DefaultInterval;
+
+/**
+ * @brief Constructs an idle FrameClock without a window.
+ * @param parent The parent object.
+ */
+FrameClock::FrameClock(QObject *parent)
+    : QObject(parent)
+    , interval(DefaultInterval)
+    , lastFrame(0)
+    , requestTime(0)
+    , updateLatency(0)
+    , framePending(false)
+    , updateRequested(false)
+    , continuous(false)
+    , frameCount(0)
+    , droppedFrames(0)
+{
+    holdTimer.setSingleShot(true);
+    holdTimer.setTimerType(Qt::PreciseTimer);
+    connect(&holdTimer, &QTimer::timeout, this, [this]() {
+        if (!window) {
+            deliver();
+        } else if (isVisible()) {
+            updateRequested = true;
+            requestTime = SampleClock::now();
+            window->requestUpdate();
+        }
+    });
+}
+
+/**
+ * @brief Sets the window that frames are paced to.
+ * @param window The window; without one, a timer at the default refresh rate paces the frames.
+ *
+ * The refresh interval follows the window when it moves to another screen.
+ */
+void FrameClock::setWindow(QWindow *window)
+{
+    if (this->window) {
+        this->window->removeEventFilter(this);
+        disconnect(this->window, nullptr, this, nullptr);
+    }
+    this->window = window;
+    updateRequested = false;
+    if (window) {
+        window->installEventFilter(this);
+        connect(window, &QWindow::screenChanged, this, &FrameClock::updateInterval);
+    }
+    updateInterval();
+    schedule();
+}
+
+/**
+ * @brief Gets the refresh rate frames are paced to.
+ * @return The frames per second.
+ */
+double FrameClock::getRefreshRate() const
+{
+    return 1e9 / interval;
+}
+
+/**
+ * @brief Gets the number of frames delivered.
+ * @return The number of frames.
+ */
+quint64 FrameClock::getFrameCount() const
+{
+    return frameCount;
+}
+
+/**
+ * @brief Gets the number of refresh intervals missed between requested frames.
+ * @return The number of frames.
+ */
+quint64 FrameClock::getDroppedFrames() const
+{
+    return droppedFrames;
+}
+
+/**
+ * @brief Gets the deviation of consecutive frames from the refresh interval.
+ * @return A snapshot of the deviations in nanoseconds.
+ */
+HistogramSnapshot FrameClock::getFrameJitter() const
+{
+    return frameJitter.snapshot();
+}
+
+/**
+ * @brief Requests that frame() is emitted on the next display refresh.
+ *
+ * Any number of requests before the frame result in a single frame. A
+ * request made while handling frame() asks for the frame after it.
+ */
+void FrameClock::requestFrame()
+{
+    framePending = true;
+    schedule();
+}
+
+/**
+ * @brief Watches the window for update requests and exposure changes.
+ * @param watched The object that received the event.
+ * @param event The event.
+ * @return Always false, so the window still handles the event.
+ *
+ * When the window is exposed again after being minimised or hidden, the
+ * gap is not counted as dropped frames, and a pending frame is scheduled.
+ */
+bool FrameClock::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == window) {
+        if (event->type() == QEvent::UpdateRequest && updateRequested) {
+            updateRequested = false;
+            const qint64 latency = SampleClock::now() - requestTime;
+            updateLatency += (qMin(latency, interval) - updateLatency) / 8;
+            deliver();
+        } else if (event->type() == QEvent::Expose && window->isExposed()) {
+            updateRequested = false; // A request made while hidden may never be answered
+            continuous = false;
+            schedule();
+        }
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+/**
+ * @brief Asks for the next frame if one is pending and the window is visible.
+ *
+ * The update is requested so that it arrives one refresh interval after
+ * the previous frame, taking the measured delivery time into account; if
+ * that is still ahead, the hold timer waits for it first.
+ */
+void FrameClock::schedule()
+{
+    if (!framePending || updateRequested || holdTimer.isActive() || !isVisible()) {
+        return;
+    }
+    const qint64 wait = lastFrame == 0 ? 0 : lastFrame + interval - updateLatency - SampleClock::now();
+    if (wait > 0 || !window) {
+        holdTimer.start(static_cast<int>(qMax<qint64>(wait, 0) / 1000000));
+        return;
+    }
+    updateRequested = true;
+    requestTime = SampleClock::now();
+    window->requestUpdate();
+}
+
+/**
+ * @brief Emits frame() and updates the statistics.
+ *
+ * A gap to the previous frame only counts if that frame already requested
+ * this one; gaps while idle are expected.
+ */
+void FrameClock::deliver()
+{
+    const qint64 now = SampleClock::now();
+    if (continuous && lastFrame != 0) {
+        const qint64 gap = now - lastFrame;
+        frameJitter.record(static_cast<quint64>(qAbs(gap - interval)));
+        if (gap > interval * 3 / 2) {
+            droppedFrames += static_cast<quint64>((gap + interval / 2) / interval - 1);
+        }
+    }
+    lastFrame = now;
+    framePending = false;
+    ++frameCount;
+
+    emit frame();
+
+    continuous = framePending;
+    schedule();
+}
+
+/**
+ * @brief Takes the refresh interval from the screen of the window.
+ */
+void FrameClock::updateInterval()
+{
+    const double rate = window && window->screen() ? window->screen()->refreshRate() : 0;
+    interval = rate >= 1 ? static_cast<qint64>(1e9 / rate) : DefaultInterval;
+    updateLatency = qMin(updateLatency, interval);
+}
+
+/**
+ * @brief Checks if frames can be shown.
+ * @return False while the window is minimised, hidden or not exposed.
+ */
+bool FrameClock::isVisible() const
+{
+    if (!window) {
+        return true;
+    }
+    return window->isExposed() && window->visibility() != QWindow::Minimized && window->visibility() != QWindow::Hidden;
+}
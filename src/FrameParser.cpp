@@ -0,0 +1,637 @@
+#include "FrameParser.h"
+#include "Cobs.h"
+#include "Crc16.h"
+#include <cmath>
+#include <cstring>
+
+const std::size_t Frame::MaxChannels;
+const std::size_t FrameParser::Capacity;
+const std::size_t FrameParser::MaxLineLength;
+const std::size_t FrameParser::MaxPacketLength;
+const std::size_t FrameParser::SequenceHeaderLength;
+const int FrameParser::ResyncErrors;
+
+namespace {
+
+/**
+ * @brief Checks whether a byte is whitespace in the sense of QString::trimmed().
+ * @param c The byte to check.
+ * @return True for space, tab, newline, vertical tab, form feed and carriage return.
+ */
+inline bool isSpace(char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+/**
+ * @brief Exact powers of ten representable as doubles.
+ */
+const double powersOfTen[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/**
+ * @brief Reads a little-endian 32-bit unsigned integer.
+ * @param p The first byte.
+ * @return The value.
+ */
+inline uint32_t readUint32(const unsigned char *p)
+{
+    return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8
+         | static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24;
+}
+
+/**
+ * @brief Writes a little-endian 32-bit unsigned integer.
+ * @param p The first byte to write.
+ * @param value The value.
+ */
+inline void writeUint32(char *p, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i) {
+        p[i] = static_cast<char>(value >> (8 * i));
+    }
+}
+
+/**
+ * @brief Reads a little-endian 32-bit float.
+ * @param p The first byte.
+ * @return The value.
+ */
+inline float readFloat(const unsigned char *p)
+{
+    uint32_t bits = readUint32(p);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Writes a little-endian 32-bit float.
+ * @param p The first byte to write.
+ * @param value The value.
+ */
+inline void writeFloat(char *p, float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeUint32(p, bits);
+}
+
+/**
+ * @brief Parses a decimal 32-bit unsigned integer.
+ * @param begin The first byte of the number.
+ * @param end One past the last byte of the number.
+ * @param value Receives the parsed value on success.
+ * @return True if the whole range is a valid 32-bit number, false otherwise.
+ */
+bool parseUint32(const char *begin, const char *end, uint32_t &value)
+{
+    if (begin == end) {
+        return false;
+    }
+    uint64_t result = 0;
+    for (const char *p = begin; p < end; ++p) {
+        if (*p < '0' || *p > '9') {
+            return false;
+        }
+        result = result * 10 + static_cast<uint64_t>(*p - '0');
+        if (result > 0xFFFFFFFFu) {
+            return false;
+        }
+    }
+    value = static_cast<uint32_t>(result);
+    return true;
+}
+
+/**
+ * @brief Reads a little-endian 16-bit signed integer.
+ * @param p The first byte.
+ * @return The value.
+ */
+inline int16_t readInt16(const unsigned char *p)
+{
+    return static_cast<int16_t>(static_cast<uint16_t>(p[0] | p[1] << 8));
+}
+
+} // namespace
+
+/**
+ * @brief Constructs an empty FrameParser.
+ */
+FrameParser::FrameParser()
+    : head(0), scan(0), tail(0), configured(Protocol::Auto), active(Protocol::Auto), errors(0)
+{
+}
+
+/**
+ * @brief Gets a pointer to the contiguous free region of the ring buffer.
+ * @param size Receives the number of bytes that may be written at the pointer.
+ * @return A pointer to the first free byte.
+ *
+ * The free region ends either at the physical end of the buffer or at the
+ * first unconsumed byte, whichever comes first. A caller that wants to fill
+ * the whole free space may need to call this twice around a commit().
+ */
+char *FrameParser::writeBuffer(std::size_t &size)
+{
+    std::size_t offset = tail & (Capacity - 1);
+    std::size_t free = Capacity - (tail - head);
+    size = Capacity - offset < free ? Capacity - offset : free;
+    return buffer + offset;
+}
+
+/**
+ * @brief Marks bytes written through writeBuffer() as available for parsing.
+ * @param size The number of bytes written.
+ */
+void FrameParser::commit(std::size_t size)
+{
+    tail += size;
+}
+
+/**
+ * @brief Copies bytes into the ring buffer.
+ * @param data The bytes to append.
+ * @param size The number of bytes to append.
+ * @return The number of bytes accepted, which may be less than size if the buffer is full.
+ */
+std::size_t FrameParser::write(const char *data, std::size_t size)
+{
+    std::size_t written = 0;
+    while (written < size) {
+        std::size_t chunk;
+        char *target = writeBuffer(chunk);
+        if (chunk == 0) {
+            break; // Buffer is full
+        }
+        if (chunk > size - written) {
+            chunk = size - written;
+        }
+        std::memcpy(target, data + written, chunk);
+        commit(chunk);
+        written += chunk;
+    }
+    return written;
+}
+
+/**
+ * @brief Decodes the next complete frame from the ring buffer.
+ * @param frame Receives the decoded frame when Status::Frame is returned.
+ * @return The outcome of the attempt.
+ *
+ * Scanning resumes where the previous call stopped, so bytes are never
+ * inspected twice for a terminator. Depending on the active format, a zero
+ * byte ends a binary packet and "\n\r" ends a text line; while the format is
+ * still being detected, both are looked for. A complete line or packet is
+ * copied into a stack buffer (which also takes care of data wrapping around
+ * the end of the ring) and decoded. Anything longer than MaxLineLength cannot
+ * be a valid frame; it is dropped and Status::Overflow is reported so that
+ * the parser resynchronises on the next terminator.
+ */
+FrameParser::Status FrameParser::next(Frame &frame)
+{
+    while (scan < tail) {
+        char c = at(scan);
+
+        if (c == '\0' && active != Protocol::Text) {
+            std::size_t length = scan - head;
+            std::size_t start = head;
+            head = scan + 1; // Consume the packet together with its delimiter
+            scan = head;
+
+            if (length == 0) {
+                continue; // Back-to-back delimiters carry no packet
+            }
+            if (length > MaxLineLength) {
+                return track(Status::Overflow, Protocol::Binary);
+            }
+
+            char packet[MaxLineLength];
+            copyOut(start, length, packet);
+            return track(parsePacket(packet, length, frame), Protocol::Binary);
+        }
+
+        if (c == '\n' && active != Protocol::Binary) {
+            if (scan + 1 == tail) {
+                break; // The second byte of the terminator has not arrived yet
+            }
+            if (at(scan + 1) == '\r') {
+                std::size_t length = scan - head;
+                std::size_t start = head;
+                head = scan + 2; // Consume the line together with its terminator
+                scan = head;
+
+                if (length > MaxLineLength) {
+                    return track(Status::Overflow, Protocol::Text);
+                }
+
+                char line[MaxLineLength];
+                copyOut(start, length, line);
+                return track(parseLine(line, length, frame), Protocol::Text);
+            }
+        }
+
+        ++scan;
+        if (scan - head > MaxLineLength + 1) {
+            // No terminator in sight: drop everything but the byte under the cursor
+            head = scan;
+            return track(Status::Overflow, active);
+        }
+    }
+    return Status::NeedMoreData;
+}
+
+/**
+ * @brief Discards all buffered bytes and restarts format detection.
+ */
+void FrameParser::reset()
+{
+    head = scan = tail = 0;
+    active = configured;
+    errors = 0;
+}
+
+/**
+ * @brief Sets the expected wire format.
+ * @param protocol The format, or Protocol::Auto to detect it from the stream.
+ *
+ * A fixed format is never changed by the parser; bytes that belong to the
+ * other format are reported as bad frames.
+ */
+void FrameParser::setProtocol(Protocol protocol)
+{
+    configured = protocol;
+    active = protocol;
+    errors = 0;
+}
+
+/**
+ * @brief Gets the expected wire format.
+ * @return The format passed to setProtocol(), Protocol::Auto by default.
+ */
+FrameParser::Protocol FrameParser::protocol() const
+{
+    return configured;
+}
+
+/**
+ * @brief Gets the wire format currently being decoded.
+ * @return The configured format, the detected format, or Protocol::Auto while detection is pending.
+ */
+FrameParser::Protocol FrameParser::activeProtocol() const
+{
+    return active;
+}
+
+/**
+ * @brief Gets the number of buffered bytes that have not been consumed yet.
+ * @return The number of buffered bytes.
+ */
+std::size_t FrameParser::available() const
+{
+    return tail - head;
+}
+
+/**
+ * @brief Parses a single line without its "\n\r" terminator.
+ * @param line The first byte of the line.
+ * @param length The length of the line in bytes.
+ * @param frame Receives the decoded frame on success.
+ * @return Status::Frame on success, otherwise the reason for rejection.
+ *
+ * The line is trimmed and split at its last space into a data part and a
+ * hexadecimal CRC. The CRC is verified over the data part, which must then
+ * consist of one to Frame::MaxChannels space-separated values; the first
+ * character of the first value (the 'b' marker) is skipped. With the 's'
+ * marker, the values are preceded by the device's sequence number and
+ * sampling time in microseconds.
+ */
+FrameParser::Status FrameParser::parseLine(const char *line, std::size_t length, Frame &frame)
+{
+    const char *begin = line;
+    const char *end = line + length;
+    while (begin < end && isSpace(*begin)) {
+        ++begin;
+    }
+    while (end > begin && isSpace(end[-1])) {
+        --end;
+    }
+
+    const char *crcSeparator = end;
+    while (crcSeparator > begin && crcSeparator[-1] != ' ') {
+        --crcSeparator;
+    }
+    if (crcSeparator == begin) {
+        return Status::InvalidFormat; // No space separating data and CRC
+    }
+    const char *dataEnd = crcSeparator - 1;
+
+    uint16_t receivedCrc;
+    if (!parseHex16(crcSeparator, end, receivedCrc)) {
+        return Status::InvalidCrc;
+    }
+    if (Crc16::compute(begin, static_cast<std::size_t>(dataEnd - begin)) != receivedCrc) {
+        return Status::CrcMismatch;
+    }
+
+    if (dataEnd - begin < 2) {
+        return Status::InvalidFormat; // Missing the 'b' marker or the values
+    }
+
+    const char *value = begin + 1;
+    frame.sequenced = *begin == 's';
+    if (frame.sequenced) {
+        uint32_t *fields[] = { &frame.sequence, &frame.deviceTime };
+        for (uint32_t *field : fields) {
+            const char *separator = static_cast<const char *>(
+                std::memchr(value, ' ', static_cast<std::size_t>(dataEnd - value)));
+            if (separator == nullptr || !parseUint32(value, separator, *field)) {
+                return Status::InvalidFormat; // Header incomplete or no values after it
+            }
+            value = separator + 1;
+        }
+    }
+
+    std::size_t count = 0;
+    for (;;) {
+        const char *separator = static_cast<const char *>(
+            std::memchr(value, ' ', static_cast<std::size_t>(dataEnd - value)));
+        if (separator == nullptr) {
+            separator = dataEnd;
+        }
+        if (count == Frame::MaxChannels || !parseDouble(value, separator, frame.values[count])) {
+            return Status::InvalidFormat;
+        }
+        ++count;
+        if (separator == dataEnd) {
+            break;
+        }
+        value = separator + 1;
+    }
+    frame.channelCount = count;
+    return Status::Frame;
+}
+
+/**
+ * @brief Parses a single COBS-encoded packet without its zero delimiter.
+ * @param packet The first encoded byte.
+ * @param length The number of encoded bytes, at most MaxLineLength.
+ * @param frame Receives the decoded frame on success.
+ * @return Status::Frame on success, otherwise the reason for rejection.
+ *
+ * The packet is decoded, the trailing little-endian CRC is verified over
+ * the type byte and the values, and the values are read according to the
+ * type byte. If the type byte has SequencedFlag set, the device's sequence
+ * number and sampling time come before the values. The number of values is
+ * derived from the packet length.
+ */
+FrameParser::Status FrameParser::parsePacket(const char *packet, std::size_t length, Frame &frame)
+{
+    char decoded[MaxLineLength];
+    std::size_t size;
+    if (!Cobs::decode(packet, length, decoded, size) || size < 3) {
+        return Status::InvalidFormat;
+    }
+
+    std::size_t dataLength = size - 2;
+    const unsigned char *data = reinterpret_cast<const unsigned char *>(decoded);
+    uint16_t receivedCrc = static_cast<uint16_t>(data[dataLength] | data[dataLength + 1] << 8);
+    if (Crc16::compute(decoded, dataLength) != receivedCrc) {
+        return Status::CrcMismatch;
+    }
+
+    const unsigned char *values = data + 1;
+    std::size_t valuesLength = dataLength - 1;
+    frame.sequenced = (data[0] & SequencedFlag) != 0;
+    if (frame.sequenced) {
+        if (valuesLength < SequenceHeaderLength) {
+            return Status::InvalidFormat;
+        }
+        frame.sequence = readUint32(values);
+        frame.deviceTime = readUint32(values + 4);
+        values += SequenceHeaderLength;
+        valuesLength -= SequenceHeaderLength;
+    }
+
+    switch (data[0] & ~SequencedFlag) {
+    case FloatPacket:
+        if (valuesLength == 0 || valuesLength % 4 != 0 || valuesLength / 4 > Frame::MaxChannels) {
+            return Status::InvalidFormat;
+        }
+        frame.channelCount = valuesLength / 4;
+        for (std::size_t i = 0; i < frame.channelCount; ++i) {
+            frame.values[i] = readFloat(values + 4 * i);
+        }
+        return Status::Frame;
+    case FixedPacket:
+        if (valuesLength == 0 || valuesLength % 2 != 0 || valuesLength / 2 > Frame::MaxChannels) {
+            return Status::InvalidFormat;
+        }
+        frame.channelCount = valuesLength / 2;
+        for (std::size_t i = 0; i < frame.channelCount; ++i) {
+            frame.values[i] = readInt16(values + 2 * i) / 100.0;
+        }
+        return Status::Frame;
+    default:
+        return Status::InvalidFormat; // Unknown packet type
+    }
+}
+
+/**
+ * @brief Encodes a frame as a binary float packet.
+ * @param frame The frame to encode.
+ * @param out Receives the packet including its delimiter; must hold MaxPacketLength bytes.
+ * @return The number of bytes written.
+ *
+ * This is the sender side of parsePacket(), for simulators and tests. The
+ * sequence number and device time are included if the frame is sequenced.
+ */
+std::size_t FrameParser::encodePacket(const Frame &frame, char *out)
+{
+    char payload[1 + SequenceHeaderLength + 4 * Frame::MaxChannels + 2];
+    std::size_t count = frame.channelCount < Frame::MaxChannels ? frame.channelCount : Frame::MaxChannels;
+    std::size_t length = 1;
+
+    payload[0] = static_cast<char>(frame.sequenced ? FloatPacket | SequencedFlag : FloatPacket);
+    if (frame.sequenced) {
+        writeUint32(payload + length, frame.sequence);
+        writeUint32(payload + length + 4, frame.deviceTime);
+        length += SequenceHeaderLength;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        writeFloat(payload + length, static_cast<float>(frame.values[i]));
+        length += 4;
+    }
+    uint16_t crc = Crc16::compute(payload, length);
+    payload[length++] = static_cast<char>(crc & 0xFF);
+    payload[length++] = static_cast<char>(crc >> 8);
+
+    std::size_t encoded = Cobs::encode(payload, length, out);
+    out[encoded++] = 0; // Delimiter
+    return encoded;
+}
+
+/**
+ * @brief Parses a decimal floating point number.
+ * @param begin The first byte of the number.
+ * @param end One past the last byte of the number.
+ * @param value Receives the parsed value on success.
+ * @return True if the whole range is a valid number, false otherwise.
+ *
+ * Accepts an optional sign, digits with an optional decimal point and an
+ * optional exponent. Up to 19 significant digits are accumulated in an
+ * integer and scaled once by an exact power of ten, which is exact for the
+ * short fixed-point values sent by the sensor board and independent of the
+ * C locale.
+ */
+bool FrameParser::parseDouble(const char *begin, const char *end, double &value)
+{
+    const char *p = begin;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    int significantDigits = 0;
+    bool anyDigits = false;
+
+    for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+        anyDigits = true;
+        if (significantDigits < 19) {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+            if (mantissa != 0) {
+                ++significantDigits;
+            }
+        } else {
+            ++exponent; // Digit beyond precision only scales the value
+        }
+    }
+    if (p < end && *p == '.') {
+        ++p;
+        for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+            anyDigits = true;
+            if (significantDigits < 19) {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+                --exponent;
+                if (mantissa != 0) {
+                    ++significantDigits;
+                }
+            }
+        }
+    }
+    if (!anyDigits) {
+        return false;
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        bool negativeExponent = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            negativeExponent = (*p == '-');
+            ++p;
+        }
+        if (p == end) {
+            return false;
+        }
+        int explicitExponent = 0;
+        for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+            if (explicitExponent < 10000) {
+                explicitExponent = explicitExponent * 10 + (*p - '0');
+            }
+        }
+        exponent += negativeExponent ? -explicitExponent : explicitExponent;
+    }
+    if (p != end) {
+        return false; // Trailing garbage
+    }
+
+    double result = static_cast<double>(mantissa);
+    if (exponent < 0) {
+        result = -exponent <= 22 ? result / powersOfTen[-exponent] : result / std::pow(10.0, -exponent);
+    } else if (exponent > 0) {
+        result = exponent <= 22 ? result * powersOfTen[exponent] : result * std::pow(10.0, exponent);
+    }
+    value = negative ? -result : result;
+    return true;
+}
+
+/**
+ * @brief Parses a 16-bit hexadecimal number with an optional "0x" prefix.
+ * @param begin The first byte of the number.
+ * @param end One past the last byte of the number.
+ * @param value Receives the parsed value on success.
+ * @return True if the whole range is a valid 16-bit number, false otherwise.
+ */
+bool FrameParser::parseHex16(const char *begin, const char *end, uint16_t &value)
+{
+    const char *p = begin;
+    if (end - p > 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+        p += 2;
+    }
+    if (p == end) {
+        return false;
+    }
+
+    uint32_t result = 0;
+    for (; p < end; ++p) {
+        uint32_t digit;
+        if (*p >= '0' && *p <= '9') {
+            digit = static_cast<uint32_t>(*p - '0');
+        } else if (*p >= 'a' && *p <= 'f') {
+            digit = static_cast<uint32_t>(*p - 'a' + 10);
+        } else if (*p >= 'A' && *p <= 'F') {
+            digit = static_cast<uint32_t>(*p - 'A' + 10);
+        } else {
+            return false;
+        }
+        result = (result << 4) | digit;
+        if (result > 0xFFFF) {
+            return false;
+        }
+    }
+    value = static_cast<uint16_t>(result);
+    return true;
+}
+
+/**
+ * @brief Copies a consumed line or packet out of the ring buffer.
+ * @param start The stream offset of its first byte.
+ * @param length Its length in bytes, at most MaxLineLength.
+ * @param out Receives the bytes.
+ */
+void FrameParser::copyOut(std::size_t start, std::size_t length, char *out) const
+{
+    std::size_t offset = start & (Capacity - 1);
+    std::size_t first = Capacity - offset < length ? Capacity - offset : length;
+    std::memcpy(out, buffer + offset, first);
+    std::memcpy(out + first, buffer, length - first);
+}
+
+/**
+ * @brief Updates format detection with the outcome of a decoded line or packet.
+ * @param status The outcome.
+ * @param protocol The format the line or packet was decoded as.
+ * @return The outcome, unchanged.
+ *
+ * A valid frame fixes the format if it was still being detected. While
+ * detecting automatically, ResyncErrors bad frames in a row release the
+ * format again.
+ */
+FrameParser::Status FrameParser::track(Status status, Protocol protocol)
+{
+    if (status == Status::Frame) {
+        errors = 0;
+        if (active == Protocol::Auto) {
+            active = protocol;
+        }
+    } else if (configured == Protocol::Auto && active != Protocol::Auto && ++errors >= ResyncErrors) {
+        active = Protocol::Auto;
+        errors = 0;
+    }
+    return status;
+}
@@ -0,0 +1,147 @@
+#include "FrameTimestamper.h"
+
+const qint64 FrameTimestamper::MaxFramePeriod;
+const qint64 FrameTimestamper::MaxSequenceGap;
+const qint64 FrameTimestamper::MaxDriftPpm;
+
+/**
+ * @brief Constructs a FrameTimestamper with no history.
+ */
+FrameTimestamper::FrameTimestamper()
+    : lastStamp(0), lost(0)
+{
+    reset();
+}
+
+/**
+ * @brief Forgets the frame period, the device clock offset and the last sequence number.
+ *
+ * Call this when the port is reopened. Timestamps still never go back
+ * behind the ones already handed out, and the lost frame count is kept.
+ */
+void FrameTimestamper::reset()
+{
+    lastRead = -1;
+    period = 0;
+    lastSequence = -1;
+    lastDeviceTime = -1;
+    deviceElapsed = 0;
+    deviceOffset = 0;
+}
+
+/**
+ * @brief Stamps the frames delivered by one read.
+ * @param samples The frames in the order they were received; timestamp and readTime are set.
+ * @param count The number of frames.
+ * @param readTime The time the read returned, in nanoseconds on the SampleClock.
+ *
+ * The last frame of the read is taken to have been sampled at the read
+ * time and the others one frame period apart before it. Frames lost from
+ * the sequence keep their slot. The spacing is never wider than the time
+ * since the previous read allows, so consecutive reads do not overlap. The
+ * frame period is updated from the time between reads, ignoring gaps that
+ * are too long to be continuous streaming. A read with more frames than
+ * fit into one call is stamped in several calls with the same read time;
+ * the later parts keep the frame period and follow the frames stamped
+ * before them instead of piling up on the read time. Frames with a device
+ * time are stamped from it instead.
+ */
+void FrameTimestamper::stamp(Sample *samples, int count, qint64 readTime)
+{
+    if (count <= 0) {
+        return;
+    }
+
+    // Slot of each frame relative to the first one, counting lost frames
+    qint64 slot = 0;
+    qint64 gapBefore = 0; // Slots lost between the previous read and this one
+    for (int i = 0; i < count; ++i) {
+        qint64 gap = 0;
+        if (samples[i].sequence >= 0) {
+            if (lastSequence >= 0) {
+                gap = static_cast<quint32>(samples[i].sequence - lastSequence - 1);
+                if (gap >= MaxSequenceGap) {
+                    gap = 0; // Device restarted or a different device
+                }
+                lost += static_cast<quint64>(gap);
+            }
+            lastSequence = samples[i].sequence;
+        }
+        if (i == 0) {
+            gapBefore = gap;
+        } else {
+            slot += 1 + gap;
+        }
+        samples[i].timestamp = slot; // Holds the slot until the frame is stamped
+    }
+
+    qint64 spacing = period;
+    if (lastRead >= 0 && readTime > lastRead) {
+        qint64 observed = (readTime - lastRead) / (slot + 1 + gapBefore);
+        if (period == 0 ? observed < MaxFramePeriod : observed < 2 * period) {
+            period = period == 0 ? observed : period + (observed - period) / 8;
+        }
+        spacing = qMin(period, observed);
+    }
+
+    // The rest of a read whose first frames were stamped already continues after them
+    const qint64 end = qMax(readTime, lastStamp + (slot + 1 + gapBefore) * spacing);
+    for (int i = 0; i < count; ++i) {
+        Sample &sample = samples[i];
+        qint64 timestamp = sample.deviceTime >= 0 ? mapDeviceTime(sample.deviceTime, readTime)
+                                                  : end - (slot - sample.timestamp) * spacing;
+        lastStamp = qMax(lastStamp, timestamp);
+        sample.timestamp = lastStamp;
+        sample.readTime = readTime;
+    }
+    lastRead = readTime;
+}
+
+/**
+ * @brief Gets the estimated time between two frames.
+ * @return The period in nanoseconds, 0 if not known yet.
+ */
+qint64 FrameTimestamper::framePeriod() const
+{
+    return period;
+}
+
+/**
+ * @brief Gets the number of frames the device numbered but that never arrived.
+ * @return The number of lost frames since construction.
+ */
+quint64 FrameTimestamper::lostFrames() const
+{
+    return lost;
+}
+
+/**
+ * @brief Maps the device time of a frame onto the SampleClock.
+ * @param deviceTime The device time as sent, in microseconds.
+ * @param readTime The time the read returned.
+ * @return The sampling time in nanoseconds on the SampleClock.
+ *
+ * The 32-bit device time is unwrapped first. A frame can only have been
+ * sampled before it was read, so every frame bounds the offset from above,
+ * and the smallest bound is the best estimate. If the device time jumps
+ * back, the device has restarted and the mapping starts over.
+ */
+qint64 FrameTimestamper::mapDeviceTime(qint64 deviceTime, qint64 readTime)
+{
+    if (lastDeviceTime < 0) {
+        deviceElapsed = 0;
+        deviceOffset = readTime;
+    } else {
+        quint32 delta = static_cast<quint32>(deviceTime - lastDeviceTime);
+        if (delta >= 0x80000000u) {
+            deviceElapsed = 0; // Device clock went back
+            deviceOffset = readTime;
+        } else {
+            deviceElapsed += static_cast<qint64>(delta) * 1000;
+            deviceOffset += static_cast<qint64>(delta) * MaxDriftPpm / 1000; // Allowance for a slow device clock
+        }
+    }
+    lastDeviceTime = deviceTime;
+    deviceOffset = qMin(deviceOffset, readTime - deviceElapsed);
+    return deviceElapsed + deviceOffset;
+}
@@ -0,0 +1,177 @@
+#include "Histogram.h"
+#include <QtAlgorithms>
+#include <cstring>
+
+const int HistogramSnapshot::SubBucketBits;
+const int HistogramSnapshot::SubBuckets;
+const int HistogramSnapshot::BucketCount;
+
+/**
+ * @brief Constructs an empty snapshot.
+ */
+HistogramSnapshot::HistogramSnapshot()
+    : count(0), sum(0)
+{
+    std::memset(buckets, 0, sizeof(buckets));
+}
+
+/**
+ * @brief Gets the values recorded after an earlier snapshot.
+ * @param earlier An earlier snapshot of the same histogram.
+ * @return The difference of the two snapshots.
+ */
+HistogramSnapshot HistogramSnapshot::since(const HistogramSnapshot &earlier) const
+{
+    HistogramSnapshot result;
+    result.count = count - earlier.count;
+    result.sum = sum - earlier.sum;
+    for (int i = 0; i < BucketCount; ++i) {
+        result.buckets[i] = buckets[i] - earlier.buckets[i];
+    }
+    return result;
+}
+
+/**
+ * @brief Adds the counts of another snapshot.
+ * @param other The snapshot to add.
+ */
+void HistogramSnapshot::merge(const HistogramSnapshot &other)
+{
+    count += other.count;
+    sum += other.sum;
+    for (int i = 0; i < BucketCount; ++i) {
+        buckets[i] += other.buckets[i];
+    }
+}
+
+/**
+ * @brief Gets the average of the recorded values.
+ * @return The mean, 0 if there are none.
+ */
+double HistogramSnapshot::mean() const
+{
+    return count == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(count);
+}
+
+/**
+ * @brief Gets the value below which a given fraction of the recorded values lie.
+ * @param fraction The fraction, between 0 and 1.
+ * @return The middle of the bucket holding the percentile, 0 if there are no values.
+ */
+double HistogramSnapshot::percentile(double fraction) const
+{
+    if (count == 0) {
+        return 0.0;
+    }
+    quint64 rank = qMax<quint64>(1, static_cast<quint64>(qBound(0.0, fraction, 1.0) * static_cast<double>(count) + 0.5));
+    quint64 seen = 0;
+    for (int i = 0; i < BucketCount; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return (static_cast<double>(lowerBound(i)) + static_cast<double>(upperBound(i))) / 2;
+        }
+    }
+    return maximum(); // Counts taken while values were being recorded may not add up
+}
+
+/**
+ * @brief Gets the largest recorded value.
+ * @return The middle of the highest non-empty bucket, 0 if there are no values.
+ */
+double HistogramSnapshot::maximum() const
+{
+    for (int i = BucketCount - 1; i >= 0; --i) {
+        if (buckets[i] != 0) {
+            return (static_cast<double>(lowerBound(i)) + static_cast<double>(upperBound(i))) / 2;
+        }
+    }
+    return 0.0;
+}
+
+/**
+ * @brief Gets the bucket a value is counted in.
+ * @param value The value.
+ * @return The index of the bucket.
+ *
+ * Values below SubBuckets have a bucket each. Above, the position of the
+ * highest set bit selects the power of two and the next SubBucketBits bits
+ * the bucket within it.
+ */
+int HistogramSnapshot::bucketOf(quint64 value)
+{
+    if (value < static_cast<quint64>(SubBuckets)) {
+        return static_cast<int>(value);
+    }
+    int highestBit = 63 - static_cast<int>(qCountLeadingZeroBits(value));
+    int shift = highestBit - SubBucketBits;
+    int subBucket = static_cast<int>((value >> shift) & (SubBuckets - 1));
+    return (shift + 1) * SubBuckets + subBucket;
+}
+
+/**
+ * @brief Gets the smallest value counted in a bucket.
+ * @param bucket The index of the bucket.
+ * @return The lower bound.
+ */
+quint64 HistogramSnapshot::lowerBound(int bucket)
+{
+    if (bucket < SubBuckets) {
+        return static_cast<quint64>(bucket);
+    }
+    int shift = bucket / SubBuckets - 1;
+    return static_cast<quint64>(SubBuckets + bucket % SubBuckets) << shift;
+}
+
+/**
+ * @brief Gets the largest value counted in a bucket.
+ * @param bucket The index of the bucket.
+ * @return The upper bound.
+ */
+quint64 HistogramSnapshot::upperBound(int bucket)
+{
+    if (bucket < SubBuckets) {
+        return static_cast<quint64>(bucket);
+    }
+    int shift = bucket / SubBuckets - 1;
+    return lowerBound(bucket) + ((static_cast<quint64>(1) << shift) - 1);
+}
+
+/**
+ * @brief Constructs an empty Histogram.
+ */
+Histogram::Histogram()
+    : count(0), sum(0)
+{
+    for (std::atomic<quint64> &bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Records a value. May be called from any thread.
+ * @param value The value, e.g. a duration in nanoseconds.
+ */
+void Histogram::record(quint64 value)
+{
+    buckets[HistogramSnapshot::bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Copies the current counts. May be called from any thread.
+ * @return The snapshot.
+ *
+ * The counters are read one by one, so a snapshot taken while values are
+ * being recorded may be off by the values recorded meanwhile.
+ */
+HistogramSnapshot Histogram::snapshot() const
+{
+    HistogramSnapshot result;
+    result.count = count.load(std::memory_order_relaxed);
+    result.sum = sum.load(std::memory_order_relaxed);
+    for (int i = 0; i < HistogramSnapshot::BucketCount; ++i) {
+        result.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+    }
+    return result;
+}
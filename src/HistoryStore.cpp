@@ -0,0 +1,353 @@
+#include "HistoryStore.h"
+#include "SampleClock.h"
+#include <QtNumeric>
+
+namespace {
+
+/**
+ * @brief Bucket lengths of the summary levels in nanoseconds.
+ */
+const qint64 resolutions[HistoryStore::LevelCount] = { 0, 10000000, 100000000, 1000000000, 10000000000LL };
+
+/**
+ * @brief Starts a channel summary with a single value.
+ * @param summary The summary to initialise.
+ * @param value The first value.
+ * @param timestamp The time of the first value.
+ */
+void startChannel(ChannelSummary &summary, double value, qint64 timestamp)
+{
+    summary.min = summary.max = summary.mean = value;
+    summary.minTime = summary.maxTime = timestamp;
+}
+
+/**
+ * @brief Adds a value to an open channel summary.
+ * @param summary The summary to update; its mean holds the running sum.
+ * @param value The value to add.
+ * @param timestamp The time of the value.
+ */
+void addToChannel(ChannelSummary &summary, double value, qint64 timestamp)
+{
+    if (value < summary.min) {
+        summary.min = value;
+        summary.minTime = timestamp;
+    }
+    if (value > summary.max) {
+        summary.max = value;
+        summary.maxTime = timestamp;
+    }
+    summary.mean += value;
+}
+
+/**
+ * @brief Appends the extremes of a channel summary in the order they occurred.
+ * @param summary The summary.
+ * @param points The points to append to, with the times on the chart axis in milliseconds.
+ */
+void appendChannel(const ChannelSummary &summary, QVector<QPointF> &points)
+{
+    const QPointF min(SampleClock::toChartTime(summary.minTime), summary.min);
+    const QPointF max(SampleClock::toChartTime(summary.maxTime), summary.max);
+    if (summary.minTime == summary.maxTime) {
+        points.append(min);
+    } else if (summary.minTime < summary.maxTime) {
+        points.append(min);
+        points.append(max);
+    } else {
+        points.append(max);
+        points.append(min);
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Constructs an empty HistoryStore.
+ * @param channelCount The number of channels per sample.
+ * @param memoryBudget The maximum number of bytes to retain.
+ */
+HistoryStore::HistoryStore(int channelCount, qint64 memoryBudget)
+    : memoryBudget(memoryBudget), channels(0), newest(0)
+{
+    setChannelCount(channelCount);
+}
+
+/**
+ * @brief Removes all data and sets the number of channels per sample.
+ * @param channelCount The number of channels, at most ChannelSchema::MaxChannels.
+ */
+void HistoryStore::setChannelCount(int channelCount)
+{
+    channels = qBound(0, channelCount, ChannelSchema::MaxChannels);
+    rawValues.resize(channels);
+    for (int level = 1; level < LevelCount; ++level) {
+        summaries[level - 1].resize(channels);
+        openSummaries[level - 1].resize(channels);
+    }
+    clear();
+}
+
+/**
+ * @brief Gets the number of channels per sample.
+ * @return The number of channels.
+ */
+int HistoryStore::channelCount() const
+{
+    return channels;
+}
+
+/**
+ * @brief Appends a batch of samples. Samples must be appended in timestamp order.
+ * @param block The samples; channels beyond channelCount() are ignored.
+ *
+ * The budget is enforced once per batch.
+ */
+void HistoryStore::append(const SampleBlock &block)
+{
+    for (int i = 0; i < block.size(); ++i) {
+        append(block, i);
+    }
+    enforceBudget();
+}
+
+/**
+ * @brief Appends one sample of a block to all levels.
+ * @param block The block.
+ * @param index The position of the sample in the block.
+ *
+ * The sample is stored at full resolution and added to the open bucket of
+ * every summary level. A bucket is closed and stored when the first sample
+ * of the next bucket arrives; its running sums are turned into means then.
+ * Channels the block does not have are stored as NaN.
+ */
+void HistoryStore::append(const SampleBlock &block, int index)
+{
+    const qint64 timestamp = block.timestamp(index);
+    double values[ChannelSchema::MaxChannels];
+    for (int channel = 0; channel < channels; ++channel) {
+        values[channel] = channel < block.channelCount() ? block.value(channel, index) : qQNaN();
+        rawValues[channel].append(values[channel]);
+    }
+    rawTimes.append(timestamp);
+    newest = timestamp;
+
+    for (int level = 1; level < LevelCount; ++level) {
+        Bucket &bucket = open[level - 1];
+        QVector<ChannelSummary> &channelSummaries = openSummaries[level - 1];
+        qint64 start = timestamp - timestamp % resolutions[level];
+
+        if (bucket.count > 0 && bucket.start == start) {
+            ++bucket.count;
+            for (int channel = 0; channel < channels; ++channel) {
+                addToChannel(channelSummaries[channel], values[channel], timestamp);
+            }
+            continue;
+        }
+
+        if (bucket.count > 0) {
+            buckets[level - 1].append(bucket);
+            for (int channel = 0; channel < channels; ++channel) {
+                channelSummaries[channel].mean /= bucket.count;
+                summaries[level - 1][channel].append(channelSummaries[channel]);
+            }
+        }
+        bucket.start = start;
+        bucket.count = 1;
+        for (int channel = 0; channel < channels; ++channel) {
+            startChannel(channelSummaries[channel], values[channel], timestamp);
+        }
+    }
+}
+
+/**
+ * @brief Removes all data.
+ */
+void HistoryStore::clear()
+{
+    rawTimes.clear();
+    for (ChunkedSeries<double> &column : rawValues) {
+        column.clear();
+    }
+    for (int level = 1; level < LevelCount; ++level) {
+        buckets[level - 1].clear();
+        for (ChunkedSeries<ChannelSummary> &column : summaries[level - 1]) {
+            column.clear();
+        }
+        open[level - 1] = Bucket();
+    }
+    newest = 0;
+}
+
+/**
+ * @brief Checks if the store is empty.
+ * @return True if no sample was appended since construction or the last clear().
+ */
+bool HistoryStore::isEmpty() const
+{
+    return newest == 0;
+}
+
+/**
+ * @brief Gets the time of the oldest retained data.
+ * @return The timestamp in nanoseconds since the epoch, or 0 if the store is empty.
+ *
+ * The coarsest level is released last, so its first entry marks how far
+ * back the history reaches.
+ */
+qint64 HistoryStore::firstTimestamp() const
+{
+    const ChunkedSeries<Bucket> &coarsest = buckets[LevelCount - 2];
+    if (coarsest.size() > 0) {
+        return coarsest.at(0).start;
+    }
+    return rawTimes.size() > 0 ? rawTimes.at(0) : 0;
+}
+
+/**
+ * @brief Gets the time of the newest sample.
+ * @return The timestamp in nanoseconds since the epoch, or 0 if the store is empty.
+ */
+qint64 HistoryStore::lastTimestamp() const
+{
+    return newest;
+}
+
+/**
+ * @brief Gets the memory currently held by the store.
+ * @return The number of bytes.
+ */
+qint64 HistoryStore::memoryUsage() const
+{
+    qint64 total = rawTimes.memoryUsage();
+    for (const ChunkedSeries<double> &column : rawValues) {
+        total += column.memoryUsage();
+    }
+    for (int level = 1; level < LevelCount; ++level) {
+        total += buckets[level - 1].memoryUsage();
+        for (const ChunkedSeries<ChannelSummary> &column : summaries[level - 1]) {
+            total += column.memoryUsage();
+        }
+    }
+    return total;
+}
+
+/**
+ * @brief Gets the bucket length of a level.
+ * @param level The level, 0 being raw samples.
+ * @return The bucket length in nanoseconds, 0 for raw samples.
+ */
+qint64 HistoryStore::resolution(int level)
+{
+    return resolutions[level];
+}
+
+/**
+ * @brief Picks the finest level that covers a time range within a point budget.
+ * @param from The start of the range in nanoseconds since the epoch.
+ * @param to The end of the range in nanoseconds since the epoch.
+ * @param width The width of the view in pixels.
+ * @return The level to read.
+ *
+ * Each raw sample yields one point and each summary two, and the budget is
+ * two points per pixel column. A level only qualifies if it still holds data
+ * from the start of the range (or from the start of the history, if the range
+ * reaches back further); otherwise a coarser level with a longer history is
+ * used. The coarsest level is the fallback.
+ */
+int HistoryStore::levelFor(qint64 from, qint64 to, int width) const
+{
+    const int budget = 2 * qMax(width, 1);
+    from = qMax(from, firstTimestamp()); // Nothing older exists on any level
+
+    if (rawTimes.size() > 0 && rawTimes.at(0) <= from) {
+        int count = rawTimes.lowerBound(to + 1) - rawTimes.lowerBound(from);
+        if (count <= budget) {
+            return 0;
+        }
+    }
+
+    for (int level = 1; level < LevelCount - 1; ++level) {
+        const ChunkedSeries<Bucket> &series = buckets[level - 1];
+        bool covered = series.size() > 0 && series.at(0).start <= from;
+        if (covered && 2 * (to - from) / resolutions[level] <= budget) {
+            return level;
+        }
+    }
+    return LevelCount - 1;
+}
+
+/**
+ * @brief Reads the points of one channel to draw for a time range.
+ * @param from The start of the range in nanoseconds since the epoch.
+ * @param to The end of the range in nanoseconds since the epoch.
+ * @param width The width of the view in pixels.
+ * @param channel The position of the channel.
+ * @param points Receives the points, with the times on the chart axis in milliseconds; previous contents are discarded.
+ * @return The level that was read.
+ *
+ * Only the entries of the chosen level that overlap the range are read,
+ * found by binary search on the timestamp column. On summary levels the
+ * minimum and maximum of each bucket are emitted at the time they occurred,
+ * so the envelope is the same as on the raw data. The bucket that is still
+ * open is included as well.
+ */
+int HistoryStore::query(qint64 from, qint64 to, int width, int channel, QVector<QPointF> &points) const
+{
+    points.clear();
+
+    int level = levelFor(from, to, width);
+    if (level == 0) {
+        const ChunkedSeries<double> &values = rawValues.at(channel);
+        int end = rawTimes.lowerBound(to + 1);
+        for (int i = rawTimes.lowerBound(from); i < end; ++i) {
+            points.append(QPointF(SampleClock::toChartTime(rawTimes.at(i)), values.at(i)));
+        }
+        return level;
+    }
+
+    const ChunkedSeries<Bucket> &series = buckets[level - 1];
+    const ChunkedSeries<ChannelSummary> &channelSummaries = summaries[level - 1].at(channel);
+    int end = series.lowerBound(to + 1);
+    for (int i = series.lowerBound(from - resolutions[level] + 1); i < end; ++i) {
+        appendChannel(channelSummaries.at(i), points);
+    }
+
+    const Bucket &bucket = open[level - 1];
+    if (bucket.count > 0 && bucket.start <= to && bucket.start + resolutions[level] > from) {
+        appendChannel(openSummaries[level - 1].at(channel), points);
+    }
+    return level;
+}
+
+/**
+ * @brief Releases the oldest chunks of the finest levels until the budget is met.
+ *
+ * The last chunk of a level is never released, so every level keeps at
+ * least its most recent data. The timestamp column and the channel columns
+ * of a level always hold the same number of entries and are released
+ * together.
+ */
+void HistoryStore::enforceBudget()
+{
+    while (memoryUsage() > memoryBudget) {
+        if (rawTimes.chunkCount() > 1) {
+            rawTimes.dropFirstChunk();
+            for (ChunkedSeries<double> &column : rawValues) {
+                column.dropFirstChunk();
+            }
+            continue;
+        }
+        int level = 1;
+        while (level < LevelCount && buckets[level - 1].chunkCount() <= 1) {
+            ++level;
+        }
+        if (level == LevelCount) {
+            break; // Nothing left to release
+        }
+        buckets[level - 1].dropFirstChunk();
+        for (ChunkedSeries<ChannelSummary> &column : summaries[level - 1]) {
+            column.dropFirstChunk();
+        }
+    }
+}
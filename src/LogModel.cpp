@@ -0,0 +1,110 @@
+#include "LogModel.h"
+#include <cstring>
+
+const int LogModel::LineLength;
+
+/**
+ * @brief Constructs an empty LogModel.
+ * @param capacity The maximum number of retained lines.
+ * @param parent The parent object.
+ *
+ * The storage for all lines is allocated here and never grows.
+ */
+LogModel::LogModel(int capacity, QObject *parent)
+    : QAbstractListModel(parent)
+    , text(qMax(capacity, 1) * LineLength)
+    , lengths(qMax(capacity, 1))
+    , first(0)
+    , count(0)
+{
+}
+
+/**
+ * @brief Appends a batch of lines, dropping the oldest lines if the ring is full.
+ * @param lines The lines, each stored in a slot of LineLength bytes.
+ * @param lineLengths The length of each line in bytes.
+ * @param lineCount The number of lines.
+ *
+ * The view is told about the dropped and added rows with one removal and
+ * one insertion per batch, however many lines it contains. If the batch is
+ * larger than the ring, only its newest lines are kept.
+ */
+void LogModel::appendLines(const char *lines, const int *lineLengths, int lineCount)
+{
+    const int cap = capacity();
+    if (lineCount <= 0) {
+        return;
+    }
+    if (lineCount > cap) {
+        lines += static_cast<std::size_t>(lineCount - cap) * LineLength; // Older lines would be dropped anyway
+        lineLengths += lineCount - cap;
+        lineCount = cap;
+    }
+
+    int overflow = count + lineCount - cap;
+    if (overflow > 0) {
+        beginRemoveRows(QModelIndex(), 0, overflow - 1);
+        first = (first + overflow) % cap;
+        count -= overflow;
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), count, count + lineCount - 1);
+    for (int i = 0; i < lineCount; ++i) {
+        int slot = (first + count + i) % cap;
+        std::memcpy(text.data() + static_cast<std::size_t>(slot) * LineLength,
+                    lines + static_cast<std::size_t>(i) * LineLength,
+                    static_cast<std::size_t>(lineLengths[i]));
+        lengths[slot] = lineLengths[i];
+    }
+    count += lineCount;
+    endInsertRows();
+}
+
+/**
+ * @brief Removes all lines.
+ */
+void LogModel::clear()
+{
+    beginResetModel();
+    first = 0;
+    count = 0;
+    endResetModel();
+}
+
+/**
+ * @brief Gets the maximum number of retained lines.
+ * @return The capacity.
+ */
+int LogModel::capacity() const
+{
+    return lengths.size();
+}
+
+/**
+ * @brief Gets the number of rows.
+ * @param parent The parent index; only the invalid root index has rows.
+ * @return The number of retained lines.
+ */
+int LogModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : count;
+}
+
+/**
+ * @brief Gets the text of a line.
+ * @param index The index of the line, 0 being the oldest retained line.
+ * @param role The requested role; only Qt::DisplayRole is provided.
+ * @return The line as a string, or an invalid QVariant.
+ *
+ * This is only called for rows that are visible, so converting the line to
+ * a QString here costs a handful of conversions per repaint.
+ */
+QVariant LogModel::data(const QModelIndex &index, int role) const
+{
+    if (role != Qt::DisplayRole || !index.isValid() || index.row() >= count) {
+        return QVariant();
+    }
+    int slot = (first + index.row()) % capacity();
+    return QString::fromLatin1(text.constData() + static_cast<std::size_t>(slot) * LineLength, lengths.at(slot));
+}
@@ -0,0 +1,218 @@
+#include "PhysicsEngine.h"
+#include <QtMath>
+
+const qint64 PhysicsEngine::StepTime;
+const qint64 PhysicsEngine::MaxFrameTime;
+
+namespace {
+
+/**
+ * @brief Share of the slope force that accelerates a solid sphere rolling without slipping.
+ *
+ * The rest goes into spinning the ball up: 1 / (1 + I / (m r^2)) with I = 2/5 m r^2.
+ */
+const double rollingFactor = 5.0 / 7.0;
+
+/**
+ * @brief Length of a step in seconds.
+ */
+const double stepSeconds = PhysicsEngine::StepTime / 1e9;
+
+} // namespace
+
+/**
+ * @brief Constructs a PhysicsEngine with the ball at rest in the middle of a level platform.
+ *
+ * Gravity defaults to 9.81 m/s^2 at 400 units per metre, i.e. the default
+ * 400-unit platform stands for a one metre beam.
+ */
+PhysicsEngine::PhysicsEngine()
+    : accumulator(0)
+    , centreX(0)
+    , centreY(0)
+    , halfLength(200)
+    , tilt(0)
+    , floor(1e9)
+    , gravity(9.81 * 400)
+    , rollingResistance(0.01)
+    , damping(0.1)
+    , fallVelocityX(0)
+    , fallVelocityY(0)
+{
+    reset();
+}
+
+/**
+ * @brief Puts the ball at rest in the middle of the platform and empties the accumulator.
+ */
+void PhysicsEngine::reset()
+{
+    current.x = centreX;
+    current.y = centreY;
+    current.offset = 0;
+    current.velocity = 0;
+    current.falling = false;
+    previous = current;
+    accumulator = 0;
+    fallVelocityX = 0;
+    fallVelocityY = 0;
+}
+
+/**
+ * @brief Sets where the platform is.
+ * @param centreX The horizontal position of the platform's pivot.
+ * @param centreY The vertical position of the platform's pivot.
+ * @param halfLength The distance from the pivot to either end.
+ */
+void PhysicsEngine::setPlatform(double centreX, double centreY, double halfLength)
+{
+    this->centreX = centreX;
+    this->centreY = centreY;
+    this->halfLength = halfLength;
+}
+
+/**
+ * @brief Sets the tilt of the platform used by the following steps.
+ * @param degrees The angle, positive making the ball roll towards positive offsets.
+ *
+ * Only the latest tilt matters, so this may be called for every sample or
+ * once per batch at no difference in cost.
+ */
+void PhysicsEngine::setTilt(double degrees)
+{
+    tilt = qDegreesToRadians(degrees);
+}
+
+/**
+ * @brief Sets the height of the floor a falling ball stops at.
+ * @param y The vertical position of the ball's centre on the floor.
+ */
+void PhysicsEngine::setFloor(double y)
+{
+    floor = y;
+}
+
+/**
+ * @brief Sets the gravitational acceleration.
+ * @param acceleration The acceleration in scene units per second squared.
+ */
+void PhysicsEngine::setGravity(double acceleration)
+{
+    gravity = acceleration;
+}
+
+/**
+ * @brief Sets the losses of the rolling ball.
+ * @param rollingResistance The rolling resistance coefficient (resistance over normal force).
+ * @param damping The viscous damping in 1/s.
+ */
+void PhysicsEngine::setFriction(double rollingResistance, double damping)
+{
+    this->rollingResistance = rollingResistance;
+    this->damping = damping;
+}
+
+/**
+ * @brief Runs all simulation steps that fit into the elapsed time.
+ * @param elapsed The time since the previous call in nanoseconds.
+ * @return The number of steps run.
+ *
+ * Time that does not fill a whole step stays in the accumulator for the
+ * next call. At most MaxFrameTime is simulated per call, so a stalled GUI
+ * thread does not make the ball jump or the next call run for long.
+ */
+int PhysicsEngine::advance(qint64 elapsed)
+{
+    accumulator += qBound<qint64>(0, elapsed, MaxFrameTime);
+    int steps = 0;
+    while (accumulator >= StepTime) {
+        step();
+        accumulator -= StepTime;
+        ++steps;
+    }
+    return steps;
+}
+
+/**
+ * @brief Gets the state to draw, interpolated between the last two steps.
+ * @return The interpolated state.
+ *
+ * The state lags the simulated time by less than one step, which keeps the
+ * drawn motion continuous even though steps and frames do not line up.
+ */
+BallState PhysicsEngine::state() const
+{
+    const double alpha = static_cast<double>(accumulator) / StepTime;
+    BallState state = current;
+    state.x = previous.x + (current.x - previous.x) * alpha;
+    state.y = previous.y + (current.y - previous.y) * alpha;
+    state.offset = previous.offset + (current.offset - previous.offset) * alpha;
+    state.velocity = previous.velocity + (current.velocity - previous.velocity) * alpha;
+    return state;
+}
+
+/**
+ * @brief Checks if the ball has rolled off the platform.
+ * @return True if the ball is falling or lies on the floor.
+ */
+bool PhysicsEngine::hasFallen() const
+{
+    return current.falling;
+}
+
+/**
+ * @brief Checks if the ball has come to rest on the floor.
+ * @return True once the falling ball has reached the floor.
+ *
+ * This holds from the step after the one reaching the floor, so state()
+ * shows the ball on the floor too. Further steps do not change the state,
+ * so the simulation need not be advanced any more.
+ */
+bool PhysicsEngine::hasLanded() const
+{
+    return current.falling && previous.falling && previous.y >= floor;
+}
+
+/**
+ * @brief Advances the simulation by one StepTime.
+ *
+ * Semi-implicit Euler integration: the velocity is updated first and the
+ * new velocity moves the ball. Rolling resistance can bring the ball to a
+ * stop but never push it backwards; once at rest, the ball only starts
+ * again when the slope overcomes the resistance.
+ */
+void PhysicsEngine::step()
+{
+    previous = current;
+
+    if (current.falling) {
+        if (current.y < floor) {
+            fallVelocityY += gravity * stepSeconds;
+            current.x += fallVelocityX * stepSeconds;
+            current.y = qMin(current.y + fallVelocityY * stepSeconds, floor);
+        }
+        return;
+    }
+
+    const double slope = rollingFactor * gravity * qSin(tilt);
+    const double resistance = rollingFactor * rollingResistance * gravity * qCos(tilt);
+    double velocity = current.velocity;
+
+    if (velocity != 0 || qAbs(slope) > resistance) {
+        const double direction = velocity != 0 ? (velocity > 0 ? 1 : -1) : (slope > 0 ? 1 : -1);
+        const double acceleration = slope - direction * resistance - damping * velocity;
+        const double next = velocity + acceleration * stepSeconds;
+        velocity = velocity != 0 && (next > 0) != (velocity > 0) ? 0 : next; // Stopped by the losses
+    }
+
+    current.velocity = velocity;
+    current.offset += velocity * stepSeconds;
+    current.x = centreX + current.offset * qCos(tilt);
+    current.y = centreY + current.offset * qSin(tilt);
+
+    if (qAbs(current.offset) > halfLength) {
+        current.falling = true;
+        fallVelocityX = velocity * qCos(tilt);
+        fallVelocityY = velocity * qSin(tilt);
+    }
+}
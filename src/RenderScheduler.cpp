@@ -0,0 +1,79 @@
+#include "RenderScheduler.h"
+
+namespace {
+
+/**
+ * @brief Tolerance for frame clock jitter in nanoseconds.
+ *
+ * A 16 ms timer would otherwise miss every other 16.7 ms frame slot at 60 Hz.
+ */
+const qint64 tickTolerance = 2 * 1000 * 1000;
+
+} // namespace
+
+/**
+ * @brief Constructs a RenderScheduler object.
+ * @param parent The parent object.
+ *
+ * The maximum refresh rate defaults to 60 frames per second.
+ */
+RenderScheduler::RenderScheduler(QObject *parent)
+    : QObject(parent), minInterval(0), framePending(false)
+{
+    setMaxRefreshRate(60);
+    clock.start();
+}
+
+/**
+ * @brief Sets the maximum number of frames per second.
+ * @param hz The maximum refresh rate; values below 1 are clamped to 1.
+ */
+void RenderScheduler::setMaxRefreshRate(int hz)
+{
+    minInterval = 1000 * 1000 * 1000 / qMax(1, hz);
+}
+
+/**
+ * @brief Gets the maximum number of frames per second.
+ * @return The maximum refresh rate.
+ */
+int RenderScheduler::maxRefreshRate() const
+{
+    return static_cast<int>(1000 * 1000 * 1000 / minInterval);
+}
+
+/**
+ * @brief Requests that a frame is rendered on one of the next ticks.
+ *
+ * Any number of requests between two ticks result in a single frame, and
+ * only the first one emits frameRequested().
+ */
+void RenderScheduler::requestFrame()
+{
+    if (!framePending) {
+        framePending = true;
+        emit frameRequested();
+    }
+}
+
+/**
+ * @brief Advances the frame clock, emitting frameReady() if a frame is due.
+ *
+ * Nothing happens if no frame was requested or if the previous frame was
+ * rendered less than one refresh interval ago (minus a small tolerance for
+ * timer jitter); the request then stays pending, and frameRequested() asks
+ * for a later tick.
+ */
+void RenderScheduler::tick()
+{
+    if (!framePending) {
+        return;
+    }
+    if (clock.nsecsElapsed() + tickTolerance < minInterval) {
+        emit frameRequested();
+        return;
+    }
+    framePending = false;
+    clock.restart();
+    emit frameReady();
+}
@@ -0,0 +1,158 @@
+#include "ReplayDevice.h"
+#include "SampleClock.h"
+#include <cstring>
+
+const int ReplayDevice::MaxBurst;
+
+/**
+ * @brief Constructs a closed ReplayDevice.
+ * @param parent The parent object.
+ */
+ReplayDevice::ReplayDevice(QObject *parent)
+    : QIODevice(parent)
+    , speed(1.0)
+    , captureStart(0)
+    , replayStart(0)
+    , nextTime(0)
+    , hasNext(false)
+    , readPosition(0)
+{
+    timer.setSingleShot(true);
+    timer.setTimerType(Qt::PreciseTimer);
+    connect(&timer, &QTimer::timeout, this, &ReplayDevice::release);
+}
+
+/**
+ * @brief Opens a capture file and starts the replay.
+ * @param path The capture file.
+ * @param speed The replay speed: 1 for real time, N for N times faster, 0 for as fast as possible.
+ * @return True if the file could be opened.
+ *
+ * The device is opened unbuffered, since the released bytes are buffered
+ * here already. The first record is released from the event loop.
+ */
+bool ReplayDevice::openCapture(const QString &path, double speed)
+{
+    close();
+    if (!reader.open(path)) {
+        return false;
+    }
+    this->speed = qMax(0.0, speed);
+    hasNext = reader.next(nextTime, nextData);
+    captureStart = nextTime;
+    replayStart = SampleClock::now();
+    released.clear();
+    readPosition = 0;
+
+    QIODevice::open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    timer.start(0);
+    return true;
+}
+
+/**
+ * @brief Stops the replay and closes the capture file.
+ */
+void ReplayDevice::close()
+{
+    timer.stop();
+    reader.close();
+    hasNext = false;
+    released.clear();
+    readPosition = 0;
+    QIODevice::close();
+}
+
+/**
+ * @brief Tells QIODevice that the device is a stream.
+ * @return Always true.
+ */
+bool ReplayDevice::isSequential() const
+{
+    return true;
+}
+
+/**
+ * @brief Gets the number of released bytes that have not been read.
+ * @return The number of bytes.
+ */
+qint64 ReplayDevice::bytesAvailable() const
+{
+    return released.size() - readPosition + QIODevice::bytesAvailable();
+}
+
+/**
+ * @brief Copies released bytes out.
+ * @param data Receives the bytes.
+ * @param maxSize The maximum number of bytes to copy.
+ * @return The number of bytes copied.
+ */
+qint64 ReplayDevice::readData(char *data, qint64 maxSize)
+{
+    qint64 size = qMin<qint64>(maxSize, released.size() - readPosition);
+    std::memcpy(data, released.constData() + readPosition, static_cast<std::size_t>(size));
+    readPosition += static_cast<int>(size);
+    if (readPosition == released.size()) {
+        released.resize(0); // Keeps the capacity, unlike clear()
+        readPosition = 0;
+    }
+    return size;
+}
+
+/**
+ * @brief Rejects writes; the device is read-only.
+ * @param data Unused.
+ * @param maxSize Unused.
+ * @return Always -1.
+ */
+qint64 ReplayDevice::writeData(const char *data, qint64 maxSize)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+    return -1;
+}
+
+/**
+ * @brief Releases the records that are due and schedules the next one.
+ *
+ * At a finite speed, every record whose recorded offset from the first one,
+ * divided by the speed, has elapsed is released, and the timer is set for
+ * the next one, rounded up to whole milliseconds so records less than 1 ms
+ * apart are released together instead of spinning. As fast as possible,
+ * up to MaxBurst bytes are released per pass and the next pass is queued
+ * right away, so the reader and the rest of the event loop still get their
+ * turn. readyRead() is emitted once per pass that released bytes, and
+ * finished() after the last record.
+ */
+void ReplayDevice::release()
+{
+    qint64 elapsed = SampleClock::now() - replayStart;
+    int releasedBytes = 0;
+
+    while (hasNext) {
+        if (speed > 0) {
+            if ((nextTime - captureStart) / speed > elapsed) {
+                break; // Not due yet
+            }
+        } else if (releasedBytes >= MaxBurst) {
+            break; // Let the reader catch up
+        }
+        released.append(nextData);
+        releasedBytes += nextData.size();
+        hasNext = reader.next(nextTime, nextData);
+    }
+
+    if (releasedBytes > 0) {
+        emit readyRead();
+    }
+
+    if (!hasNext) {
+        emit finished();
+        return;
+    }
+    if (speed > 0) {
+        qint64 wait = static_cast<qint64>((nextTime - captureStart) / speed) - elapsed;
+        timer.start(static_cast<int>(qMax<qint64>(1, (wait + 999999) / 1000000))); // Never spin on a wait under 1 ms
+    } else {
+        timer.start(0);
+    }
+}
@@ -0,0 +1,85 @@
+#include "SampleBlock.h"
+#include <algorithm>
+#include <limits>
+
+/**
+ * @brief Constructs an empty SampleBlock.
+ * @param channelCount The number of channels.
+ */
+SampleBlock::SampleBlock(int channelCount)
+    : columns(channelCount)
+{
+}
+
+/**
+ * @brief Removes all samples and sets the number of channels.
+ * @param channelCount The number of channels.
+ *
+ * The capacity of the existing columns is kept.
+ */
+void SampleBlock::reset(int channelCount)
+{
+    columns.resize(channelCount);
+    clear();
+}
+
+/**
+ * @brief Removes all samples, keeping the number of channels and the capacity.
+ */
+void SampleBlock::clear()
+{
+    times.clear();
+    for (QVector<double> &column : columns) {
+        column.clear();
+    }
+}
+
+/**
+ * @brief Reserves space for a number of samples.
+ * @param capacity The number of samples.
+ */
+void SampleBlock::reserve(int capacity)
+{
+    times.reserve(capacity);
+    for (QVector<double> &column : columns) {
+        column.reserve(capacity);
+    }
+}
+
+/**
+ * @brief Appends a sample.
+ * @param timestamp The acquisition time in nanoseconds since the epoch.
+ * @param values The channel values in frame order.
+ * @param count The number of values; missing channels are set to NaN and extra values are ignored.
+ *
+ * A frame with fewer values than the schema has channels therefore leaves
+ * gaps in the missing channels instead of shifting the others.
+ */
+void SampleBlock::append(qint64 timestamp, const double *values, int count)
+{
+    times.append(timestamp);
+    for (int channel = 0; channel < columns.size(); ++channel) {
+        columns[channel].append(channel < count ? values[channel] : std::numeric_limits<double>::quiet_NaN());
+    }
+}
+
+/**
+ * @brief Appends many samples given as columns.
+ * @param timestamps count timestamps in nanoseconds since the epoch.
+ * @param values One column of count values per channel of the block.
+ * @param count The number of samples.
+ *
+ * Each column is copied in one go, which is how stored columnar data is
+ * loaded without going through the samples one by one.
+ */
+void SampleBlock::append(const qint64 *timestamps, const double *const *values, int count)
+{
+    const int start = times.size();
+    times.resize(start + count);
+    std::copy(timestamps, timestamps + count, times.begin() + start);
+    for (int channel = 0; channel < columns.size(); ++channel) {
+        QVector<double> &column = columns[channel];
+        column.resize(start + count);
+        std::copy(values[channel], values[channel] + count, column.begin() + start);
+    }
+}
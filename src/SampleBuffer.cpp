@@ -0,0 +1,129 @@
+#include "SampleBuffer.h"
+#include <QtNumeric>
+#include <algorithm>
+
+const int SampleBuffer::MaxCapacity;
+
+/**
+ * @brief Constructs an empty SampleBuffer.
+ * @param channelCount The number of channels per sample.
+ * @param initialCapacity The number of samples to reserve; rounded up to a power of two, at most MaxCapacity.
+ */
+SampleBuffer::SampleBuffer(int channelCount, int initialCapacity)
+    : channels(channelCount), mask(0), head(0), count(0)
+{
+    int capacity = 1;
+    while (capacity < qMin(initialCapacity, MaxCapacity)) {
+        capacity *= 2;
+    }
+    times.resize(capacity);
+    values.resize(capacity * channels);
+    mask = capacity - 1;
+}
+
+/**
+ * @brief Removes all samples and sets the number of channels per sample.
+ * @param channelCount The number of channels.
+ */
+void SampleBuffer::setChannelCount(int channelCount)
+{
+    channels = channelCount;
+    values.resize(times.size() * channels);
+    clear();
+}
+
+/**
+ * @brief Appends a batch of samples. Samples must be appended in timestamp order.
+ * @param block The samples; channels beyond channelCount() are ignored.
+ *
+ * The storage is doubled until the batch fits, so the cost is amortised
+ * constant per sample. The batch is then copied column by column, each
+ * column in at most two contiguous runs. Channels the block does not have
+ * are filled with NaN. Once the storage has reached MaxCapacity, the
+ * oldest samples are dropped instead, and of a batch longer than
+ * MaxCapacity only the newest samples are kept.
+ */
+void SampleBuffer::append(const SampleBlock &block)
+{
+    const int skipped = qMax(block.size() - MaxCapacity, 0);
+    const int n = block.size() - skipped;
+    while (count + n > times.size() && times.size() < MaxCapacity) {
+        grow();
+    }
+
+    const int capacity = times.size();
+    const int dropped = qMax(count + n - capacity, 0);
+    head = (head + dropped) & mask;
+    count -= dropped;
+
+    const int tail = (head + count) & mask;
+    const int first = qMin(n, capacity - tail); // Samples that fit before the wrap
+    const qint64 *timestamps = block.timestamps() + skipped;
+    std::copy(timestamps, timestamps + first, times.begin() + tail);
+    std::copy(timestamps + first, timestamps + n, times.begin());
+
+    for (int channel = 0; channel < channels; ++channel) {
+        QVector<double>::iterator ring = values.begin() + channel * capacity;
+        if (channel < block.channelCount()) {
+            const double *column = block.channel(channel) + skipped;
+            std::copy(column, column + first, ring + tail);
+            std::copy(column + first, column + n, ring);
+        } else {
+            std::fill(ring + tail, ring + tail + first, qQNaN());
+            std::fill(ring, ring + (n - first), qQNaN());
+        }
+    }
+    count += n;
+}
+
+/**
+ * @brief Removes all samples older than the given time.
+ * @param timestamp The oldest timestamp to keep, in nanoseconds since the epoch.
+ *
+ * Only the head index moves; every sample is visited at most once on its
+ * way out, so eviction is amortised constant per sample.
+ */
+void SampleBuffer::evictBefore(qint64 timestamp)
+{
+    while (count > 0 && times.at(head) < timestamp) {
+        head = (head + 1) & mask;
+        --count;
+    }
+}
+
+/**
+ * @brief Removes all samples.
+ */
+void SampleBuffer::clear()
+{
+    head = 0;
+    count = 0;
+}
+
+/**
+ * @brief Doubles the storage, moving the samples to the front.
+ *
+ * Must not be called once the storage holds MaxCapacity samples. The sizes
+ * are computed in 64 bits and checked, since the values of all channels
+ * together are MaxChannels times longer than the timestamps.
+ */
+void SampleBuffer::grow()
+{
+    const int capacity = times.size();
+    const qint64 larger = qint64(capacity) * 2;
+    const qint64 largerValueCount = larger * channels;
+    Q_ASSERT(larger <= MaxCapacity && largerValueCount <= qint64(MaxCapacity) * ChannelSchema::MaxChannels);
+    QVector<qint64> largerTimes(static_cast<int>(larger));
+    QVector<double> largerValues(static_cast<int>(largerValueCount));
+    for (int i = 0; i < count; ++i) {
+        int slot = (head + i) & mask;
+        largerTimes[i] = times.at(slot);
+        for (int channel = 0; channel < channels; ++channel) {
+            largerValues[static_cast<int>(channel * larger + i)] = values.at(channel * capacity + slot);
+        }
+    }
+    times.swap(largerTimes);
+    values.swap(largerValues);
+    mask = times.size() - 1;
+    head = 0;
+}
@@ -0,0 +1,64 @@
+#include "SampleClock.h"
+#include <chrono>
+
+namespace {
+
+/**
+ * @struct Anchor
+ * @brief A pair of readings of the monotonic and the wall clock taken at the same time.
+ */
+struct Anchor
+{
+    qint64 monotonic; ///< The monotonic clock in nanoseconds.
+    qint64 epoch;     ///< The wall clock in nanoseconds since the epoch.
+};
+
+/**
+ * @brief Gets the readings that map the monotonic clock to the wall clock.
+ * @return The readings, taken on the first call.
+ */
+const Anchor &anchor()
+{
+    static const Anchor readings = {
+        SampleClock::now(),
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count()
+    };
+    return readings;
+}
+
+} // namespace
+
+/**
+ * @brief Gets the current time. May be called from any thread.
+ * @return The time in nanoseconds on the monotonic clock.
+ */
+qint64 SampleClock::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Converts a time on this clock to the wall clock.
+ * @param time The time in nanoseconds on the monotonic clock.
+ * @return The time in nanoseconds since the epoch.
+ *
+ * The offset between the clocks is fixed, so adjustments of the wall clock
+ * during a session do not reorder or bend the converted times.
+ */
+qint64 SampleClock::toNSecsSinceEpoch(qint64 time)
+{
+    const Anchor &readings = anchor();
+    return readings.epoch + (time - readings.monotonic);
+}
+
+/**
+ * @brief Converts a time on this clock to the wall clock in milliseconds.
+ * @param time The time in nanoseconds on the monotonic clock.
+ * @return The time in milliseconds since the epoch.
+ */
+qint64 SampleClock::toMSecsSinceEpoch(qint64 time)
+{
+    return toNSecsSinceEpoch(time) / 1000000;
+}
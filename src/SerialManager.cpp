@@ -1,65 +1,99 @@
 #include "SerialManager.h"
-#include <QSerialPortInfo>
-#include <QDebug>
-
-/**
- * @brief Computes the CRC-16-CCITT checksum for the given data.
- * @param data The data for which the checksum is computed.
- * @return The computed CRC-16-CCITT checksum.
- *
- * The CRC-16-CCITT (Cyclic Redundancy Check) is a common error-detecting code
- * used to detect accidental changes to raw data. This function calculates the
- * CRC for the provided data using the CCITT polynomial 0x1021.
- *
- * The calculation is performed by iterating over each byte of the input data
- * and updating the CRC for each bit in the byte. The CRC is initially set to
- * 0xFFFF. For each byte, the CRC is XORed with the byte shifted left by 8 bits.
- * Then, for each of the 8 bits, if the highest bit of the CRC is set, the CRC
- * is shifted left by 1 and XORed with the polynomial 0x1021. Otherwise, the
- * CRC is just shifted left by 1. This process ensures that all bits of the
- * input data contribute to the final CRC value.
- */
-uint16_t SerialManager::crc16_ccitt(const QByteArray &data) {
-    uint16_t crc = 0xFFFF; // Initial CRC value
-    for (char byte : data) {
-        crc ^= static_cast<uint8_t>(byte) << 8; // XOR CRC with byte shifted left by 8 bits
-        for (int i = 0; i < 8; i++) {
-            if (crc & 0x8000) { // If the highest bit is set
-                crc = (crc << 1) ^ 0x1021; // Shift left and XOR with polynomial
-            } else {
-                crc = crc << 1; // Just shift left
-            }
-        }
-    }
-    return crc; // Return the computed CRC value
-}
+#include "SampleClock.h"
 
 /**
  * @brief Constructs a SerialManager object.
  * @param parent The parent object.
  *
- * This constructor initializes the SerialManager object by creating a new
- * QSerialPort instance and connecting the readyRead signal of the serial port
- * to the readSerialData slot. This setup allows the SerialManager to handle
- * incoming serial data.
+ * This constructor starts the acquisition thread. Workers are created and
+ * moved to it by addPort().
  */
 SerialManager::SerialManager(QObject *parent)
-    : QObject(parent), serial(new QSerialPort(this))
+    : QObject(parent), schema(ChannelSchema::attitude())
 {
-    connect(serial, &QSerialPort::readyRead, this, &SerialManager::readSerialData);
+    thread.setObjectName("SerialAcquisition");
+    thread.start(QThread::TimeCriticalPriority);
 }
 
 /**
  * @brief Destructor for SerialManager.
  *
- * This destructor ensures that the serial port is properly closed if it is
- * still open when the SerialManager object is destroyed.
+ * This destructor closes all serial ports on the acquisition thread and
+ * waits for the thread to finish. The workers are deleted on the
+ * acquisition thread once it finishes.
  */
 SerialManager::~SerialManager()
 {
-    if (serial->isOpen()) {
-        serial->close();
+    for (const Port &port : qAsConst(ports)) {
+        QMetaObject::invokeMethod(port.worker, &SerialWorker::close, Qt::BlockingQueuedConnection);
     }
+    thread.quit();
+    thread.wait();
+}
+
+/**
+ * @brief Adds a serial port and starts reading from it.
+ * @param portName The name of the serial port.
+ * @param baudRate The baud rate for the serial communication.
+ * @return The index of the port, used in signals and by getPortStats().
+ *
+ * The port is opened asynchronously on the acquisition thread. The
+ * serialPortOpened signal is emitted with the result once the attempt has
+ * completed.
+ */
+int SerialManager::addPort(const QString &portName, qint32 baudRate)
+{
+    const int index = createPort(portName);
+    SerialWorker *worker = ports.at(index).worker;
+    QMetaObject::invokeMethod(worker, [worker, portName, baudRate]() {
+        worker->open(portName, baudRate);
+    }, Qt::QueuedConnection);
+    return index;
+}
+
+/**
+ * @brief Adds a replayed capture file as a port and starts playing it.
+ * @param path The capture file.
+ * @param speed The replay speed: 1 for real time, N for N times faster, 0 for as fast as possible.
+ * @return The index of the port, used in signals and by getPortStats().
+ *
+ * The replay goes through the same worker, parser and queue as a serial
+ * port. The serialPortOpened signal is emitted with a value of true once
+ * playback has started and with a value of false when it reaches the end.
+ */
+int SerialManager::addReplay(const QString &path, double speed)
+{
+    const int index = createPort(path);
+    SerialWorker *worker = ports.at(index).worker;
+    QMetaObject::invokeMethod(worker, [worker, path, speed]() {
+        worker->openReplay(path, speed);
+    }, Qt::QueuedConnection);
+    return index;
+}
+
+/**
+ * @brief Starts recording the raw bytes read from a port.
+ * @param port The index of the port.
+ * @param path The capture file; an existing file is replaced.
+ *
+ * Every read is stored with its read time, so a replay reproduces both the
+ * bytes and how they were split across reads.
+ */
+void SerialManager::startCapture(int port, const QString &path)
+{
+    SerialWorker *worker = ports.at(port).worker;
+    QMetaObject::invokeMethod(worker, [worker, path]() {
+        worker->startCapture(path);
+    }, Qt::QueuedConnection);
+}
+
+/**
+ * @brief Stops recording a port.
+ * @param port The index of the port.
+ */
+void SerialManager::stopCapture(int port)
+{
+    QMetaObject::invokeMethod(ports.at(port).worker, &SerialWorker::stopCapture, Qt::QueuedConnection);
 }
 
 /**
@@ -67,91 +101,251 @@ SerialManager::~SerialManager()
  * @param portName The name of the serial port.
  * @param baudRate The baud rate for the serial communication.
  *
- * This method configures the serial port with the specified port name and
- * baud rate, sets the data format to 8 data bits, no parity, one stop bit, and
- * no flow control. It then attempts to open the serial port in read-only mode.
- * If the port is successfully opened, the serialPortOpened signal is emitted
- * with a value of true. Otherwise, the signal is emitted with a value of false.
+ * If the port has been added before, it is reopened; otherwise it is added.
  */
 void SerialManager::startReading(const QString &portName, qint32 baudRate)
 {
-    serial->setPortName(portName);
-    serial->setBaudRate(baudRate);
-    serial->setDataBits(QSerialPort::Data8);
-    serial->setParity(QSerialPort::NoParity);
-    serial->setStopBits(QSerialPort::OneStop);
-    serial->setFlowControl(QSerialPort::NoFlowControl);
-
-    if (serial->open(QIODevice::ReadOnly)) {
-        emit serialPortOpened(true); // Emit signal indicating port is open
-        qDebug() << "Serial port opened successfully!";
-    } else {
-        emit serialPortOpened(false); // Emit signal indicating port failed to open
-        qDebug() << "Failed to open port!";
+    for (const Port &port : qAsConst(ports)) {
+        if (port.name == portName) {
+            SerialWorker *worker = port.worker;
+            QMetaObject::invokeMethod(worker, [worker, portName, baudRate]() {
+                worker->open(portName, baudRate);
+            }, Qt::QueuedConnection);
+            return;
+        }
     }
+    addPort(portName, baudRate);
 }
 
 /**
- * @brief Stops reading data from the serial port.
+ * @brief Stops reading data from all serial ports.
  *
- * This method closes the serial port if it is open and emits the serialPortOpened
- * signal with a value of false to indicate that the port is closed.
+ * The ports are closed asynchronously on the acquisition thread, which
+ * emits the serialPortOpened signal with a value of false for every port
+ * that was open.
  */
 void SerialManager::stopReading()
 {
-    if (serial->isOpen()) {
-        serial->close();
-        emit serialPortOpened(false); // Emit signal indicating port is closed
+    for (const Port &port : qAsConst(ports)) {
+        QMetaObject::invokeMethod(port.worker, &SerialWorker::close, Qt::QueuedConnection);
+    }
+}
+
+/**
+ * @brief Gets the number of added ports.
+ * @return The number of ports.
+ */
+int SerialManager::getPortCount() const
+{
+    return ports.size();
+}
+
+/**
+ * @brief Gets the name of a port.
+ * @param port The index of the port.
+ * @return The name passed to addPort().
+ */
+QString SerialManager::getPortName(int port) const
+{
+    return ports.at(port).name;
+}
+
+/**
+ * @brief Gets the traffic counters of a port.
+ * @param port The index of the port.
+ * @return A snapshot of the counters.
+ */
+PortStats SerialManager::getPortStats(int port) const
+{
+    return ports.at(port).worker->stats();
+}
+
+/**
+ * @brief Gets the traffic counters of all ports added up.
+ * @return A snapshot of the counters.
+ */
+PortStats SerialManager::getTotalStats() const
+{
+    PortStats total = PortStats();
+    for (const Port &port : ports) {
+        PortStats stats = port.worker->stats();
+        total.bytesRead += stats.bytesRead;
+        total.frames += stats.frames;
+        total.crcErrors += stats.crcErrors;
+        total.formatErrors += stats.formatErrors;
+        total.overflows += stats.overflows;
+        total.droppedFrames += stats.droppedFrames;
+        total.lostFrames += stats.lostFrames;
+    }
+    return total;
+}
+
+/**
+ * @brief Gets the time the workers of all ports spent decoding each read.
+ * @return The durations in nanoseconds.
+ */
+HistogramSnapshot SerialManager::getParseTime() const
+{
+    HistogramSnapshot total;
+    for (const Port &port : ports) {
+        total.merge(port.worker->parseTime().snapshot());
+    }
+    return total;
+}
+
+/**
+ * @brief Gets the time samples spent between their read and the drain that emitted them.
+ * @return The latencies in nanoseconds.
+ */
+HistogramSnapshot SerialManager::getLatency() const
+{
+    return latency.snapshot();
+}
+
+/**
+ * @brief Gets the number of samples found in a queue per drain.
+ * @return The queue depths.
+ */
+HistogramSnapshot SerialManager::getQueueDepth() const
+{
+    return queueDepth.snapshot();
+}
+
+/**
+ * @brief Sets the channels carried by each frame.
+ * @param schema The channel schema; ChannelSchema::attitude() by default.
+ *
+ * Batches emitted from now on have one column per channel of the schema.
+ * All ports share the schema. The filters are rebuilt for the new channels,
+ * or removed if they name channels the schema does not have.
+ */
+void SerialManager::setSchema(const ChannelSchema &schema)
+{
+    this->schema = schema;
+    for (Port &port : ports) {
+        port.batch.reset(schema.channelCount());
+    }
+    if (!filters.isEmpty()) {
+        FilterChain chain;
+        if (!chain.configure(filters, schema)) {
+            filters.clear(); // The channels the filters referred to are gone
+        }
+        for (int i = 0; i < ports.size(); ++i) {
+            sendFilters(i);
+        }
+    }
+}
+
+/**
+ * @brief Gets the channels carried by each frame.
+ * @return The channel schema.
+ */
+const ChannelSchema &SerialManager::getSchema() const
+{
+    return schema;
+}
+
+/**
+ * @brief Sets the filters applied to the samples of all ports on the acquisition thread.
+ * @param description The filter stages, see FilterChain; an empty text removes all filters.
+ * @param error Receives a description of the problem if the text is invalid, if not null.
+ * @return True if the filters were valid and have been sent to the workers.
+ *
+ * The text is checked against the schema here, so the workers only ever
+ * receive valid filters. Every worker builds its own chain, because the
+ * filters keep state per port. Ports added later get the same filters.
+ */
+bool SerialManager::setFilters(const QString &description, QString *error)
+{
+    FilterChain chain;
+    if (!chain.configure(description, schema, error)) {
+        return false;
+    }
+    filters = description;
+    for (int i = 0; i < ports.size(); ++i) {
+        sendFilters(i);
+    }
+    return true;
+}
+
+/**
+ * @brief Creates the worker of a new port on the acquisition thread.
+ * @param name The name of the port.
+ * @return The index of the port.
+ *
+ * A new worker is moved to the shared acquisition thread. The worker's
+ * signals are delivered to this object through queued connections.
+ */
+int SerialManager::createPort(const QString &name)
+{
+    const int index = ports.size();
+    SerialWorker *worker = new SerialWorker();
+    worker->setObjectName(name);
+    worker->moveToThread(&thread);
+    connect(&thread, &QThread::finished, worker, &QObject::deleteLater);
+    connect(worker, &SerialWorker::samplesAvailable, this, [this, index]() {
+        drainQueue(index);
+    });
+    connect(worker, &SerialWorker::serialPortOpened, this, [this, index](bool isOpen) {
+        emit serialPortOpened(index, isOpen);
+    });
+
+    Port port;
+    port.name = name;
+    port.worker = worker;
+    port.batch.reset(schema.channelCount());
+    port.batch.reserve(1024);
+    ports.append(port);
+    if (!filters.isEmpty()) {
+        sendFilters(index);
     }
+    return index;
+}
+
+/**
+ * @brief Sends the current filters and schema to the worker of a port.
+ * @param port The index of the port.
+ *
+ * The worker applies them on the acquisition thread between two reads.
+ */
+void SerialManager::sendFilters(int port)
+{
+    SerialWorker *worker = ports.at(port).worker;
+    const QString description = filters;
+    const ChannelSchema schema = this->schema;
+    QMetaObject::invokeMethod(worker, [worker, description, schema]() {
+        worker->setFilters(description, schema);
+    }, Qt::QueuedConnection);
 }
 
 /**
- * @brief Slot to read data from the serial port.
+ * @brief Drains all frames queued by the worker of a port.
+ * @param port The index of the port.
  *
- * This slot is called whenever there is new data available on the serial port.
- * It reads all available data from the serial port and appends it to the serial
- * buffer. It then processes complete lines of data terminated by "\n\r". Each
- * line of data is expected to contain two space-separated values followed by a
- * CRC checksum. The data part and the CRC part are extracted and the CRC is
- * verified. If the CRC is valid, the roll and pitch values are extracted and
- * emitted using the newData signal.
- */
-void SerialManager::readSerialData()
-{
-    QByteArray data = serial->readAll(); // Read all available data
-    serialBuffer += data; // Append data to the serial buffer
-
-    while (serialBuffer.contains("\n\r")) { // Process complete lines of data
-        int endIndex = serialBuffer.indexOf("\n\r");
-        QString line = serialBuffer.left(endIndex).trimmed(); // Extract a complete line
-        serialBuffer.remove(0, endIndex + 2); // Remove the processed line from the buffer
-
-        int crcIndex = line.lastIndexOf(' '); // Find the last space, separating data and CRC
-        if (crcIndex != -1) {
-            QString dataPart = line.left(crcIndex); // Extract the data part
-            QString crcPart = line.mid(crcIndex + 1); // Extract the CRC part
-
-            bool ok;
-            uint16_t receivedCrc = crcPart.toUShort(&ok, 16); // Convert CRC from hex string to integer
-            if (ok) {
-                uint16_t calculatedCrc = crc16_ccitt(dataPart.toUtf8()); // Calculate CRC for the data part
-                if (calculatedCrc == receivedCrc) { // Check if calculated CRC matches received CRC
-                    QStringList dataList = dataPart.split(' '); // Split data part into roll and pitch values
-                    if (dataList.size() == 2) {
-                        bool ok1, ok2;
-                        double rollValue = dataList[0].mid(1).toDouble(&ok1); // Extract roll value (skip 'b' at the beginning)
-                        double pitchValue = dataList[1].toDouble(&ok2); // Extract pitch value
-
-                        if (ok1 && ok2) { // Check if both values were converted successfully
-                            emit newData(rollValue, pitchValue); // Emit newData signal with the extracted values
-                        }
-                    }
-                } else {
-                    qDebug() << "CRC mismatch!"; // Log CRC mismatch
-                }
-            } else {
-                qDebug() << "Invalid CRC format!"; // Log invalid CRC format
-            }
+ * This runs once per wake-up from the worker, however many samples were
+ * queued in the meantime. Samples are taken from the queue in blocks and
+ * transposed into a single column-wise batch that is emitted with the
+ * newSamples signal. The number of samples found and the time each of them
+ * waited since its read are recorded.
+ */
+void SerialManager::drainQueue(int port)
+{
+    SerialWorker *worker = ports.at(port).worker;
+    SampleBlock &batch = ports[port].batch;
+    batch.clear();
+
+    Sample samples[256];
+    std::size_t count;
+    while ((count = worker->takeSamples(samples, 256)) > 0) {
+        qint64 now = SampleClock::now();
+        for (std::size_t i = 0; i < count; ++i) {
+            batch.append(samples[i]);
+            latency.record(static_cast<quint64>(qMax<qint64>(0, now - samples[i].readTime)));
         }
     }
+
+    if (!batch.isEmpty()) {
+        queueDepth.record(static_cast<quint64>(batch.size()));
+        emit newSamples(port, batch);
+    }
 }
@@ -0,0 +1,313 @@
+#include "SerialWorker.h"
+#include "SampleClock.h"
+#include "Tracer.h"
+#include <QDebug>
+#include <algorithm>
+
+static_assert(static_cast<int>(Frame::MaxChannels) == ChannelSchema::MaxChannels,
+              "A decoded frame must fit into a sample");
+
+const int SerialWorker::MaxReadFrames;
+
+/**
+ * @brief Constructs a SerialWorker object.
+ * @param parent The parent object.
+ *
+ * The serial port itself is not created here but in open(), so that it
+ * belongs to the thread the worker has been moved to.
+ */
+SerialWorker::SerialWorker(QObject *parent)
+    : QObject(parent), serial(nullptr), replay(nullptr), device(nullptr), readFrameCount(0), notifyPending(false)
+    , received(0), frames(0), crcErrors(0), formatErrors(0), overflows(0), dropped(0), lost(0)
+{
+}
+
+/**
+ * @brief Destructor for SerialWorker.
+ *
+ * This destructor ensures that the serial port or replay is properly closed
+ * if it is still open when the SerialWorker object is destroyed.
+ */
+SerialWorker::~SerialWorker()
+{
+    closeDevice();
+    capture.close();
+}
+
+/**
+ * @brief Replaces the filters applied to every read.
+ * @param description The filter stages, see FilterChain; must have been validated against the schema.
+ * @param schema The channels of the samples.
+ *
+ * Runs on the acquisition thread between reads, so the chain is never
+ * swapped while frames are being filtered.
+ */
+void SerialWorker::setFilters(const QString &description, const ChannelSchema &schema)
+{
+    if (!filters.configure(description, schema)) {
+        Tracer::warning(Tracer::Serial, "Invalid filters ignored, the previous filters stay in use");
+    }
+}
+
+/**
+ * @brief Removes decoded samples from the queue. Must only be called from the consumer thread.
+ * @param samples Receives the removed samples.
+ * @param maxCount The maximum number of samples to remove.
+ * @return The number of samples removed.
+ *
+ * The pending flag is cleared before the queue is read. A sample pushed after
+ * that point therefore either ends up in this batch or raises a new
+ * samplesAvailable() signal, so no wake-up can be lost.
+ */
+std::size_t SerialWorker::takeSamples(Sample *samples, std::size_t maxCount)
+{
+    notifyPending.store(false, std::memory_order_release);
+    return queue.pop(samples, maxCount);
+}
+
+/**
+ * @brief Gets the number of frames dropped because the queue was full.
+ * @return The number of dropped frames.
+ */
+quint64 SerialWorker::droppedFrames() const
+{
+    return dropped.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Gets the traffic counters of the port. May be called from any thread.
+ * @return A snapshot of the counters since the worker was created.
+ *
+ * The counters are read one by one, so a snapshot taken while data is
+ * arriving may be off by the frames of a single read.
+ */
+PortStats SerialWorker::stats() const
+{
+    PortStats result;
+    result.bytesRead = received.load(std::memory_order_relaxed);
+    result.frames = frames.load(std::memory_order_relaxed);
+    result.crcErrors = crcErrors.load(std::memory_order_relaxed);
+    result.formatErrors = formatErrors.load(std::memory_order_relaxed);
+    result.overflows = overflows.load(std::memory_order_relaxed);
+    result.droppedFrames = dropped.load(std::memory_order_relaxed);
+    result.lostFrames = lost.load(std::memory_order_relaxed);
+    return result;
+}
+
+/**
+ * @brief Gets the time spent decoding and queueing the frames of each read. May be read from any thread.
+ * @return The histogram of durations in nanoseconds.
+ */
+const Histogram &SerialWorker::parseTime() const
+{
+    return parseDurations;
+}
+
+/**
+ * @brief Opens the serial port and starts reading.
+ * @param portName The name of the serial port.
+ * @param baudRate The baud rate for the serial communication.
+ *
+ * This method configures the serial port with the specified port name and
+ * baud rate, sets the data format to 8 data bits, no parity, one stop bit, and
+ * no flow control. It then attempts to open the serial port in read-only mode
+ * and emits the serialPortOpened signal with the result.
+ */
+void SerialWorker::open(const QString &portName, qint32 baudRate)
+{
+    if (!serial) {
+        serial = new QSerialPort(this);
+        connect(serial, &QSerialPort::readyRead, this, &SerialWorker::readSerialData);
+    }
+    closeDevice();
+    parser.reset();
+    timestamper.reset();
+    filters.reset();
+
+    serial->setPortName(portName);
+    serial->setBaudRate(baudRate);
+    serial->setDataBits(QSerialPort::Data8);
+    serial->setParity(QSerialPort::NoParity);
+    serial->setStopBits(QSerialPort::OneStop);
+    serial->setFlowControl(QSerialPort::NoFlowControl);
+
+    if (serial->open(QIODevice::ReadOnly)) {
+        device = serial;
+        emit serialPortOpened(true); // Emit signal indicating port is open
+        qDebug() << "Serial port opened successfully!";
+    } else {
+        emit serialPortOpened(false); // Emit signal indicating port failed to open
+        qDebug() << "Failed to open port!";
+    }
+}
+
+/**
+ * @brief Closes the serial port.
+ *
+ * This method closes the serial port or replay if it is open and emits the
+ * serialPortOpened signal with a value of false to indicate that the port is
+ * closed. A replay is closed this way when it reaches its end.
+ */
+void SerialWorker::close()
+{
+    if (device) {
+        closeDevice();
+        emit serialPortOpened(false); // Emit signal indicating port is closed
+    }
+}
+
+/**
+ * @brief Replays a capture file instead of reading a serial port.
+ * @param path The capture file.
+ * @param speed The replay speed: 1 for real time, N for N times faster, 0 for as fast as possible.
+ *
+ * The serialPortOpened signal is emitted with the result, as for a port.
+ */
+void SerialWorker::openReplay(const QString &path, double speed)
+{
+    if (!replay) {
+        replay = new ReplayDevice(this);
+        connect(replay, &QIODevice::readyRead, this, &SerialWorker::readSerialData);
+        connect(replay, &ReplayDevice::finished, this, &SerialWorker::close);
+    }
+    closeDevice();
+    parser.reset();
+    timestamper.reset();
+    filters.reset();
+
+    if (replay->openCapture(path, speed)) {
+        device = replay;
+        emit serialPortOpened(true);
+    } else {
+        emit serialPortOpened(false);
+        qDebug() << "Failed to open capture file!";
+    }
+}
+
+/**
+ * @brief Starts recording the bytes read into a capture file.
+ * @param path The capture file; an existing file is replaced.
+ */
+void SerialWorker::startCapture(const QString &path)
+{
+    if (!capture.open(path)) {
+        qWarning() << "Cannot create capture file" << path;
+    }
+}
+
+/**
+ * @brief Stops recording.
+ */
+void SerialWorker::stopCapture()
+{
+    capture.close();
+}
+
+/**
+ * @brief Closes the current byte source without emitting any signal.
+ */
+void SerialWorker::closeDevice()
+{
+    if (device) {
+        device->close();
+        device = nullptr;
+    }
+}
+
+/**
+ * @brief Slot to read data from the serial port.
+ *
+ * Reads all available data straight into the ring buffer of the frame parser
+ * and decodes every complete line. The time is taken on the monotonic
+ * SampleClock as soon as each read returns; the valid frames of the read are
+ * then stamped and filtered together and pushed into the queue. The time this takes is
+ * recorded per read. If the consumer has not been notified since its last
+ * drain, a single samplesAvailable() signal is emitted for the whole read.
+ */
+void SerialWorker::readSerialData()
+{
+    bool queued = false;
+
+    for (;;) {
+        std::size_t size;
+        char *target = parser.writeBuffer(size);
+        qint64 bytesRead = device->read(target, static_cast<qint64>(size)); // Read directly into the ring buffer
+        qint64 readTime = SampleClock::now(); // Acquisition time of this read
+        if (bytesRead > 0) {
+            if (capture.isOpen()) {
+                capture.write(readTime, target, bytesRead);
+            }
+            parser.commit(static_cast<std::size_t>(bytesRead));
+            received.fetch_add(static_cast<quint64>(bytesRead), std::memory_order_relaxed);
+        }
+
+        Frame frame;
+        FrameParser::Status status;
+        while ((status = parser.next(frame)) != FrameParser::Status::NeedMoreData) { // Process complete lines of data
+            switch (status) {
+            case FrameParser::Status::Frame: {
+                if (readFrameCount == MaxReadFrames) {
+                    queued = queueFrames(readTime) || queued; // Unusually many frames in one read
+                }
+                Sample &sample = readFrames[readFrameCount++];
+                sample.sequence = frame.sequenced ? static_cast<qint64>(frame.sequence) : -1;
+                sample.deviceTime = frame.sequenced ? static_cast<qint64>(frame.deviceTime) : -1;
+                sample.channelCount = static_cast<int>(frame.channelCount);
+                std::copy(frame.values, frame.values + frame.channelCount, sample.values);
+                break;
+            }
+            case FrameParser::Status::CrcMismatch:
+                crcErrors.fetch_add(1, std::memory_order_relaxed);
+                break;
+            case FrameParser::Status::InvalidCrc:
+                crcErrors.fetch_add(1, std::memory_order_relaxed);
+                break;
+            case FrameParser::Status::InvalidFormat:
+                formatErrors.fetch_add(1, std::memory_order_relaxed);
+                break;
+            case FrameParser::Status::Overflow:
+                overflows.fetch_add(1, std::memory_order_relaxed);
+                break;
+            default:
+                break;
+            }
+        }
+        queued = queueFrames(readTime) || queued;
+        parseDurations.record(static_cast<quint64>(SampleClock::now() - readTime));
+
+        if (bytesRead <= 0 || device->bytesAvailable() == 0) {
+            break; // Everything available has been consumed
+        }
+    }
+
+    if (queued && !notifyPending.exchange(true, std::memory_order_acq_rel)) {
+        emit samplesAvailable(); // One wake-up for everything queued since the last drain
+    }
+}
+
+/**
+ * @brief Stamps and filters the frames collected from a read and pushes them into the queue.
+ * @param readTime The time the read returned.
+ * @return True if at least one frame was queued.
+ */
+bool SerialWorker::queueFrames(qint64 readTime)
+{
+    if (readFrameCount == 0) {
+        return false;
+    }
+    timestamper.stamp(readFrames, readFrameCount, readTime);
+    lost.store(timestamper.lostFrames(), std::memory_order_relaxed);
+    filters.process(readFrames, readFrameCount); // After stamping, so time-based filters see sampling times
+
+    bool queued = false;
+    for (int i = 0; i < readFrameCount; ++i) {
+        if (queue.push(readFrames[i])) {
+            queued = true;
+            frames.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            dropped.fetch_add(1, std::memory_order_relaxed); // Consumer is not keeping up
+        }
+    }
+    readFrameCount = 0;
+    return queued;
+}
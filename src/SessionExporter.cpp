@@ -0,0 +1,340 @@
+#include "SessionExporter.h"
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+const int SessionExporter::BufferSize;
+const int SessionExporter::MaxNumberLength;
+
+namespace {
+
+/**
+ * @brief Longest CSV row: timestamp, source and every channel with their separators.
+ */
+const int maxRowLength = (2 + ChannelSchema::MaxChannels) * (SessionExporter::MaxNumberLength + 1) + 1;
+
+/**
+ * @class OutputFile
+ * @brief An unbuffered file written through a large buffer of its own.
+ *
+ * Formatting writes straight into the buffer, which is written out with a
+ * single call whenever the next piece may not fit.
+ */
+class OutputFile
+{
+public:
+    /**
+     * @brief Creates the file, replacing an existing one.
+     * @param path The file.
+     * @param bufferSize The number of bytes collected per write.
+     * @return True if the file could be created.
+     */
+    bool open(const QString &path, int bufferSize)
+    {
+        file.setFileName(path);
+        buffer.resize(static_cast<std::size_t>(bufferSize));
+        used = 0;
+        failed = !file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered);
+        return !failed;
+    }
+
+    /**
+     * @brief Makes room for a number of bytes, writing the buffer out if needed.
+     * @param length The number of bytes, at most the buffer size.
+     * @return Where to write them; commit() them afterwards.
+     */
+    char *reserve(int length)
+    {
+        Q_ASSERT(length <= capacity());
+        if (used + length > static_cast<int>(buffer.size())) {
+            flush();
+        }
+        return buffer.data() + used;
+    }
+
+    /**
+     * @brief Gets the size of the buffer.
+     * @return The most bytes one reserve() may ask for.
+     */
+    int capacity() const
+    {
+        return static_cast<int>(buffer.size());
+    }
+
+    /**
+     * @brief Marks bytes written after reserve() as used.
+     * @param end One past the last byte written.
+     */
+    void commit(const char *end)
+    {
+        used = static_cast<int>(end - buffer.data());
+    }
+
+    /**
+     * @brief Appends bytes of any length.
+     * @param data The bytes.
+     * @param length The number of bytes.
+     */
+    void append(const char *data, qint64 length)
+    {
+        while (length > 0) {
+            int piece = static_cast<int>(qMin<qint64>(length, static_cast<qint64>(buffer.size())));
+            char *out = reserve(piece);
+            std::memcpy(out, data, static_cast<std::size_t>(piece));
+            commit(out + piece);
+            data += piece;
+            length -= piece;
+        }
+    }
+
+    /**
+     * @brief Writes the buffer out.
+     */
+    void flush()
+    {
+        if (used > 0 && file.write(buffer.data(), used) != used) {
+            failed = true;
+        }
+        used = 0;
+    }
+
+    /**
+     * @brief Writes the buffer out and closes the file.
+     * @return True if every write succeeded.
+     */
+    bool close()
+    {
+        flush();
+        file.close();
+        return !failed;
+    }
+
+private:
+    QFile file;               ///< The output file, opened unbuffered.
+    std::vector<char> buffer; ///< Bytes not written yet.
+    int used = 0;             ///< Number of bytes in the buffer.
+    bool failed = false;      ///< True once a write failed.
+};
+
+/**
+ * @brief Writes an integer in decimal.
+ * @param out Receives the text; must hold SessionExporter::MaxNumberLength bytes.
+ * @param value The value.
+ * @return One past the last byte written.
+ */
+char *formatInteger(char *out, qint64 value)
+{
+    return std::to_chars(out, out + SessionExporter::MaxNumberLength, value).ptr;
+}
+
+/**
+ * @brief Turns a channel name into a file name.
+ * @param name The channel name.
+ * @return The name with everything but letters and digits replaced by '_'.
+ */
+QString fileNameOf(const QString &name)
+{
+    QString result = name;
+    for (QChar &c : result) {
+        if (!c.isLetterOrNumber()) {
+            c = '_';
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+/**
+ * @brief Exports a session as CSV.
+ * @param session The open session.
+ * @param path The CSV file; an existing file is replaced.
+ * @return True if the whole session was written.
+ *
+ * The header row names the columns, with the unit of each channel in
+ * brackets. Timestamps are nanoseconds since the epoch. Numbers are
+ * formatted with std::to_chars, which is locale independent and much
+ * faster than going through QString; NaN values are left empty.
+ */
+bool SessionExporter::exportCsv(const SessionFile &session, const QString &path)
+{
+    OutputFile out;
+    if (!out.open(path, BufferSize)) {
+        return false;
+    }
+
+    const ChannelSchema &schema = session.schema();
+    const int channelCount = schema.channelCount();
+    const bool multiSource = session.sourceNames().size() > 1;
+
+    QStringList header("time_ns");
+    if (multiSource) {
+        header.append("source");
+    }
+    for (int channel = 0; channel < channelCount; ++channel) {
+        const ChannelDescriptor &descriptor = schema.channel(channel);
+        header.append(descriptor.unit.isEmpty() ? descriptor.name : QString("%1 [%2]").arg(descriptor.name, descriptor.unit));
+    }
+    QByteArray headerLine = header.join(',').toUtf8() + '\n';
+    out.append(headerLine.constData(), headerLine.size());
+
+    const double *columns[ChannelSchema::MaxChannels];
+    for (int chunk = 0; chunk < session.chunkCount(); ++chunk) {
+        const SessionChunk &entry = session.chunk(chunk);
+        const qint64 *times = session.timestamps(chunk);
+        for (int channel = 0; channel < channelCount; ++channel) {
+            columns[channel] = session.values(chunk, channel);
+        }
+
+        for (int i = 0; i < entry.count; ++i) {
+            char *row = out.reserve(maxRowLength);
+            row = formatInteger(row, times[i]);
+            if (multiSource) {
+                *row++ = ',';
+                row = formatInteger(row, entry.source);
+            }
+            for (int channel = 0; channel < channelCount; ++channel) {
+                *row++ = ',';
+                row = formatDouble(row, columns[channel][i]);
+            }
+            *row++ = '\n';
+            out.commit(row);
+        }
+    }
+    return out.close();
+}
+
+/**
+ * @brief Exports a session as one binary file per column.
+ * @param session The open session.
+ * @param directory The directory to write into; created if needed.
+ * @return True if the whole session was written.
+ *
+ * The files are time.i64 (nanoseconds since the epoch), source.i32 when
+ * the session has more than one device, and one <position>_<name>.f64 per
+ * channel, all little-endian. Every chunk appends its columns straight from the
+ * mapping, so no value is converted. columns.json lists the files with
+ * their names, types and units, the device names and the row count.
+ */
+bool SessionExporter::exportColumns(const SessionFile &session, const QString &directory)
+{
+    QDir dir(directory);
+    if (!dir.mkpath(".")) {
+        return false;
+    }
+
+    const ChannelSchema &schema = session.schema();
+    const int channelCount = schema.channelCount();
+    const bool multiSource = session.sourceNames().size() > 1;
+
+    QJsonArray columnList;
+    auto addColumn = [&columnList](const QString &name, const QString &file, const QString &type, const QString &unit) {
+        QJsonObject column;
+        column["name"] = name;
+        column["file"] = file;
+        column["type"] = type;
+        column["unit"] = unit;
+        columnList.append(column);
+    };
+    addColumn("time", "time.i64", "int64", "ns");
+    if (multiSource) {
+        addColumn("source", "source.i32", "int32", QString());
+    }
+    for (int channel = 0; channel < channelCount; ++channel) {
+        const ChannelDescriptor &descriptor = schema.channel(channel);
+        addColumn(descriptor.name, QString("%1_%2.f64").arg(channel).arg(fileNameOf(descriptor.name)), "float64", descriptor.unit);
+    }
+
+    // The buffer is shared out among the columns, so every file still gets large writes
+    const int fileCount = columnList.size();
+    const int bufferSize = qMax(BufferSize / fileCount, 256 * 1024);
+    std::vector<std::unique_ptr<OutputFile>> files;
+    for (int i = 0; i < fileCount; ++i) {
+        files.emplace_back(new OutputFile());
+        if (!files.back()->open(dir.filePath(columnList.at(i).toObject()["file"].toString()), bufferSize)) {
+            return false;
+        }
+    }
+
+    const int firstChannelFile = multiSource ? 2 : 1;
+    qint64 rows = 0;
+    for (int chunk = 0; chunk < session.chunkCount(); ++chunk) {
+        const SessionChunk &entry = session.chunk(chunk);
+        const qint64 length = static_cast<qint64>(entry.count) * 8;
+        files[0]->append(reinterpret_cast<const char *>(session.timestamps(chunk)), length);
+        if (multiSource) {
+            // A chunk may hold more samples than fit into the buffer at once
+            for (int written = 0; written < entry.count;) {
+                const int piece = qMin(entry.count - written, files[1]->capacity() / 4);
+                char *out = files[1]->reserve(piece * 4);
+                for (int i = 0; i < piece; ++i) {
+                    std::memcpy(out + 4 * i, &entry.source, 4);
+                }
+                files[1]->commit(out + piece * 4);
+                written += piece;
+            }
+        }
+        for (int channel = 0; channel < channelCount; ++channel) {
+            files[firstChannelFile + channel]->append(reinterpret_cast<const char *>(session.values(chunk, channel)), length);
+        }
+        rows += entry.count;
+    }
+
+    bool written = true;
+    for (std::unique_ptr<OutputFile> &file : files) {
+        written = file->close() && written;
+    }
+
+    QJsonObject manifest;
+    manifest["rows"] = rows;
+    manifest["byteOrder"] = "little";
+    manifest["sources"] = QJsonArray::fromStringList(session.sourceNames());
+    manifest["columns"] = columnList;
+    QFile manifestFile(dir.filePath("columns.json"));
+    return written && manifestFile.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        && manifestFile.write(QJsonDocument(manifest).toJson()) > 0;
+}
+
+/**
+ * @brief Exports a session in the format matching the path.
+ * @param session The open session.
+ * @param path A ".csv" file for CSV, otherwise a directory for the columnar export.
+ * @return True if the whole session was written.
+ */
+bool SessionExporter::exportSession(const SessionFile &session, const QString &path)
+{
+    if (path.endsWith(".csv", Qt::CaseInsensitive)) {
+        return exportCsv(session, path);
+    }
+    return exportColumns(session, path);
+}
+
+/**
+ * @brief Writes the shortest text that reads back as the same double.
+ * @param out Receives the text; must hold MaxNumberLength bytes.
+ * @param value The value; NaN is written as an empty field.
+ * @return One past the last byte written.
+ *
+ * Sensor values such as 12.34 come out exactly as the device sent them.
+ * Standard libraries without floating-point std::to_chars fall back to
+ * snprintf with enough digits to round-trip.
+ */
+char *SessionExporter::formatDouble(char *out, double value)
+{
+    if (std::isnan(value)) {
+        return out;
+    }
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    return std::to_chars(out, out + MaxNumberLength, value).ptr;
+#else
+    return out + std::snprintf(out, MaxNumberLength, "%.17g", value);
+#endif
+}
@@ -0,0 +1,260 @@
+#include "SessionFile.h"
+#include <QtEndian>
+#include <algorithm>
+
+static_assert(Q_BYTE_ORDER == Q_LITTLE_ENDIAN, "Session columns are used in place and are stored little-endian");
+
+const char SessionFile::Magic[8] = { 'W', 'D', 'S', 'R', 'E', 'C', '\0', '\2' }; // Version 2: nanosecond timestamps
+const char SessionFile::IndexMagic[8] = { 'W', 'D', 'S', 'I', 'D', 'X', '\0', '\1' };
+const int SessionFile::ChunkHeaderLength;
+const int SessionFile::IndexEntryLength;
+const int SessionFile::TrailerLength;
+
+/**
+ * @brief Constructs a closed SessionFile.
+ */
+SessionFile::SessionFile()
+    : data(nullptr), size(0), indexed(false)
+{
+}
+
+/**
+ * @brief Opens and maps a session file.
+ * @param path The file.
+ * @return True if the file could be mapped and starts with Magic.
+ *
+ * Only the header and the index are read here; the pages holding the
+ * samples are loaded by the operating system when a column is first used.
+ */
+bool SessionFile::open(const QString &path)
+{
+    close();
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    size = file.size();
+    data = size >= static_cast<qint64>(sizeof(Magic)) + 8 ? file.map(0, size) : nullptr;
+    if (!data || !std::equal(Magic, Magic + sizeof(Magic), data)) {
+        close();
+        return false;
+    }
+
+    const quint32 schemaLength = qFromLittleEndian<quint32>(data + 8);
+    const quint32 namesLength = qFromLittleEndian<quint32>(data + 12);
+    const qint64 textStart = 16;
+    const qint64 dataStart = (textStart + schemaLength + namesLength + 7) & ~qint64(7);
+    if (dataStart > size) {
+        close();
+        return false;
+    }
+    const char *text = reinterpret_cast<const char *>(data + textStart);
+    sessionSchema = ChannelSchema::fromString(QString::fromUtf8(text, static_cast<int>(schemaLength)));
+    sources = QString::fromUtf8(text + schemaLength, static_cast<int>(namesLength)).split('\n');
+
+    indexed = readIndex(dataStart);
+    if (!indexed) {
+        scanChunks(dataStart);
+    }
+    return true;
+}
+
+/**
+ * @brief Unmaps and closes the file.
+ */
+void SessionFile::close()
+{
+    if (data) {
+        file.unmap(const_cast<uchar *>(data));
+        data = nullptr;
+    }
+    file.close();
+    size = 0;
+    sessionSchema = ChannelSchema();
+    sources.clear();
+    chunks.clear();
+    indexed = false;
+}
+
+/**
+ * @brief Checks if a file is open.
+ * @return True if a session is mapped.
+ */
+bool SessionFile::isOpen() const
+{
+    return data != nullptr;
+}
+
+/**
+ * @brief Checks if the session was closed properly.
+ * @return True if the chunks were read from the index, false if they were recovered by walking the file.
+ */
+bool SessionFile::isIndexed() const
+{
+    return indexed;
+}
+
+/**
+ * @brief Gets the channels of the recorded samples.
+ * @return The channel schema.
+ */
+const ChannelSchema &SessionFile::schema() const
+{
+    return sessionSchema;
+}
+
+/**
+ * @brief Gets the names of the recorded devices.
+ * @return One name per source index.
+ */
+const QStringList &SessionFile::sourceNames() const
+{
+    return sources;
+}
+
+/**
+ * @brief Gets the number of chunks.
+ * @return The number of chunks.
+ */
+int SessionFile::chunkCount() const
+{
+    return chunks.size();
+}
+
+/**
+ * @brief Gets the index entry of a chunk.
+ * @param chunk The position of the chunk, 0 being the oldest.
+ * @return The index entry.
+ */
+const SessionChunk &SessionFile::chunk(int chunk) const
+{
+    return chunks.at(chunk);
+}
+
+/**
+ * @brief Gets the timestamp column of a chunk.
+ * @param chunk The position of the chunk.
+ * @return chunk(chunk).count timestamps in nanoseconds since the epoch, in the mapping.
+ */
+const qint64 *SessionFile::timestamps(int chunk) const
+{
+    return reinterpret_cast<const qint64 *>(data + chunks.at(chunk).offset + ChunkHeaderLength);
+}
+
+/**
+ * @brief Gets the column of a channel in a chunk.
+ * @param chunk The position of the chunk.
+ * @param channel The position of the channel.
+ * @return chunk(chunk).count values, in the mapping.
+ */
+const double *SessionFile::values(int chunk, int channel) const
+{
+    const SessionChunk &entry = chunks.at(chunk);
+    const qint64 column = static_cast<qint64>(entry.count) * 8 * (1 + channel);
+    return reinterpret_cast<const double *>(data + entry.offset + ChunkHeaderLength + column);
+}
+
+/**
+ * @brief Copies the samples of a chunk into a block.
+ * @param chunk The position of the chunk.
+ * @param block Receives the samples; previous contents are discarded.
+ *
+ * The block gets one column per channel of the schema, copied column by
+ * column.
+ */
+void SessionFile::read(int chunk, SampleBlock &block) const
+{
+    const int channelCount = sessionSchema.channelCount();
+    const double *columns[ChannelSchema::MaxChannels];
+    for (int channel = 0; channel < channelCount; ++channel) {
+        columns[channel] = values(chunk, channel);
+    }
+    block.reset(channelCount);
+    block.append(timestamps(chunk), columns, chunks.at(chunk).count);
+}
+
+/**
+ * @brief Gets the size of a chunk.
+ * @param count The number of samples.
+ * @param channelCount The number of channels.
+ * @return The number of bytes including the chunk header.
+ */
+qint64 SessionFile::chunkLength(int count, int channelCount)
+{
+    return ChunkHeaderLength + static_cast<qint64>(count) * 8 * (1 + channelCount);
+}
+
+/**
+ * @brief Reads the chunk list from the index at the end of the file.
+ * @param dataStart The position of the first chunk.
+ * @return True if a valid index was found.
+ *
+ * Every entry is checked against the file size, so a damaged index is
+ * rejected as a whole and the chunks are recovered by walking instead.
+ * Offsets are checked before anything is added to them, so no sum can
+ * overflow.
+ */
+bool SessionFile::readIndex(qint64 dataStart)
+{
+    if (size < dataStart + TrailerLength) {
+        return false;
+    }
+    const uchar *trailer = data + size - TrailerLength;
+    if (!std::equal(IndexMagic, IndexMagic + sizeof(IndexMagic), trailer + 16)) {
+        return false;
+    }
+    const qint64 indexOffset = qFromLittleEndian<qint64>(trailer);
+    const qint64 count = qFromLittleEndian<qint64>(trailer + 8);
+    const qint64 indexEnd = size - TrailerLength;
+    if (indexOffset < dataStart || indexOffset > indexEnd || count < 0
+        || count != (indexEnd - indexOffset) / IndexEntryLength || (indexEnd - indexOffset) % IndexEntryLength != 0) {
+        return false;
+    }
+
+    const int channelCount = sessionSchema.channelCount();
+    chunks.resize(static_cast<int>(count));
+    for (int i = 0; i < chunks.size(); ++i) {
+        const uchar *entry = data + indexOffset + static_cast<qint64>(i) * IndexEntryLength;
+        SessionChunk &chunk = chunks[i];
+        chunk.offset = qFromLittleEndian<qint64>(entry);
+        chunk.source = qFromLittleEndian<qint32>(entry + 8);
+        chunk.count = qFromLittleEndian<qint32>(entry + 12);
+        chunk.first = qFromLittleEndian<qint64>(entry + 16);
+        chunk.last = qFromLittleEndian<qint64>(entry + 24);
+        if (chunk.offset < dataStart || chunk.offset > indexOffset || chunk.count < 0
+            || chunkLength(chunk.count, channelCount) > indexOffset - chunk.offset) {
+            chunks.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Builds the chunk list by walking the chunks from the header.
+ * @param dataStart The position of the first chunk.
+ *
+ * The walk stops at the first chunk that does not fit into the file, which
+ * is where an interrupted recording was cut off.
+ */
+void SessionFile::scanChunks(qint64 dataStart)
+{
+    const int channelCount = sessionSchema.channelCount();
+    chunks.clear();
+    qint64 offset = dataStart;
+    while (offset + ChunkHeaderLength <= size) {
+        SessionChunk chunk;
+        chunk.offset = offset;
+        chunk.source = qFromLittleEndian<qint32>(data + offset);
+        chunk.count = qFromLittleEndian<qint32>(data + offset + 4);
+        const qint64 length = chunkLength(chunk.count, channelCount);
+        if (chunk.count <= 0 || offset + length > size) {
+            break;
+        }
+        const qint64 *times = reinterpret_cast<const qint64 *>(data + offset + ChunkHeaderLength);
+        chunk.first = times[0];
+        chunk.last = times[chunk.count - 1];
+        chunks.append(chunk);
+        offset += length;
+    }
+}
@@ -0,0 +1,311 @@
+#include "SessionRecorder.h"
+#include "SessionFile.h"
+#include <QFile>
+#include <QtEndian>
+#include <cstring>
+
+const int SessionRecorder::ChunkSamples;
+
+/**
+ * @class SessionWriter
+ * @brief Appends chunks to a session file; lives on the writer thread of a SessionRecorder.
+ */
+class SessionWriter : public QObject
+{
+public:
+    /**
+     * @brief Constructs a SessionWriter object.
+     * @param written Receives the number of bytes written.
+     */
+    explicit SessionWriter(std::atomic<quint64> &written);
+
+    /**
+     * @brief Creates the file and writes its header.
+     * @param path The file; an existing file is replaced.
+     * @param schema The channels of the samples.
+     * @param sourceNames The names of the devices.
+     * @return True if the header was written.
+     */
+    bool open(const QString &path, const ChannelSchema &schema, const QStringList &sourceNames);
+
+    /**
+     * @brief Appends one chunk.
+     * @param source The index of the device.
+     * @param samples The samples of the chunk.
+     */
+    void writeChunk(int source, const SampleBlock &samples);
+
+    /**
+     * @brief Appends the index and the trailer and closes the file.
+     */
+    void finish();
+
+private:
+    QFile file;                   ///< The session file.
+    QVector<SessionChunk> index;  ///< The chunks written so far.
+    QByteArray buffer;            ///< The chunk being laid out, reused between chunks.
+    std::atomic<quint64> &written; ///< Bytes written to the file.
+};
+
+/**
+ * @brief Constructs a SessionWriter object.
+ * @param written Receives the number of bytes written.
+ */
+SessionWriter::SessionWriter(std::atomic<quint64> &written)
+    : written(written)
+{
+}
+
+/**
+ * @brief Creates the file and writes its header.
+ * @param path The file; an existing file is replaced.
+ * @param schema The channels of the samples.
+ * @param sourceNames The names of the devices.
+ * @return True if the header was written.
+ *
+ * The file is opened unbuffered: every chunk is laid out in memory first
+ * and then written with one call, which is larger than any buffer would be.
+ */
+bool SessionWriter::open(const QString &path, const ChannelSchema &schema, const QStringList &sourceNames)
+{
+    index.clear();
+    written.store(0, std::memory_order_relaxed);
+    file.setFileName(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        return false;
+    }
+
+    QByteArray schemaText = schema.toString().toUtf8();
+    QByteArray names = sourceNames.join('\n').toUtf8();
+    QByteArray header(16, 0);
+    std::memcpy(header.data(), SessionFile::Magic, sizeof(SessionFile::Magic));
+    qToLittleEndian<quint32>(static_cast<quint32>(schemaText.size()), header.data() + 8);
+    qToLittleEndian<quint32>(static_cast<quint32>(names.size()), header.data() + 12);
+    header.append(schemaText).append(names);
+    header.append((8 - header.size() % 8) % 8, '\0'); // Align the first chunk
+
+    if (file.write(header) != header.size()) {
+        file.close();
+        return false;
+    }
+    written.store(static_cast<quint64>(header.size()), std::memory_order_relaxed);
+    return true;
+}
+
+/**
+ * @brief Appends one chunk.
+ * @param source The index of the device.
+ * @param samples The samples of the chunk.
+ *
+ * The chunk header, the timestamp column and the channel columns are copied
+ * into one buffer and written together. A chunk that cannot be written is
+ * left out of the index.
+ */
+void SessionWriter::writeChunk(int source, const SampleBlock &samples)
+{
+    if (!file.isOpen() || samples.isEmpty()) {
+        return;
+    }
+    const int count = samples.size();
+    const std::size_t columnLength = static_cast<std::size_t>(count) * 8;
+    buffer.resize(static_cast<int>(SessionFile::chunkLength(count, samples.channelCount())));
+
+    char *out = buffer.data();
+    qToLittleEndian<qint32>(source, out);
+    qToLittleEndian<qint32>(count, out + 4);
+    out += SessionFile::ChunkHeaderLength;
+    std::memcpy(out, samples.timestamps(), columnLength);
+    for (int channel = 0; channel < samples.channelCount(); ++channel) {
+        out += columnLength;
+        std::memcpy(out, samples.channel(channel), columnLength);
+    }
+
+    SessionChunk chunk;
+    chunk.offset = file.pos();
+    chunk.source = source;
+    chunk.count = count;
+    chunk.first = samples.timestamp(0);
+    chunk.last = samples.timestamp(count - 1);
+    if (file.write(buffer) == buffer.size()) {
+        index.append(chunk);
+        written.fetch_add(static_cast<quint64>(buffer.size()), std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Appends the index and the trailer and closes the file.
+ */
+void SessionWriter::finish()
+{
+    if (!file.isOpen()) {
+        return;
+    }
+    const qint64 indexOffset = file.pos();
+    buffer.resize(index.size() * SessionFile::IndexEntryLength + SessionFile::TrailerLength);
+
+    char *out = buffer.data();
+    for (const SessionChunk &chunk : qAsConst(index)) {
+        qToLittleEndian<qint64>(chunk.offset, out);
+        qToLittleEndian<qint32>(chunk.source, out + 8);
+        qToLittleEndian<qint32>(chunk.count, out + 12);
+        qToLittleEndian<qint64>(chunk.first, out + 16);
+        qToLittleEndian<qint64>(chunk.last, out + 24);
+        out += SessionFile::IndexEntryLength;
+    }
+    qToLittleEndian<qint64>(indexOffset, out);
+    qToLittleEndian<qint64>(index.size(), out + 8);
+    std::memcpy(out + 16, SessionFile::IndexMagic, sizeof(SessionFile::IndexMagic));
+
+    file.write(buffer);
+    file.close();
+    index.clear();
+    buffer.clear();
+    buffer.squeeze();
+}
+
+/**
+ * @brief Constructs a SessionRecorder object and starts its writer thread.
+ * @param parent The parent object.
+ */
+SessionRecorder::SessionRecorder(QObject *parent)
+    : QObject(parent), writer(new SessionWriter(written)), channelCount(0), recording(false), written(0)
+{
+    thread.setObjectName("SessionWriter");
+    writer->moveToThread(&thread);
+    connect(&thread, &QThread::finished, writer, &QObject::deleteLater);
+    thread.start();
+}
+
+/**
+ * @brief Stops recording and the writer thread.
+ *
+ * A running recording is completed, so the file is indexed.
+ */
+SessionRecorder::~SessionRecorder()
+{
+    stop();
+    thread.quit();
+    thread.wait();
+}
+
+/**
+ * @brief Creates a session file and starts recording into it.
+ * @param path The file; an existing file is replaced.
+ * @param schema The channels of the samples.
+ * @param sourceNames The names of the devices, in source index order.
+ * @return True if the file could be created.
+ *
+ * A recording that is already running is stopped first. The file is
+ * created on the writer thread, and this waits for the result.
+ */
+bool SessionRecorder::start(const QString &path, const ChannelSchema &schema, const QStringList &sourceNames)
+{
+    stop();
+
+    bool opened = false;
+    SessionWriter *target = writer;
+    QMetaObject::invokeMethod(writer, [target, &opened, path, schema, sourceNames]() {
+        opened = target->open(path, schema, sourceNames);
+    }, Qt::BlockingQueuedConnection);
+    if (!opened) {
+        return false;
+    }
+
+    channelCount = schema.channelCount();
+    pending.clear();
+    for (int i = 0; i < qMax(sourceNames.size(), 1); ++i) {
+        pending.append(SampleBlock(channelCount));
+        pending.last().reserve(ChunkSamples);
+    }
+    recording = true;
+    return true;
+}
+
+/**
+ * @brief Records a batch of samples.
+ * @param samples The timestamped samples, oldest first, with one column per schema channel.
+ * @param source The index of the device the samples come from.
+ *
+ * The samples are copied column by column into the chunk of the device;
+ * every time it fills up, it is handed to the writer thread.
+ */
+void SessionRecorder::record(const SampleBlock &samples, int source)
+{
+    if (!recording || source < 0 || source >= pending.size() || samples.channelCount() != channelCount) {
+        return;
+    }
+
+    const double *columns[ChannelSchema::MaxChannels];
+    for (int offset = 0; offset < samples.size();) {
+        SampleBlock &chunk = pending[source];
+        const int count = qMin(samples.size() - offset, ChunkSamples - chunk.size());
+        for (int channel = 0; channel < channelCount; ++channel) {
+            columns[channel] = samples.channel(channel) + offset;
+        }
+        chunk.append(samples.timestamps() + offset, columns, count);
+        offset += count;
+        if (chunk.size() == ChunkSamples) {
+            submit(source);
+        }
+    }
+}
+
+/**
+ * @brief Writes the remaining samples and the index and closes the file.
+ *
+ * This waits until the writer thread has finished the file, so the session
+ * can be opened as soon as this returns.
+ */
+void SessionRecorder::stop()
+{
+    if (!recording) {
+        return;
+    }
+    for (int source = 0; source < pending.size(); ++source) {
+        if (!pending.at(source).isEmpty()) {
+            submit(source);
+        }
+    }
+    QMetaObject::invokeMethod(writer, [this]() {
+        writer->finish();
+    }, Qt::BlockingQueuedConnection);
+    pending.clear();
+    recording = false;
+}
+
+/**
+ * @brief Checks if a recording is running.
+ * @return True between start() and stop().
+ */
+bool SessionRecorder::isRecording() const
+{
+    return recording;
+}
+
+/**
+ * @brief Gets the number of bytes written to the current file so far.
+ * @return The number of bytes.
+ */
+quint64 SessionRecorder::bytesWritten() const
+{
+    return written.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Hands the collected samples of a device to the writer thread.
+ * @param source The index of the device.
+ *
+ * The chunk is passed on without copying its columns, and collecting starts
+ * over in a new block.
+ */
+void SessionRecorder::submit(int source)
+{
+    SampleBlock chunk(channelCount);
+    chunk.reserve(ChunkSamples);
+    std::swap(chunk, pending[source]);
+
+    SessionWriter *target = writer;
+    QMetaObject::invokeMethod(writer, [target, source, chunk]() {
+        target->writeChunk(source, chunk);
+    }, Qt::QueuedConnection);
+}
@@ -0,0 +1,470 @@
+#include "SignalFilter.h"
+#include <QtMath>
+#include <algorithm>
+
+const int MovingAverageFilter::MaxLength;
+const int MedianFilter::MaxLength;
+const int FirFilter::MaxTaps;
+
+/**
+ * @brief Constructs a filter.
+ * @param channelCount The number of channels of the samples; at most ChannelSchema::MaxChannels.
+ * @param channels The channels to filter, one bit per channel position.
+ */
+SignalFilter::SignalFilter(int channelCount, quint32 channels)
+    : channelCount(qBound(0, channelCount, static_cast<int>(ChannelSchema::MaxChannels)))
+{
+    for (int channel = 0; channel < ChannelSchema::MaxChannels; ++channel) {
+        selected[channel] = (channels >> channel) & 1;
+    }
+}
+
+/**
+ * @brief Destructor for SignalFilter.
+ */
+SignalFilter::~SignalFilter()
+{
+}
+
+/**
+ * @brief Constructs a moving average.
+ * @param channelCount The number of channels of the samples.
+ * @param channels The channels to filter, one bit per channel position.
+ * @param length The number of samples averaged, between 1 and MaxLength.
+ */
+MovingAverageFilter::MovingAverageFilter(int channelCount, quint32 channels, int length)
+    : SignalFilter(channelCount, channels), length(qBound(1, length, MaxLength))
+{
+    reset();
+}
+
+/**
+ * @brief Forgets all past samples; the next sample primes the filter again.
+ */
+void MovingAverageFilter::reset()
+{
+    position = 0;
+    primed = false;
+}
+
+/**
+ * @brief Filters samples in place.
+ * @param samples The samples, oldest first.
+ * @param count The number of samples.
+ *
+ * The first sample fills the whole history, as if the input had always
+ * been at that value.
+ */
+void MovingAverageFilter::process(Sample *samples, int count)
+{
+    const int n = channelCount;
+    const double scale = 1.0 / length;
+    for (int i = 0; i < count; ++i) {
+        double *x = samples[i].values;
+        if (samples[i].channelCount < n) {
+            continue;
+        }
+        if (!primed) {
+            for (int row = 0; row < length; ++row) {
+                std::copy(x, x + n, history[row]);
+            }
+            for (int c = 0; c < n; ++c) {
+                sum[c] = x[c] * length;
+            }
+            primed = true;
+        }
+
+        double *oldest = history[position];
+        for (int c = 0; c < n; ++c) {
+            sum[c] += x[c] - oldest[c];
+            oldest[c] = x[c];
+            x[c] = selected[c] ? sum[c] * scale : x[c];
+        }
+
+        if (++position == length) {
+            position = 0;
+            std::fill(sum, sum + n, 0.0); // Recompute the sums so rounding errors do not accumulate
+            for (int row = 0; row < length; ++row) {
+                for (int c = 0; c < n; ++c) {
+                    sum[c] += history[row][c];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Constructs a median filter.
+ * @param channelCount The number of channels of the samples.
+ * @param channels The channels to filter, one bit per channel position.
+ * @param length The number of samples the median is taken over, odd and at most MaxLength.
+ *
+ * An even length is rounded up to the next odd one.
+ */
+MedianFilter::MedianFilter(int channelCount, quint32 channels, int length)
+    : SignalFilter(channelCount, channels), length(qBound(1, length | 1, MaxLength))
+{
+    reset();
+}
+
+/**
+ * @brief Forgets all past samples; the next sample primes the filter again.
+ */
+void MedianFilter::reset()
+{
+    position = 0;
+    primed = false;
+}
+
+/**
+ * @brief Filters samples in place.
+ * @param samples The samples, oldest first.
+ * @param count The number of samples.
+ *
+ * The window of every selected channel is copied and partially sorted
+ * until the middle element is in place.
+ */
+void MedianFilter::process(Sample *samples, int count)
+{
+    const int n = channelCount;
+    double window[MaxLength];
+    for (int i = 0; i < count; ++i) {
+        double *x = samples[i].values;
+        if (samples[i].channelCount < n) {
+            continue;
+        }
+        for (int c = 0; c < n; ++c) {
+            if (!primed) {
+                std::fill(history[c], history[c] + length, x[c]);
+            }
+            history[c][position] = x[c];
+        }
+        primed = true;
+        position = position + 1 == length ? 0 : position + 1;
+
+        for (int c = 0; c < n; ++c) {
+            if (selected[c]) {
+                std::copy(history[c], history[c] + length, window);
+                std::nth_element(window, window + length / 2, window + length);
+                x[c] = window[length / 2];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Constructs an FIR filter.
+ * @param channelCount The number of channels of the samples.
+ * @param channels The channels to filter, one bit per channel position.
+ * @param coefficients The coefficients, newest sample first; at most MaxTaps are used.
+ */
+FirFilter::FirFilter(int channelCount, quint32 channels, const QVector<double> &coefficients)
+    : SignalFilter(channelCount, channels), taps(qBound(1, coefficients.size(), MaxTaps))
+{
+    std::fill(this->coefficients, this->coefficients + MaxTaps, 0.0);
+    std::copy(coefficients.constBegin(), coefficients.constBegin() + qMin(coefficients.size(), MaxTaps), this->coefficients);
+    if (coefficients.isEmpty()) {
+        this->coefficients[0] = 1.0;
+    }
+    reset();
+}
+
+/**
+ * @brief Designs a low-pass filter with a Hamming-windowed sinc.
+ * @param cutoff The cut-off frequency in Hz, above 0 and below half the sample rate.
+ * @param sampleRate The sample rate in Hz.
+ * @param taps The number of coefficients, at most MaxTaps.
+ * @return The coefficients, scaled to a gain of 1 for constant input.
+ *
+ * The filter has linear phase and delays the signal by (taps - 1) / 2
+ * samples.
+ */
+QVector<double> FirFilter::lowPass(double cutoff, double sampleRate, int taps)
+{
+    taps = qBound(1, taps, MaxTaps);
+    const double fc = qBound(0.0, cutoff / sampleRate, 0.5);
+    const double middle = (taps - 1) / 2.0;
+    QVector<double> coefficients(taps);
+    double sum = 0;
+    for (int k = 0; k < taps; ++k) {
+        const double t = k - middle;
+        const double sinc = t == 0 ? 2 * fc : qSin(2 * M_PI * fc * t) / (M_PI * t);
+        const double window = taps == 1 ? 1.0 : 0.54 - 0.46 * qCos(2 * M_PI * k / (taps - 1));
+        coefficients[k] = sinc * window;
+        sum += coefficients[k];
+    }
+    for (double &coefficient : coefficients) {
+        coefficient /= sum;
+    }
+    return coefficients;
+}
+
+/**
+ * @brief Forgets all past samples; the next sample primes the filter again.
+ */
+void FirFilter::reset()
+{
+    position = 0;
+    primed = false;
+}
+
+/**
+ * @brief Filters samples in place.
+ * @param samples The samples, oldest first.
+ * @param count The number of samples.
+ *
+ * Every sample is written at position and position + taps, moving
+ * backwards, so rows position to position + taps - 1 always hold the last
+ * taps samples, newest first, in the same order as the coefficients.
+ */
+void FirFilter::process(Sample *samples, int count)
+{
+    const int n = channelCount;
+    double sum[ChannelSchema::MaxChannels];
+    for (int i = 0; i < count; ++i) {
+        double *x = samples[i].values;
+        if (samples[i].channelCount < n) {
+            continue;
+        }
+        if (!primed) {
+            for (int row = 0; row < 2 * taps; ++row) {
+                std::copy(x, x + n, history[row]);
+            }
+            primed = true;
+        }
+
+        position = position == 0 ? taps - 1 : position - 1;
+        std::copy(x, x + n, history[position]);
+        std::copy(x, x + n, history[position + taps]);
+
+        std::fill(sum, sum + n, 0.0);
+        for (int k = 0; k < taps; ++k) {
+            const double coefficient = coefficients[k];
+            const double *row = history[position + k];
+            for (int c = 0; c < n; ++c) {
+                sum[c] += coefficient * row[c];
+            }
+        }
+        for (int c = 0; c < n; ++c) {
+            x[c] = selected[c] ? sum[c] : x[c];
+        }
+    }
+}
+
+/**
+ * @brief Constructs a biquad from normalised coefficients (a0 = 1).
+ * @param channelCount The number of channels of the samples.
+ * @param channels The channels to filter, one bit per channel position.
+ * @param b0 Feed-forward coefficient of the current input.
+ * @param b1 Feed-forward coefficient of the previous input.
+ * @param b2 Feed-forward coefficient of the input before.
+ * @param a1 Feedback coefficient of the previous output.
+ * @param a2 Feedback coefficient of the output before.
+ */
+BiquadFilter::BiquadFilter(int channelCount, quint32 channels, double b0, double b1, double b2, double a1, double a2)
+    : SignalFilter(channelCount, channels), b0(b0), b1(b1), b2(b2), a1(a1), a2(a2)
+{
+    reset();
+}
+
+/**
+ * @brief Creates a second-order low-pass filter.
+ * @param channelCount The number of channels of the samples.
+ * @param channels The channels to filter, one bit per channel position.
+ * @param cutoff The cut-off frequency in Hz.
+ * @param sampleRate The sample rate in Hz.
+ * @param q The quality factor; 0.7071 gives a Butterworth response.
+ * @return The filter.
+ *
+ * The coefficients follow the bilinear-transform design of R. Bristow-Johnson's
+ * Audio EQ Cookbook.
+ */
+BiquadFilter *BiquadFilter::lowPass(int channelCount, quint32 channels, double cutoff, double sampleRate, double q)
+{
+    const double w0 = 2 * M_PI * qBound(1e-6, cutoff / sampleRate, 0.499);
+    const double alpha = qSin(w0) / (2 * qMax(q, 1e-3));
+    const double cosW0 = qCos(w0);
+    const double a0 = 1 + alpha;
+    return new BiquadFilter(channelCount, channels,
+                            (1 - cosW0) / 2 / a0, (1 - cosW0) / a0, (1 - cosW0) / 2 / a0,
+                            -2 * cosW0 / a0, (1 - alpha) / a0);
+}
+
+/**
+ * @brief Forgets all past samples; the next sample primes the filter again.
+ */
+void BiquadFilter::reset()
+{
+    primed = false;
+}
+
+/**
+ * @brief Filters samples in place.
+ * @param samples The samples, oldest first.
+ * @param count The number of samples.
+ *
+ * The state is primed with the steady state for the first sample, i.e. as
+ * if the input had always been at that value.
+ */
+void BiquadFilter::process(Sample *samples, int count)
+{
+    const int n = channelCount;
+    for (int i = 0; i < count; ++i) {
+        double *x = samples[i].values;
+        if (samples[i].channelCount < n) {
+            continue;
+        }
+        if (!primed) {
+            const double gain = (b0 + b1 + b2) / (1 + a1 + a2);
+            for (int c = 0; c < n; ++c) {
+                z1[c] = (gain - b0) * x[c];
+                z2[c] = (b2 - a2 * gain) * x[c];
+            }
+            primed = true;
+        }
+
+        for (int c = 0; c < n; ++c) {
+            const double in = x[c];
+            const double out = b0 * in + z1[c];
+            z1[c] = b1 * in - a1 * out + z2[c];
+            z2[c] = b2 * in - a2 * out;
+            x[c] = selected[c] ? out : in;
+        }
+    }
+}
+
+/**
+ * @brief Constructs a Kalman filter.
+ * @param channelCount The number of channels of the samples.
+ * @param channels The channels to filter, one bit per channel position.
+ * @param processNoise The spectral density of the rate's random walk, in unit^2/s^3.
+ * @param measurementNoise The variance of a measured value, in unit^2.
+ */
+KalmanFilter::KalmanFilter(int channelCount, quint32 channels, double processNoise, double measurementNoise)
+    : SignalFilter(channelCount, channels)
+    , processNoise(qMax(processNoise, 0.0))
+    , measurementNoise(qMax(measurementNoise, 1e-12))
+{
+    reset();
+}
+
+/**
+ * @brief Forgets all past samples; the next sample primes the filter again.
+ */
+void KalmanFilter::reset()
+{
+    lastTime = 0;
+}
+
+/**
+ * @brief Filters samples in place.
+ * @param samples The samples, oldest first.
+ * @param count The number of samples.
+ *
+ * The first sample sets the value with the uncertainty of one measurement
+ * and a rate of zero that is not known at all. Every further sample
+ * predicts the state over the time since the previous one and then
+ * corrects it with the measured value.
+ */
+void KalmanFilter::process(Sample *samples, int count)
+{
+    const int n = channelCount;
+    const double q = processNoise;
+    const double r = measurementNoise;
+    for (int i = 0; i < count; ++i) {
+        double *x = samples[i].values;
+        if (samples[i].channelCount < n) {
+            continue;
+        }
+        if (lastTime == 0) {
+            for (int c = 0; c < n; ++c) {
+                angle[c] = x[c];
+                rate[c] = 0;
+                p00[c] = r;
+                p01[c] = 0;
+                p11[c] = 1e6;
+            }
+            lastTime = samples[i].timestamp;
+            continue;
+        }
+
+        const double dt = qMax<qint64>(samples[i].timestamp - lastTime, 0) / 1e9;
+        lastTime = samples[i].timestamp;
+        const double q00 = q * dt * dt * dt / 3;
+        const double q01 = q * dt * dt / 2;
+        const double q11 = q * dt;
+
+        for (int c = 0; c < n; ++c) {
+            // Predict
+            const double predicted = angle[c] + rate[c] * dt;
+            const double m00 = p00[c] + dt * (2 * p01[c] + dt * p11[c]) + q00;
+            const double m01 = p01[c] + dt * p11[c] + q01;
+            const double m11 = p11[c] + q11;
+
+            // Correct with the measured value
+            const double k0 = m00 / (m00 + r);
+            const double k1 = m01 / (m00 + r);
+            const double error = x[c] - predicted;
+            angle[c] = predicted + k0 * error;
+            rate[c] += k1 * error;
+            p00[c] = (1 - k0) * m00;
+            p01[c] = (1 - k0) * m01;
+            p11[c] = m11 - k1 * m01;
+
+            x[c] = selected[c] ? angle[c] : x[c];
+        }
+    }
+}
+
+/**
+ * @brief Constructs a complementary filter.
+ * @param channelCount The number of channels of the samples.
+ * @param angleChannel The channel with the angle, which receives the result.
+ * @param rateChannel The channel with the rate of the angle, in angle units per second.
+ * @param timeConstant The crossover time constant in seconds.
+ */
+ComplementaryFilter::ComplementaryFilter(int channelCount, int angleChannel, int rateChannel, double timeConstant)
+    : SignalFilter(channelCount, 1u << angleChannel)
+    , angleChannel(angleChannel)
+    , rateChannel(rateChannel)
+    , timeConstant(qMax(timeConstant, 0.0))
+{
+    reset();
+}
+
+/**
+ * @brief Forgets all past samples; the next sample primes the filter again.
+ */
+void ComplementaryFilter::reset()
+{
+    lastTime = 0;
+    angle = 0;
+}
+
+/**
+ * @brief Filters samples in place.
+ * @param samples The samples, oldest first.
+ * @param count The number of samples.
+ *
+ * The previous estimate is advanced by the rate over the time since the
+ * previous sample and blended with the measured angle by tau / (tau + dt).
+ * The first sample sets the estimate to the measured angle.
+ */
+void ComplementaryFilter::process(Sample *samples, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        double *x = samples[i].values;
+        if (samples[i].channelCount < channelCount) {
+            continue;
+        }
+        if (lastTime == 0) {
+            angle = x[angleChannel];
+        } else {
+            const double dt = qMax<qint64>(samples[i].timestamp - lastTime, 0) / 1e9;
+            const double weight = timeConstant + dt > 0 ? timeConstant / (timeConstant + dt) : 0;
+            angle = weight * (angle + x[rateChannel] * dt) + (1 - weight) * x[angleChannel];
+        }
+        lastTime = samples[i].timestamp;
+        x[angleChannel] = angle;
+    }
+}
@@ -0,0 +1,280 @@
+#include "StatsMonitor.h"
+#include "SampleClock.h"
+#include <QDateTime>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <algorithm>
+
+/**
+ * @brief Constructs a StatsMonitor without metrics.
+ * @param parent The parent object.
+ */
+StatsMonitor::StatsMonitor(QObject *parent)
+    : QAbstractTableModel(parent)
+    , lastUpdate(0)
+    , exportCsv(false)
+{
+    connect(&timer, &QTimer::timeout, this, &StatsMonitor::update);
+}
+
+/**
+ * @brief Adds a counter.
+ * @param name The name shown in the table, marked with QT_TRANSLATE_NOOP("StatsMonitor", ...); exported untranslated.
+ * @param source Reads the counter.
+ * @param perSecond True to show the rate of increase, false to show the total.
+ */
+void StatsMonitor::addCounter(const QString &name, CounterSource source, bool perSecond)
+{
+    Metric metric;
+    metric.name = name;
+    metric.counter = source;
+    metric.perSecond = perSecond;
+    metric.scale = 1.0;
+    metric.lastCount = source();
+    std::fill(metric.values, metric.values + ColumnCount, 0.0);
+
+    beginInsertRows(QModelIndex(), metrics.size(), metrics.size());
+    metrics.append(metric);
+    endInsertRows();
+}
+
+/**
+ * @brief Adds a histogram.
+ * @param name The name shown in the table, including the unit, marked with QT_TRANSLATE_NOOP("StatsMonitor", ...); exported untranslated.
+ * @param source Takes a snapshot of the histogram.
+ * @param scale The recorded values are divided by this for display, e.g. 1000 to show nanoseconds as microseconds.
+ */
+void StatsMonitor::addHistogram(const QString &name, HistogramSource source, double scale)
+{
+    Metric metric;
+    metric.name = name;
+    metric.histogram = source;
+    metric.perSecond = true;
+    metric.scale = scale;
+    metric.lastCount = 0;
+    metric.last = source();
+    std::fill(metric.values, metric.values + ColumnCount, 0.0);
+
+    beginInsertRows(QModelIndex(), metrics.size(), metrics.size());
+    metrics.append(metric);
+    endInsertRows();
+}
+
+/**
+ * @brief Shows the column titles and metric names in the current language.
+ *
+ * Both are translated when the view asks for them, so the view only has to
+ * be told that they changed.
+ */
+void StatsMonitor::retranslate()
+{
+    emit headerDataChanged(Qt::Horizontal, 0, ColumnCount - 1);
+    if (!metrics.isEmpty()) {
+        emit dataChanged(index(0, NameColumn), index(metrics.size() - 1, NameColumn));
+    }
+}
+
+/**
+ * @brief Sets the file every update is appended to.
+ * @param path The file; CSV if it ends in ".csv", JSON Lines otherwise. An empty path stops exporting.
+ * @return True if the file could be opened.
+ *
+ * A header line is written to CSV files that are empty. Each JSON line is
+ * an object with the time of the update and one entry per metric.
+ */
+bool StatsMonitor::setExportFile(const QString &path)
+{
+    exportFile.close();
+    if (path.isEmpty()) {
+        return true;
+    }
+
+    exportFile.setFileName(path);
+    exportCsv = QFileInfo(path).suffix().compare("csv", Qt::CaseInsensitive) == 0;
+    if (!exportFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        return false;
+    }
+    if (exportCsv && exportFile.size() == 0) {
+        exportFile.write("time,metric,value,mean,p50,p99,max\n");
+    }
+    return true;
+}
+
+/**
+ * @brief Starts updating periodically.
+ * @param interval The time between updates in milliseconds.
+ */
+void StatsMonitor::start(int interval)
+{
+    lastUpdate = SampleClock::now();
+    timer.start(interval);
+}
+
+/**
+ * @brief Gets the number of rows.
+ * @param parent The parent index; only the invalid root index has rows.
+ * @return The number of metrics.
+ */
+int StatsMonitor::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : metrics.size();
+}
+
+/**
+ * @brief Gets the number of columns.
+ * @param parent The parent index; only the invalid root index has columns.
+ * @return ColumnCount.
+ */
+int StatsMonitor::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+/**
+ * @brief Gets the text of a cell.
+ * @param index The cell.
+ * @param role The requested role; Qt::DisplayRole and Qt::TextAlignmentRole are provided.
+ * @return The cell contents, or an invalid QVariant.
+ *
+ * Numbers are right-aligned. Counters leave the distribution columns empty.
+ */
+QVariant StatsMonitor::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= metrics.size()) {
+        return QVariant();
+    }
+    const Metric &metric = metrics.at(index.row());
+
+    if (role == Qt::TextAlignmentRole) {
+        return index.column() == NameColumn ? int(Qt::AlignLeft | Qt::AlignVCenter) : int(Qt::AlignRight | Qt::AlignVCenter);
+    }
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    if (index.column() == NameColumn) {
+        return tr(metric.name.toUtf8().constData());
+    }
+    if (index.column() != ValueColumn && !metric.histogram) {
+        return QVariant();
+    }
+    return QString::number(metric.values[index.column()], 'f', 1);
+}
+
+/**
+ * @brief Gets the title of a column.
+ * @param section The column.
+ * @param orientation Only horizontal headers have titles.
+ * @param role The requested role; only Qt::DisplayRole is provided.
+ * @return The title, or an invalid QVariant.
+ */
+QVariant StatsMonitor::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    switch (section) {
+    case NameColumn:
+        return tr("Metric");
+    case ValueColumn:
+        return tr("Value");
+    case MeanColumn:
+        return tr("Mean");
+    case MedianColumn:
+        return tr("p50");
+    case PercentileColumn:
+        return tr("p99");
+    case MaximumColumn:
+        return tr("Max");
+    default:
+        return QVariant();
+    }
+}
+
+/**
+ * @brief Reads all metrics, refreshes the table and exports the values.
+ *
+ * Rates are taken over the time since the previous update, and the
+ * distributions only cover the values recorded in that time, so the table
+ * shows the current behaviour rather than an average over the session.
+ */
+void StatsMonitor::update()
+{
+    qint64 now = SampleClock::now();
+    double seconds = lastUpdate != 0 && now > lastUpdate ? (now - lastUpdate) / 1e9 : 0.0;
+    lastUpdate = now;
+
+    for (Metric &metric : metrics) {
+        if (metric.counter) {
+            quint64 count = metric.counter();
+            quint64 increase = count - metric.lastCount;
+            metric.values[ValueColumn] = metric.perSecond ? (seconds > 0 ? increase / seconds : 0.0) : count;
+            metric.lastCount = count;
+            continue;
+        }
+
+        HistogramSnapshot snapshot = metric.histogram();
+        HistogramSnapshot recent = snapshot.since(metric.last);
+        metric.last = snapshot;
+        metric.values[ValueColumn] = seconds > 0 ? recent.count / seconds : 0.0;
+        metric.values[MeanColumn] = recent.mean() / metric.scale;
+        metric.values[MedianColumn] = recent.percentile(0.5) / metric.scale;
+        metric.values[PercentileColumn] = recent.percentile(0.99) / metric.scale;
+        metric.values[MaximumColumn] = recent.maximum() / metric.scale;
+    }
+
+    if (!metrics.isEmpty()) {
+        emit dataChanged(index(0, ValueColumn), index(metrics.size() - 1, MaximumColumn));
+    }
+    if (exportFile.isOpen()) {
+        exportValues();
+    }
+}
+
+/**
+ * @brief Appends the current values to the export file.
+ *
+ * CSV files get one row per metric, JSON Lines files one line per update.
+ * The file is flushed every time, so it can be followed while the
+ * application runs.
+ */
+void StatsMonitor::exportValues()
+{
+    const QString time = QDateTime::currentDateTime().toString(Qt::ISODateWithMs);
+
+    if (exportCsv) {
+        QTextStream out(&exportFile);
+        for (const Metric &metric : qAsConst(metrics)) {
+            out << time << ",\"" << metric.name << "\"," << metric.values[ValueColumn];
+            for (int column = MeanColumn; column < ColumnCount; ++column) {
+                out << ',';
+                if (metric.histogram) {
+                    out << metric.values[column];
+                }
+            }
+            out << '\n';
+        }
+    } else {
+        QJsonArray entries;
+        for (const Metric &metric : qAsConst(metrics)) {
+            QJsonObject entry;
+            entry.insert("name", metric.name);
+            entry.insert("value", metric.values[ValueColumn]);
+            if (metric.histogram) {
+                entry.insert("mean", metric.values[MeanColumn]);
+                entry.insert("p50", metric.values[MedianColumn]);
+                entry.insert("p99", metric.values[PercentileColumn]);
+                entry.insert("max", metric.values[MaximumColumn]);
+            }
+            entries.append(entry);
+        }
+        QJsonObject snapshot;
+        snapshot.insert("time", time);
+        snapshot.insert("metrics", entries);
+        exportFile.write(QJsonDocument(snapshot).toJson(QJsonDocument::Compact));
+        exportFile.write("\n");
+    }
+    exportFile.flush();
+}
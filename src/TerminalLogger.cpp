@@ -1,41 +1,196 @@
 #include "TerminalLogger.h"
 #include <QDateTime>
+#include <QScrollBar>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+
+const int TerminalLogger::MaxLines;
+const int TerminalLogger::MaxPending;
+
+namespace {
+
+/**
+ * @brief Longest text appendValue() writes, e.g. "-1.23457e-308".
+ */
+const int MaxValueLength = 13;
+
+/**
+ * @brief Formats a value like QString::arg(double) does, without allocating.
+ * @param out The position to write to.
+ * @param end The end of the buffer.
+ * @param value The value.
+ * @return The position after the formatted value.
+ *
+ * The shortest of fixed and scientific notation with six significant digits
+ * is used, which is what QString::arg() produces by default. The output does
+ * not depend on the C locale. Standard libraries without floating-point
+ * std::to_chars fall back to snprintf, whose decimal comma is replaced.
+ */
+char *appendValue(char *out, char *end, double value)
+{
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    std::to_chars_result result = std::to_chars(out, end, value, std::chars_format::general, 6);
+    return result.ec == std::errc() ? result.ptr : out;
+#else
+    char text[MaxValueLength + 1];
+    const int length = std::snprintf(text, sizeof(text), "%.6g", value);
+    if (length < 0 || length > MaxValueLength || length > end - out) {
+        return out;
+    }
+    for (int i = 0; i < length; ++i) {
+        *out++ = text[i] == ',' ? '.' : text[i];
+    }
+    return out;
+#endif
+}
+
+} // namespace
 
 /**
  * @brief Constructs a TerminalLogger object.
- * @param plainTextEdit The QPlainTextEdit widget where logs will be displayed.
+ * @param listView The list view where logs will be displayed.
  * @param parent The parent object.
  *
- * This constructor initializes the TerminalLogger with the given QPlainTextEdit
- * widget. The widget must be valid and not null.
+ * This constructor attaches a LogModel to the given list view and allocates
+ * the staging buffer. The view is told that all rows have the same height,
+ * so it lays out only the visible rows. The view must be valid and not null.
+ */
+TerminalLogger::TerminalLogger(QListView *listView, QObject *parent)
+    : QObject(parent)
+    , listView(listView)
+    , model(new LogModel(MaxLines, this))
+    , pending(MaxPending * LogModel::LineLength)
+    , pendingLengths(MaxPending)
+    , pendingCount(0)
+    , clockSecond(-1)
+{
+    // Ensure listView is not null
+    Q_ASSERT(listView != nullptr);
+
+    listView->setModel(model);
+    listView->setUniformItemSizes(true);
+    listView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    setSchema(ChannelSchema::attitude());
+}
+
+/**
+ * @brief Sets the channels carried by the samples.
+ * @param schema The channel schema; ChannelSchema::attitude() by default.
+ *
+ * The channel labels are encoded once here, so logging only copies them.
+ */
+void TerminalLogger::setSchema(const ChannelSchema &schema)
+{
+    labels.clear();
+    for (int channel = 0; channel < schema.channelCount(); ++channel) {
+        labels.append(" " + schema.channel(channel).name.toLatin1() + ": ");
+    }
+}
+
+/**
+ * @brief Sets the names of the devices the measurements come from.
+ * @param names The device names; with more than one, every line is tagged with its device.
+ *
+ * Like the channel labels, the tags are encoded once here.
+ */
+void TerminalLogger::setSources(const QStringList &names)
+{
+    tags.clear();
+    for (const QString &name : names) {
+        tags.append(names.size() > 1 ? " [" + name.toLatin1() + "]" : QByteArray());
+    }
+}
+
+/**
+ * @brief Logs a batch of measurements.
+ * @param samples The timestamped samples, oldest first.
+ * @param source The index of the device the samples come from.
+ *
+ * Each log entry includes the acquisition time in the format "hh:mm:ss"
+ * followed by the name and value of every channel. The entries are shown
+ * on the next flush().
+ */
+void TerminalLogger::logMeasurements(const SampleBlock &samples, int source)
+{
+    const QByteArray tag = tags.value(source);
+    for (int i = 0; i < samples.size(); ++i) {
+        stage(samples, i, tag);
+    }
+}
+
+/**
+ * @brief Moves the staged lines into the view. Meant to be called once per UI frame.
+ *
+ * All lines staged since the last call are appended to the model as one
+ * batch. If the view was scrolled to the bottom, it follows the new lines;
+ * otherwise it stays where the user scrolled to.
  */
-TerminalLogger::TerminalLogger(QPlainTextEdit *plainTextEdit, QObject *parent)
-    : QObject(parent), plainTextEdit(plainTextEdit)
+void TerminalLogger::flush()
 {
-    // Ensure plainTextEdit is not null
-    Q_ASSERT(plainTextEdit != nullptr);
+    if (pendingCount == 0) {
+        return;
+    }
+
+    QScrollBar *scrollBar = listView->verticalScrollBar();
+    bool atBottom = scrollBar->value() == scrollBar->maximum();
+
+    model->appendLines(pending.constData(), pendingLengths.constData(), pendingCount);
+    pendingCount = 0;
+
+    if (atBottom) {
+        listView->scrollToBottom();
+    }
 }
 
 /**
- * @brief Logs a measurement to the QPlainTextEdit widget.
- * @param pitch The pitch value to log.
- * @param roll The roll value to log.
+ * @brief Formats one sample of a block into the next staging slot.
+ * @param samples The block.
+ * @param index The position of the sample in the block.
+ * @param tag The device tag written after the time.
  *
- * This method logs the given pitch and roll values along with a timestamp
- * to the QPlainTextEdit widget. Each log entry includes the current time
- * in the format "hh:mm:ss" followed by the pitch and roll values.
+ * The line reads "hh:mm:ss[ [<device>]] <name>: <value> <name>: <value> ...". The clock
+ * text is only formatted again when the second changes, and the labels and
+ * numbers are written in place, so staging a line does not allocate.
+ * Channels that do not fit into a line are left out. If the staging buffer
+ * is full, it is flushed first.
  */
-void TerminalLogger::logMeasurement(double pitch, double roll)
+void TerminalLogger::stage(const SampleBlock &samples, int index, const QByteArray &tag)
 {
-    // Get the current timestamp in "hh:mm:ss" format
-    QString timestamp = QDateTime::currentDateTime().toString("hh:mm:ss");
+    if (pendingCount == MaxPending) {
+        flush(); // More lines than expected between two frames
+    }
+
+    const qint64 timestamp = samples.timestamp(index);
+    qint64 second = timestamp / 1000000000;
+    if (second != clockSecond) {
+        QByteArray clock = QDateTime::fromMSecsSinceEpoch(second * 1000).toString("hh:mm:ss").toLatin1();
+        std::memcpy(clockText, clock.constData(), sizeof(clockText));
+        clockSecond = second;
+    }
+
+    char *line = pending.data() + static_cast<std::size_t>(pendingCount) * LogModel::LineLength;
+    char *end = line + LogModel::LineLength;
+    char *out = line;
+
+    std::memcpy(out, clockText, sizeof(clockText));
+    out += sizeof(clockText);
+    const int tagLength = qMin(tag.size(), LogModel::LineLength - static_cast<int>(sizeof(clockText)));
+    std::memcpy(out, tag.constData(), static_cast<std::size_t>(tagLength));
+    out += tagLength;
 
-    // Create a log message with the format "timestamp Pitch: pitch Roll: roll"
-    QString logMessage = QString("%1 Pitch: %2 Roll: %3")
-                         .arg(timestamp)
-                         .arg(pitch)
-                         .arg(roll);
+    const int channels = qMin(labels.size(), samples.channelCount());
+    for (int channel = 0; channel < channels; ++channel) {
+        const QByteArray &label = labels.at(channel);
+        if (end - out < label.size() + MaxValueLength) {
+            break; // The line is full
+        }
+        std::memcpy(out, label.constData(), static_cast<std::size_t>(label.size()));
+        out += label.size();
+        out = appendValue(out, end, samples.value(channel, index));
+    }
 
-    // Append the log message to the plain text edit widget
-    plainTextEdit->appendPlainText(logMessage);
+    pendingLengths[pendingCount] = static_cast<int>(out - line);
+    ++pendingCount;
 }
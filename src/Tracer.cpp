@@ -0,0 +1,257 @@
+#include "Tracer.h"
+#include "MpscQueue.h"
+#include "SampleClock.h"
+#include <QDateTime>
+#include <QFile>
+#include <QThread>
+#include <cstdio>
+
+const Tracer::Level Tracer::CompiledLevel;
+const int Tracer::MaxArguments;
+
+std::atomic<quint32> Tracer::enabledCategories(0);
+std::atomic<int> Tracer::enabledLevel(Tracer::CompiledLevel);
+
+namespace {
+
+/**
+ * @struct TraceRecord
+ * @brief A message as queued by the tracing thread, not formatted yet.
+ */
+struct TraceRecord
+{
+    qint64 time;                         ///< SampleClock time of the message.
+    const char *format;                  ///< The message with placeholders.
+    double values[Tracer::MaxArguments]; ///< The numbers for the placeholders.
+    quint32 category;                    ///< The category of the message.
+    qint32 level;                        ///< The level of the message.
+    qint32 count;                        ///< The number of values.
+};
+
+/**
+ * @brief Number of records the queue holds; about a second of per-sample messages.
+ */
+const std::size_t queueCapacity = 8192;
+
+/**
+ * @brief Time the writing thread sleeps between emptying the queue, in milliseconds.
+ */
+const unsigned long writeInterval = 50;
+
+/**
+ * @struct TraceState
+ * @brief The queue and the writing thread shared by all Tracer calls.
+ */
+struct TraceState
+{
+    MpscQueue<TraceRecord, queueCapacity> queue; ///< Messages not written yet.
+    std::atomic<quint64> dropped{0};             ///< Messages lost because the queue was full.
+    std::atomic<bool> stopping{false};           ///< Tells the writing thread to finish.
+    QThread *thread = nullptr;                   ///< The writing thread, if started.
+    QFile output;                                ///< The file or standard error the messages go to.
+};
+
+/**
+ * @brief Gets the state shared by all Tracer calls.
+ * @return The state, created on the first call.
+ */
+TraceState &state()
+{
+    static TraceState instance;
+    return instance;
+}
+
+/**
+ * @brief Gets the name of a category as shown in the output.
+ * @param category A single Category flag.
+ * @return The name.
+ */
+const char *categoryName(quint32 category)
+{
+    switch (category) {
+    case Tracer::Serial: return "serial";
+    case Tracer::Graphics: return "graphics";
+    case Tracer::Physics: return "physics";
+    case Tracer::Charts: return "charts";
+    case Tracer::Storage: return "storage";
+    default: return "?";
+    }
+}
+
+/**
+ * @brief Gets the name of a level as shown in the output.
+ * @param level The level.
+ * @return The name.
+ */
+const char *levelName(int level)
+{
+    switch (level) {
+    case Tracer::Debug: return "debug";
+    case Tracer::Info: return "info";
+    case Tracer::Warning: return "warning";
+    default: return "?";
+    }
+}
+
+/**
+ * @brief Formats and writes all queued messages.
+ * @param output The file to write to.
+ */
+void writeRecords(QFile &output)
+{
+    TraceRecord records[256];
+    std::size_t count;
+    while ((count = state().queue.pop(records, 256)) > 0) {
+        for (std::size_t i = 0; i < count; ++i) {
+            const TraceRecord &record = records[i];
+            QString text = QString::fromLatin1(record.format);
+            for (int value = 0; value < record.count; ++value) {
+                text = text.arg(record.values[value]);
+            }
+            QString line = QString("%1 %2 %3: %4\n")
+                .arg(QDateTime::fromMSecsSinceEpoch(SampleClock::toMSecsSinceEpoch(record.time)).toString("hh:mm:ss.zzz"),
+                     QLatin1String(levelName(record.level)), QLatin1String(categoryName(record.category)), text);
+            output.write(line.toUtf8());
+        }
+    }
+    output.flush();
+}
+
+} // namespace
+
+/**
+ * @brief Sets the categories that are recorded.
+ * @param categories A combination of Category flags; 0 disables tracing.
+ */
+void Tracer::setCategories(quint32 categories)
+{
+    enabledCategories.store(categories & AllCategories, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Sets the lowest level that is recorded.
+ * @param level The level; levels below CompiledLevel stay removed.
+ */
+void Tracer::setLevel(Level level)
+{
+    enabledLevel.store(level, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Parses a list of category names.
+ * @param names Comma-separated names such as "graphics,physics", or "all".
+ * @param ok Set to false if a name is unknown, if not null.
+ * @return The combined Category flags of the known names.
+ */
+quint32 Tracer::parseCategories(const QString &names, bool *ok)
+{
+    quint32 categories = 0;
+    bool known = true;
+    for (const QString &name : names.split(',', Qt::SkipEmptyParts)) {
+        const QString key = name.trimmed().toLower();
+        if (key == "all") {
+            categories |= AllCategories;
+            continue;
+        }
+        quint32 category = 1;
+        while (category <= AllCategories && key != categoryName(category)) {
+            category <<= 1;
+        }
+        if (category <= AllCategories) {
+            categories |= category;
+        } else {
+            known = false;
+        }
+    }
+    if (ok) {
+        *ok = known;
+    }
+    return categories;
+}
+
+/**
+ * @brief Starts the thread that writes the recorded messages.
+ * @param path The file to append to; empty for standard error.
+ * @return True if the file could be opened.
+ *
+ * The thread wakes up every few milliseconds and writes whatever has been
+ * queued since, so formatting and I/O never happen on the tracing threads.
+ * A running thread is stopped first.
+ */
+bool Tracer::start(const QString &path)
+{
+    stop();
+
+    TraceState &shared = state();
+    bool opened;
+    if (path.isEmpty()) {
+        opened = shared.output.open(stderr, QIODevice::WriteOnly | QIODevice::Text);
+    } else {
+        shared.output.setFileName(path);
+        opened = shared.output.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text);
+    }
+    if (!opened) {
+        return false;
+    }
+
+    shared.stopping.store(false, std::memory_order_relaxed);
+    shared.thread = QThread::create([&shared]() {
+        while (!shared.stopping.load(std::memory_order_acquire)) {
+            writeRecords(shared.output);
+            QThread::msleep(writeInterval);
+        }
+        writeRecords(shared.output);
+    });
+    shared.thread->setObjectName("Tracer");
+    shared.thread->start(QThread::LowPriority);
+    return true;
+}
+
+/**
+ * @brief Writes the remaining messages and stops the writing thread.
+ */
+void Tracer::stop()
+{
+    TraceState &shared = state();
+    if (!shared.thread) {
+        return;
+    }
+    shared.stopping.store(true, std::memory_order_release);
+    shared.thread->wait();
+    delete shared.thread;
+    shared.thread = nullptr;
+    shared.output.close();
+}
+
+/**
+ * @brief Gets the number of messages dropped because the queue was full.
+ * @return The number of messages.
+ */
+quint64 Tracer::droppedRecords()
+{
+    return state().dropped.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Queues a message for the writing thread.
+ * @param level The level of the message.
+ * @param category The category of the message.
+ * @param format The message with placeholders.
+ * @param values The numbers for the placeholders.
+ * @param count The number of values.
+ */
+void Tracer::write(Level level, Category category, const char *format, const double *values, int count)
+{
+    TraceRecord record;
+    record.time = SampleClock::now();
+    record.format = format;
+    record.category = category;
+    record.level = level;
+    record.count = count;
+    for (int i = 0; i < count; ++i) {
+        record.values[i] = values[i];
+    }
+    if (!state().queue.push(record)) {
+        state().dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
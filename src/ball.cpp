@@ -5,7 +5,7 @@
 
 #include "ball.h"
 #include <QGraphicsScene>
-#include <QDebug>
+#include "Tracer.h"
 
 /**
  * @brief Constructs a Ball object.
@@ -26,8 +26,8 @@ Ball::Ball(QGraphicsItem *parent)
  * @param x The x-coordinate of the ball.
  * @param y The y-coordinate of the ball.
  *
- * Updates the position of the ball and ensures that it is neither falling nor moving.
- * Also, prints the new position to the debug output.
+ * Updates the position of the ball and ensures that it is not falling.
+ * Also, traces the new position.
  */
 void Ball::setPosition(double x, double y)
 {
@@ -35,51 +35,52 @@ void Ball::setPosition(double x, double y)
     m_y = y;
     setPos(m_x, m_y);
     m_isFalling = false; // Ensure the ball is not falling
-    m_isMoving = false;  // Ensure the ball is not moving
-    qDebug() << "Ball position set to: (" << m_x << ", " << m_y << ")"; // Debugging position
+    Tracer::debug(Tracer::Graphics, "Ball position set to: (%1, %2)", m_x, m_y);
 }
 
 /**
  * @brief Starts the movement of the ball.
  *
- * Sets the moving flag to true and prints a debug message.
+ * Sets the moving flag to true and traces a message.
  */
 void Ball::startMovement()
 {
     m_isMoving = true;
-    qDebug() << "Ball movement started";
+    Tracer::info(Tracer::Graphics, "Ball movement started");
 }
 
 /**
  * @brief Stops the movement of the ball.
  *
- * Sets the moving flag to false and prints a debug message.
+ * Sets the moving flag to false and traces a message.
  */
 void Ball::stopMovement()
 {
     m_isMoving = false;
-    qDebug() << "Ball movement stopped";
+    Tracer::info(Tracer::Graphics, "Ball movement stopped");
 }
 
 /**
- * @brief Makes the ball fall.
+ * @brief Moves the falling ball.
+ * @param x The x-coordinate of the ball.
+ * @param y The y-coordinate of the ball.
  *
- * Sets the falling flag to true and moves the ball down by 5 units each call.
- * Ensures the ball does not move out of the scene boundaries.
- * Also, prints the new position to the debug output.
+ * Sets the falling flag to true and moves the ball to the position computed
+ * by the physics engine. Ensures the ball does not move out of the scene
+ * boundaries. Also, traces the new position.
  */
-void Ball::fall()
+void Ball::fall(double x, double y)
 {
     m_isFalling = true; // Mark the ball as falling
-    // Move ball down by 5 units each call
-    m_y += 5;
+    m_x = x;
+    m_y = y;
 
     // Check if the ball is within the boundaries of the scene
     if (m_y + rect().height() / 2 > scene()->sceneRect().bottom()) {
         m_y = scene()->sceneRect().bottom() - rect().height() / 2;
     }
     setPos(m_x, m_y);
-    qDebug() << "Ball falling to: (" << m_x << ", " << m_y << ")";
+    Tracer::debug(Tracer::Graphics, "Ball falling to: (%1, %2)", m_x, m_y);
 }
 
 /**
@@ -2,13 +2,47 @@
 #include "ui_mainwindow.h"
 
 #include "../inc/mainwindow.h"
+#include "SessionExporter.h"
+#include "Tracer.h"
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QtNumeric>
+
+namespace {
+
+/**
+ * @brief Stops the tracer when main() returns, on every path.
+ *
+ * The writing thread must not outlive main(): its queue and output file are
+ * destroyed with the other statics at exit.
+ */
+struct TracerGuard
+{
+    ~TracerGuard() { Tracer::stop(); }
+};
+
+} // namespace
 
 /**
  * @brief The main function for the application.
  *
  * This function initializes the QApplication, creates the MainWindow,
- * and starts the event loop.
+ * opens the serial ports given on the command line and starts the event
+ * loop. Several boards are read at once by repeating --port, e.g.
+ * "--port /dev/ttyACM0 --port /dev/ttyACM1". A recorded session is played
+ * back with "--replay session.wdscap", optionally faster with "--speed 10"
+ * or as fast as possible with "--speed 0"; "--capture" records one.
+ * "--record session.wdsrec" records the decoded samples, which
+ * "--session session.wdsrec" shows again later. Adding "--export
+ * session.csv" (or a directory for one binary file per column) converts the
+ * session without opening the window. "--trace graphics,serial" writes
+ * diagnostic messages of those categories (or "all") to standard error or
+ * to the file given with "--trace-file". "--filter \"median(5); lowpass(8,
+ * 1000) @ Pitch\"" filters the samples as they are read (see FilterChain).
+ * "--schema imu" reads 9-axis IMU frames instead of roll and pitch; other
+ * boards are described by their channels, e.g. "--schema \"Roll[deg],
+ * Pitch[deg], Temp[C]\"".
  *
  * @param argc The number of command-line arguments.
  * @param argv The array of command-line arguments.
@@ -17,7 +51,110 @@
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption portOption("port", "Serial port to read; may be repeated.", "name");
+    QCommandLineOption baudOption("baud", "Baud rate of the serial ports.", "rate", "115200");
+    QCommandLineOption statsOption("stats-file", "Append the statistics to a CSV or JSON Lines file every second.", "path");
+    QCommandLineOption replayOption("replay", "Capture file to replay instead of a port; may be repeated.", "path");
+    QCommandLineOption speedOption("speed", "Replay speed factor; 0 replays as fast as possible.", "factor", "1");
+    QCommandLineOption captureOption("capture", "Record the raw bytes of the next port to a capture file; may be repeated.", "path");
+    QCommandLineOption recordOption("record", "Record the decoded samples to a session file.", "path");
+    QCommandLineOption sessionOption("session", "Show a recorded session file instead of reading ports.", "path");
+    QCommandLineOption exportOption("export", "Export the session to a .csv file or a directory of column files and exit.", "path");
+    QCommandLineOption traceOption("trace", "Trace the given categories: serial, graphics, physics, charts, storage or all.", "categories");
+    QCommandLineOption traceFileOption("trace-file", "Append the trace to a file instead of standard error.", "path");
+    QCommandLineOption filterOption("filter", "Filter the samples as they are read, e.g. \"median(5); lowpass(8, 1000) @ Pitch\".", "stages");
+    QCommandLineOption schemaOption("schema", "Channels of each frame: attitude, imu or a list such as \"Roll[deg], Pitch[deg]\".", "channels", "attitude");
+    parser.addOption(portOption);
+    parser.addOption(baudOption);
+    parser.addOption(statsOption);
+    parser.addOption(replayOption);
+    parser.addOption(speedOption);
+    parser.addOption(captureOption);
+    parser.addOption(recordOption);
+    parser.addOption(sessionOption);
+    parser.addOption(exportOption);
+    parser.addOption(traceOption);
+    parser.addOption(traceFileOption);
+    parser.addOption(filterOption);
+    parser.addOption(schemaOption);
+    parser.process(a);
+
+    TracerGuard tracerGuard;
+    if (parser.isSet(traceOption)) {
+        bool known;
+        Tracer::setCategories(Tracer::parseCategories(parser.value(traceOption), &known));
+        if (!known) {
+            qWarning() << "Unknown trace category in" << parser.value(traceOption);
+        }
+        if (!Tracer::start(parser.value(traceFileOption))) {
+            qWarning() << "Cannot open trace file" << parser.value(traceFileOption);
+        }
+    }
+
+    QStringList portNames = parser.values(portOption);
+    if (portNames.isEmpty()) {
+        portNames.append("/dev/ttyACM0");
+    }
+
+    if (parser.isSet(exportOption)) {
+        SessionFile session;
+        if (!session.open(parser.value(sessionOption))) {
+            qWarning() << "Cannot open session file" << parser.value(sessionOption);
+            return 1;
+        }
+        if (!SessionExporter::exportSession(session, parser.value(exportOption))) {
+            qWarning() << "Cannot export to" << parser.value(exportOption);
+            return 1;
+        }
+        return 0;
+    }
+
+    bool ok;
+    const double speed = parser.value(speedOption).toDouble(&ok);
+    if (!ok || !qIsFinite(speed) || speed < 0) {
+        qWarning() << "Invalid replay speed" << parser.value(speedOption);
+        return 1;
+    }
+    const qint32 baudRate = parser.value(baudOption).toInt(&ok);
+    if (!ok || baudRate <= 0) {
+        qWarning() << "Invalid baud rate" << parser.value(baudOption);
+        return 1;
+    }
+
+    const QString schemaName = parser.value(schemaOption);
+    const ChannelSchema schema = schemaName == "attitude" ? ChannelSchema::attitude()
+                               : schemaName == "imu"      ? ChannelSchema::imu()
+                                                          : ChannelSchema::fromString(schemaName);
+    if (schema.channelCount() == 0) {
+        qWarning() << "Invalid schema" << schemaName;
+        return 1;
+    }
+
     MainWindow w;
+    w.setSchema(schema);
+    QString filterError;
+    if (parser.isSet(filterOption) && !w.setFilters(parser.value(filterOption), &filterError)) {
+        qWarning() << filterError;
+    }
+    if (parser.isSet(sessionOption)) {
+        if (!w.openSession(parser.value(sessionOption))) {
+            qWarning() << "Cannot open session file" << parser.value(sessionOption);
+        }
+    } else if (parser.isSet(replayOption)) {
+        w.openReplays(parser.values(replayOption), speed);
+    } else {
+        w.openPorts(portNames, baudRate);
+    }
+    w.startCapture(parser.values(captureOption));
+    if (parser.isSet(recordOption) && !w.startRecording(parser.value(recordOption))) {
+        qWarning() << "Cannot create session file" << parser.value(recordOption);
+    }
+    if (parser.isSet(statsOption) && !w.setStatsFile(parser.value(statsOption))) {
+        qWarning() << "Cannot open statistics file" << parser.value(statsOption);
+    }
     w.show();
     return a.exec();
 }
@@ -1,11 +1,16 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
+#include "SampleClock.h"
+#include "SessionFile.h"
+#include "Tracer.h"
 #include <QDateTime>
 #include <QtMath>
 #include <QTranslator>
 #include <QLocale>
 #include <QDebug>
 #include <QApplication>
+#include <QOpenGLWidget>
+#include <QHeaderView>
 
 /**
  * @brief Constructs a MainWindow object.
@@ -17,23 +22,30 @@ MainWindow::MainWindow(QWidget *parent)
     , chartManager(new ChartManager(this))
     , serialManager(new SerialManager(this))
     , terminalLogger(nullptr)
+    , statsMonitor(new StatsMonitor(this))
+    , sessionRecorder(new SessionRecorder(this))
     , chartDuration(20 * 1000) // 20 seconds in milliseconds
     , isCounting(false)
+    , pitchChannel(-1)
+    , lastPhysicsUpdate(0)
 {
     ui->setupUi(this);
 
     // Initialize TerminalLogger after UI setup
-    terminalLogger = new TerminalLogger(ui->plainTextEdit_Terminal, this);
+    terminalLogger = new TerminalLogger(ui->listView_Terminal, this);
 
     // Initialize LED indicator
     ledIndicator = ui->labelLedIndicator;  // Assuming you named the QLabel 'labelLedIndicator' in Designer
     ledIndicator->setStyleSheet("background-color: red;"); // Initial state is "off"
 
-    // Initialize timers
-    animationTimer = new QTimer(this);
-    connect(animationTimer, &QTimer::timeout, this, &MainWindow::updateAnimation);
-    animationTimer->start(16); // 60 FPS (approx.)
+    // Frames are delivered on demand, paced to the display the window is on
+    frameClock = new FrameClock(this);
+    connect(frameClock, &FrameClock::frame, this, &MainWindow::updateAnimation);
+    connect(frameClock, &FrameClock::frame, chartManager->getRenderScheduler(), &RenderScheduler::tick);
+    connect(frameClock, &FrameClock::frame, terminalLogger, &TerminalLogger::flush);
+    connect(chartManager->getRenderScheduler(), &RenderScheduler::frameRequested, frameClock, &FrameClock::requestFrame);
 
+    // Initialize timers
     clockTimer = new QTimer(this);
     connect(clockTimer, &QTimer::timeout, this, &MainWindow::updateClock);
 
@@ -45,13 +57,16 @@ MainWindow::MainWindow(QWidget *parent)
     ui->horizontalLayout->addWidget(chartManager->getRollChartView());
     ui->horizontalLayout_2->addWidget(chartManager->getPitchChartView());
 
-    // Start serial communication
-    connect(serialManager, &SerialManager::newData, this, &MainWindow::updateCharts);
+    // Channels carried by each frame, until main() picks others
+    setSchema(ChannelSchema::attitude());
+
+    // Serial communication is started by openPorts()
+    connect(serialManager, &SerialManager::newSamples, this, &MainWindow::updateCharts);
     connect(serialManager, &SerialManager::serialPortOpened, this, &MainWindow::updateLedIndicator);
-    serialManager->startReading("/dev/ttyACM0", QSerialPort::Baud115200);
 
-    // Initialize scene and items
+    // Initialize scene and items; both items move all the time, so the scene is not indexed
     scene = new QGraphicsScene(0, 0, ui->graphicsView_3->width(), ui->graphicsView_3->height(), this);
+    scene->setItemIndexMethod(QGraphicsScene::NoIndex);
     ui->graphicsView_3->setScene(scene);
 
     platform = new Platform();
@@ -63,9 +78,11 @@ MainWindow::MainWindow(QWidget *parent)
     resetBallPosition();
 
     // Configure QGraphicsView
-    ui->graphicsView_3->setRenderHint(QPainter::Antialiasing);
+    ui->graphicsView_3->setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform);
+    ui->graphicsView_3->setOptimizationFlags(QGraphicsView::DontSavePainterState);
     ui->graphicsView_3->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     ui->graphicsView_3->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    setSceneViewport(false);
 
     // Connect time scale buttons
     connect(ui->pushButton_3, &QPushButton::clicked, this, &MainWindow::decreaseTimeScale);
@@ -76,6 +93,218 @@ MainWindow::MainWindow(QWidget *parent)
 
     ui->comboBoxLanguage->addItem("English", "en");
     ui->comboBoxLanguage->addItem("Polski", "pl");
+
+    // Add chart decimation selection
+    ui->comboBoxDecimation->addItem(QString(), static_cast<int>(Decimator::Mode::None));
+    ui->comboBoxDecimation->addItem(QString(), static_cast<int>(Decimator::Mode::MinMax));
+    ui->comboBoxDecimation->addItem(QString(), static_cast<int>(Decimator::Mode::Lttb));
+    retranslateDecimationModes();
+    ui->comboBoxDecimation->setCurrentIndex(ui->comboBoxDecimation->findData(static_cast<int>(chartManager->getDecimationMode())));
+    connect(ui->comboBoxDecimation, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::changeDecimationMode);
+
+    // Add chart render mode selection
+    connect(ui->checkBoxOpenGL, &QCheckBox::toggled, this, &MainWindow::toggleOpenGL);
+
+    // Show the pipeline statistics
+    setupStats();
+
+    // Create the native window now, so the frame clock can follow it
+    winId();
+    frameClock->setWindow(windowHandle());
+}
+
+/**
+ * @brief Registers the pipeline metrics with the statistics panel.
+ *
+ * The counters of all serial ports are added up. Durations and latencies
+ * are shown in microseconds. The panel is refreshed once per second. The
+ * names are translated by the panel, so exported statistics keep the same
+ * names in every language.
+ */
+void MainWindow::setupStats()
+{
+    statsMonitor->addCounter(QT_TRANSLATE_NOOP("StatsMonitor", "Bytes/s"), [this]() { return serialManager->getTotalStats().bytesRead; }, true);
+    statsMonitor->addCounter(QT_TRANSLATE_NOOP("StatsMonitor", "Frames/s"), [this]() { return serialManager->getTotalStats().frames; }, true);
+    statsMonitor->addCounter(QT_TRANSLATE_NOOP("StatsMonitor", "CRC failures"), [this]() { return serialManager->getTotalStats().crcErrors; }, false);
+    statsMonitor->addCounter(QT_TRANSLATE_NOOP("StatsMonitor", "Format errors"), [this]() { return serialManager->getTotalStats().formatErrors; }, false);
+    statsMonitor->addCounter(QT_TRANSLATE_NOOP("StatsMonitor", "Dropped frames"), [this]() { return serialManager->getTotalStats().droppedFrames; }, false);
+    statsMonitor->addCounter(QT_TRANSLATE_NOOP("StatsMonitor", "Lost frames"), [this]() { return serialManager->getTotalStats().lostFrames; }, false);
+    statsMonitor->addCounter(QT_TRANSLATE_NOOP("StatsMonitor", "Recorded bytes/s"), [this]() { return sessionRecorder->bytesWritten(); }, true);
+    statsMonitor->addCounter(QT_TRANSLATE_NOOP("StatsMonitor", "Dropped trace messages"), []() { return Tracer::droppedRecords(); }, false);
+    statsMonitor->addHistogram(QT_TRANSLATE_NOOP("StatsMonitor", "Parse time (us)"), [this]() { return serialManager->getParseTime(); }, 1000);
+    statsMonitor->addHistogram(QT_TRANSLATE_NOOP("StatsMonitor", "Queue depth (samples)"), [this]() { return serialManager->getQueueDepth(); });
+    statsMonitor->addHistogram(QT_TRANSLATE_NOOP("StatsMonitor", "Read to drain (us)"), [this]() { return serialManager->getLatency(); }, 1000);
+    statsMonitor->addHistogram(QT_TRANSLATE_NOOP("StatsMonitor", "Chart update (us)"), [this]() { return chartManager->getUpdateTime(); }, 1000);
+    statsMonitor->addHistogram(QT_TRANSLATE_NOOP("StatsMonitor", "Repaint (us)"), [this]() { return chartManager->getRepaintTime(); }, 1000);
+    statsMonitor->addHistogram(QT_TRANSLATE_NOOP("StatsMonitor", "Drain to repaint (us)"), [this]() { return chartManager->getDisplayLatency(); }, 1000);
+    statsMonitor->addCounter(QT_TRANSLATE_NOOP("StatsMonitor", "Display frames/s"), [this]() { return frameClock->getFrameCount(); }, true);
+    statsMonitor->addCounter(QT_TRANSLATE_NOOP("StatsMonitor", "Dropped display frames"), [this]() { return frameClock->getDroppedFrames(); }, false);
+    statsMonitor->addHistogram(QT_TRANSLATE_NOOP("StatsMonitor", "Frame jitter (us)"), [this]() { return frameClock->getFrameJitter(); }, 1000);
+
+    ui->tableView->setModel(statsMonitor);
+    ui->tableView->verticalHeader()->hide();
+    ui->tableView->horizontalHeader()->setSectionResizeMode(StatsMonitor::NameColumn, QHeaderView::Stretch);
+    ui->tableView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    statsMonitor->start(1000);
+}
+
+/**
+ * @brief Sets the names of the decimation modes in the current language.
+ *
+ * The entries are added in code rather than in the form, so
+ * retranslateUi() does not update them.
+ */
+void MainWindow::retranslateDecimationModes()
+{
+    QComboBox *box = ui->comboBoxDecimation;
+    box->setItemText(box->findData(static_cast<int>(Decimator::Mode::None)), tr("Raw"));
+    box->setItemText(box->findData(static_cast<int>(Decimator::Mode::MinMax)), tr("Min/Max"));
+    box->setItemText(box->findData(static_cast<int>(Decimator::Mode::Lttb)), tr("LTTB"));
+}
+
+/**
+ * @brief Sets the file the statistics are exported to once per update.
+ * @param path The file; CSV if it ends in ".csv", JSON Lines otherwise.
+ * @return True if the file could be opened.
+ */
+bool MainWindow::setStatsFile(const QString &path)
+{
+    return statsMonitor->setExportFile(path);
+}
+
+/**
+ * @brief Sets the channels carried by each frame.
+ * @param schema The channels, in frame order.
+ *
+ * Must be called before the ports are opened and the filters are set, since
+ * both are checked against the schema. The platform follows the "Pitch"
+ * channel and stays level if the schema has none.
+ */
+void MainWindow::setSchema(const ChannelSchema &schema)
+{
+    serialManager->setSchema(schema);
+    chartManager->setSchema(schema);
+    terminalLogger->setSchema(schema);
+    pitchChannel = schema.indexOf("Pitch");
+}
+
+/**
+ * @brief Sets the filters applied to the samples of all ports as they are read.
+ * @param description The filter stages, see FilterChain.
+ * @param error Receives a description of the problem if the text is invalid, if not null.
+ * @return True if the filters were valid.
+ *
+ * The filters run on the acquisition thread, so the charts, the platform
+ * and recordings all see the filtered samples. Ports opened later are
+ * filtered as well.
+ */
+bool MainWindow::setFilters(const QString &description, QString *error)
+{
+    return serialManager->setFilters(description, error);
+}
+
+/**
+ * @brief Records the samples of the open ports into a session file.
+ * @param path The file; an existing file is replaced.
+ * @return True if the file could be created.
+ *
+ * The ports must have been opened first; they are stored under their names.
+ * The recording is completed when the window is closed.
+ */
+bool MainWindow::startRecording(const QString &path)
+{
+    QStringList names;
+    for (int port = 0; port < serialManager->getPortCount(); ++port) {
+        names.append(serialManager->getPortName(port));
+    }
+    return sessionRecorder->start(path, serialManager->getSchema(), names);
+}
+
+/**
+ * @brief Shows a recorded session on the charts.
+ * @param path The session file.
+ * @return True if the file could be opened.
+ *
+ * The file is mapped and its columns are handed to the charts chunk by
+ * chunk. Only the chunks that reach into the live span of the charts go
+ * into the sample buffer; the older ones only go into the history, whose
+ * memory is bounded, so the size of the session does not decide how much
+ * is held in memory. The charts then show the end of the session, and
+ * zooming and panning reach back to its start.
+ */
+bool MainWindow::openSession(const QString &path)
+{
+    SessionFile session;
+    if (!session.open(path)) {
+        return false;
+    }
+    chartManager->setSchema(session.schema());
+    chartManager->setSources(session.sourceNames());
+
+    qint64 end = 0;
+    for (int chunk = 0; chunk < session.chunkCount(); ++chunk) {
+        end = qMax(end, session.chunk(chunk).last);
+    }
+    const qint64 liveStart = end - chartManager->getLiveDuration() * 1000000; // The duration is in milliseconds
+
+    SampleBlock block;
+    for (int chunk = 0; chunk < session.chunkCount(); ++chunk) {
+        const SessionChunk &entry = session.chunk(chunk);
+        session.read(chunk, block);
+        if (entry.last < liveStart) {
+            chartManager->updateHistory(block, entry.source);
+        } else {
+            chartManager->updateCharts(block, entry.source);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Starts reading from a set of serial ports.
+ * @param portNames The names of the serial ports; the first one drives the platform.
+ * @param baudRate The baud rate used on every port.
+ *
+ * The data of all ports is overlaid on the charts, one series per port, and
+ * every line in the log is tagged with its port when there is more than one.
+ */
+void MainWindow::openPorts(const QStringList &portNames, qint32 baudRate)
+{
+    chartManager->setSources(portNames);
+    terminalLogger->setSources(portNames);
+    for (const QString &portName : portNames) {
+        serialManager->addPort(portName, baudRate);
+        portOpen.append(false);
+    }
+}
+
+/**
+ * @brief Replays a set of capture files in place of serial ports.
+ * @param paths The capture files; the first one drives the platform.
+ * @param speed The replay speed: 1 for real time, N for N times faster, 0 for as fast as possible.
+ */
+void MainWindow::openReplays(const QStringList &paths, double speed)
+{
+    chartManager->setSources(paths);
+    terminalLogger->setSources(paths);
+    for (const QString &path : paths) {
+        serialManager->addReplay(path, speed);
+        portOpen.append(false);
+    }
+}
+
+/**
+ * @brief Records the raw bytes of the open ports into capture files.
+ * @param paths One capture file per port, in the order the ports were opened.
+ *
+ * Extra files are ignored, and ports without a file are not recorded.
+ */
+void MainWindow::startCapture(const QStringList &paths)
+{
+    const int count = qMin(paths.size(), serialManager->getPortCount());
+    for (int port = 0; port < count; ++port) {
+        serialManager->startCapture(port, paths.at(port));
+    }
 }
 
 /**
@@ -91,6 +320,8 @@ void MainWindow::changeLanguage(const QString &language)
         if (translator.load(qmPath)) {
             qApp->installTranslator(&translator);
             ui->retranslateUi(this);
+            retranslateDecimationModes();
+            statsMonitor->retranslate();
             qDebug() << "Language changed to:" << language;
         } else {
             qDebug() << "Failed to load translation file:" << qmPath;
@@ -98,6 +329,60 @@ void MainWindow::changeLanguage(const QString &language)
     }
 }
 
+/**
+ * @brief Changes the decimation applied to the charts.
+ * @param index The index of the selected entry in the decimation combo box.
+ */
+void MainWindow::changeDecimationMode(int index)
+{
+    if (index != -1) {
+        chartManager->setDecimationMode(static_cast<Decimator::Mode>(ui->comboBoxDecimation->itemData(index).toInt()));
+    }
+}
+
+
+/**
+ * @brief Switches the charts and the balance view between raster and OpenGL rendering.
+ * @param enabled True to request OpenGL rendering, false for raster rendering.
+ *
+ * If OpenGL is not available both stay in raster mode and the check box is
+ * cleared again.
+ */
+void MainWindow::toggleOpenGL(bool enabled)
+{
+    ChartManager::RenderMode mode = chartManager->setRenderMode(enabled ? ChartManager::RenderMode::OpenGL
+                                                                        : ChartManager::RenderMode::Raster);
+    setSceneViewport(mode == ChartManager::RenderMode::OpenGL);
+    if (enabled && mode != ChartManager::RenderMode::OpenGL) {
+        QSignalBlocker blocker(ui->checkBoxOpenGL);
+        ui->checkBoxOpenGL->setChecked(false);
+    }
+}
+
+/**
+ * @brief Selects the viewport the balance view is drawn on.
+ * @param openGL True for an OpenGL viewport, false for a raster widget.
+ *
+ * On a raster viewport only the bounding rectangle of the changed items
+ * is repainted, which is a small area since just the platform and the ball
+ * move. An OpenGL viewport is redrawn completely on every change instead,
+ * as partial updates of a GL surface cost more than drawing the few items;
+ * multisampling takes the place of the antialiased QPainter path there.
+ */
+void MainWindow::setSceneViewport(bool openGL)
+{
+    if (openGL) {
+        QOpenGLWidget *viewport = new QOpenGLWidget();
+        QSurfaceFormat format = viewport->format();
+        format.setSamples(4);
+        viewport->setFormat(format);
+        ui->graphicsView_3->setViewport(viewport);
+        ui->graphicsView_3->setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
+    } else {
+        ui->graphicsView_3->setViewport(new QWidget());
+        ui->graphicsView_3->setViewportUpdateMode(QGraphicsView::BoundingRectViewportUpdate);
+    }
+}
 
 /**
  * @brief Destructor for MainWindow.
@@ -110,7 +395,8 @@ MainWindow::~MainWindow()
 /**
  * @brief Starts the countdown timer.
  *
- * This method initializes the countdown timer and starts the ball movement.
+ * This method initializes the countdown timer, puts the ball back in the
+ * middle of the platform and starts the ball movement.
  */
 void MainWindow::startCountdown() {
     ui->lcdNumber->display("00:00:00");
@@ -118,14 +404,24 @@ void MainWindow::startCountdown() {
     isCounting = true;
     clockTimer->start(1000);
 
+    resetBallPosition();
     ball->startMovement();
+    lastPhysicsUpdate = SampleClock::now();
+    frameClock->requestFrame();
 }
 
 /**
  * @brief Resets the ball position on the platform.
+ *
+ * The simulation is reset to a ball at rest in the middle of the platform,
+ * and the ball waits there until startCountdown() starts it.
  */
 void MainWindow::resetBallPosition()
 {
+    ball->stopMovement();
+    physics.setPlatform(platform->x(), platform->y(), platform->rect().width() / 2);
+    physics.setFloor(scene->sceneRect().bottom() - ball->rect().height() / 2);
+    physics.reset();
     ball->setPosition(platform->x(), platform->y() - 10);
 }
 
@@ -144,97 +440,86 @@ void MainWindow::updateClock() {
 
 /**
  * @brief Updates the animation of the ball and platform.
+ *
+ * Only the simulation is advanced here. The items schedule a repaint of
+ * the area they cover themselves when they actually move or turn, so an
+ * idle scene is not repainted at all. While the ball moves, every frame
+ * requests the next one; once it has landed on the floor the movement
+ * stops, and with it the frames.
  */
 void MainWindow::updateAnimation() {
-    if (ball->isMoving()) {
-        updateBallPosition(0);
+    if (!ball->isMoving()) {
+        return;
+    }
+    updateBallPosition();
+    if (physics.hasLanded()) {
+        ball->stopMovement();
+    } else {
+        frameClock->requestFrame();
     }
-    platform->update();
-    ball->update();
 }
 
 /**
- * @brief Updates the charts with new roll and pitch values.
- * @param rollValue The roll value.
- * @param pitchValue The pitch value.
+ * @brief Updates the charts, log and platform with a batch of samples.
+ * @param port The index of the port the samples come from.
+ * @param samples The timestamped samples, oldest first, with one column per schema channel.
+ *
+ * The samples are handed to the chart manager and the log, and a frame is
+ * requested from the FrameClock; both are drawn once for the whole batch on
+ * that frame. The samples are recorded if a recording is running. The
+ * platform is tilted to the newest pitch value of the first port, which the
+ * ball simulation uses from its next step on; the simulation itself is only
+ * advanced on the frames of the FrameClock. Schemas without a pitch channel
+ * leave the platform and ball alone.
  */
-void MainWindow::updateCharts(double rollValue, double pitchValue) {
-    qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
-
-    chartManager->updateCharts(currentTime, rollValue, pitchValue);
-
-    terminalLogger->logMeasurement(pitchValue, rollValue);
-
-    platform->setAngle(pitchValue);
-    updateBallPosition(pitchValue);
+void MainWindow::updateCharts(int port, const SampleBlock &samples) {
+    if (samples.isEmpty()) {
+        return;
+    }
 
-    // Apply the current chart duration to the axes
-    QDateTime minTime = QDateTime::fromMSecsSinceEpoch(currentTime - chartDuration);
-    QDateTime maxTime = QDateTime::fromMSecsSinceEpoch(currentTime);
+    chartManager->updateCharts(samples, port);
 
-    QDateTimeAxis *axisXRoll = qobject_cast<QDateTimeAxis*>(chartManager->getRollChart()->axes(Qt::Horizontal).first());
-    if (axisXRoll) {
-        axisXRoll->setMin(minTime);
-        axisXRoll->setMax(maxTime);
+    if (sessionRecorder->isRecording()) {
+        sessionRecorder->record(samples, port);
     }
 
-    QDateTimeAxis *axisXPitch = qobject_cast<QDateTimeAxis*>(chartManager->getPitchChart()->axes(Qt::Horizontal).first());
-    if (axisXPitch) {
-        axisXPitch->setMin(minTime);
-        axisXPitch->setMax(maxTime);
-    }
+    terminalLogger->logMeasurements(samples, port);
+    frameClock->requestFrame();
 
-    chartManager->getRollChartView()->repaint();
-    chartManager->getPitchChartView()->repaint();
+    if (port != 0 || pitchChannel < 0 || pitchChannel >= samples.channelCount()) {
+        return;
+    }
+    const double pitch = samples.value(pitchChannel, samples.size() - 1);
+    platform->setAngle(pitch);
+    physics.setTilt(pitch);
 }
 
-
 /**
- * @brief Updates the ball position based on the pitch value.
- * @param pitch The pitch value.
+ * @brief Advances the ball simulation to the current time and moves the ball.
+ *
+ * The physics engine runs as many fixed steps as the time since the last
+ * update covers, and the ball is drawn at the state interpolated between
+ * the last two steps. The countdown stops when the ball rolls off the
+ * platform.
  */
-void MainWindow::updateBallPosition(double pitch) {
-    if (ball->isFalling()) {
-        ball->fall();
-        if (isCounting) {
-            isCounting = false;
-            clockTimer->stop();
-        }
-        return;
-    }
-
-    double ballPosition = calculateBallPosition(pitch);
-    double platformWidth = platform->rect().width();
-
-    if (ballPosition < -platformWidth / 2 || ballPosition > platformWidth / 2) {
-        ball->fall();
+void MainWindow::updateBallPosition() {
+    qint64 now = SampleClock::now();
+    physics.setPlatform(platform->x(), platform->y(), platform->rect().width() / 2);
+    physics.advance(now - lastPhysicsUpdate);
+    lastPhysicsUpdate = now;
+
+    BallState state = physics.state();
+    if (state.falling) {
+        ball->fall(state.x, state.y);
         if (isCounting) {
             isCounting = false;
             clockTimer->stop();
         }
     } else {
-        double angleRad = qDegreesToRadians(platform->rotation());
-        double ballX = platform->x() + ballPosition * cos(angleRad);
-        double ballY = platform->y() + ballPosition * sin(angleRad);
-
-        ball->setPosition(ballX, ballY);
+        ball->setPosition(state.x, state.y);
     }
 }
 
-/**
- * @brief Calculates the new ball position based on the pitch value.
- * @param pitch The pitch value.
- * @return The new ball position.
- */
-double MainWindow::calculateBallPosition(double pitch) {
-    double g = 9.81;
-    double ballSpeed = g * sin(pitch * M_PI / 180.0);
-    static double ballPosition = 0;
-
-    ballPosition += ballSpeed * 0.1;
-    return ballPosition;
-}
-
 /**
  * @brief Increases the platform width.
  */
@@ -261,12 +546,24 @@ void MainWindow::decreasePlatformWidth()
 
 /**
  * @brief Updates the LED indicator based on the serial port status.
+ * @param port The index of the port.
  * @param isOpen The status of the serial port.
+ *
+ * The LED is green when all ports are open, yellow when only some of them
+ * are and red when none is.
  */
-void MainWindow::updateLedIndicator(bool isOpen)
+void MainWindow::updateLedIndicator(int port, bool isOpen)
 {
-    if (isOpen) {
+    if (port < 0 || port >= portOpen.size()) {
+        return;
+    }
+    portOpen[port] = isOpen;
+
+    int openCount = portOpen.count(true);
+    if (openCount == portOpen.size()) {
         ledIndicator->setStyleSheet("background-color: green;");
+    } else if (openCount > 0) {
+        ledIndicator->setStyleSheet("background-color: yellow;");
     } else {
         ledIndicator->setStyleSheet("background-color: red;");
     }
@@ -278,24 +575,7 @@ void MainWindow::updateLedIndicator(bool isOpen)
 void MainWindow::applyTimeScale()
 {
     qDebug() << "Applying time scale. Duration: " << chartDuration / 1000 << " seconds.";
-    qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
-    QDateTime minTime = QDateTime::fromMSecsSinceEpoch(currentTime - chartDuration);
-    QDateTime maxTime = QDateTime::fromMSecsSinceEpoch(currentTime);
-
-    QDateTimeAxis *axisXRoll = qobject_cast<QDateTimeAxis*>(chartManager->getRollChart()->axes(Qt::Horizontal).first());
-    if (axisXRoll) {
-        axisXRoll->setMin(minTime);
-        axisXRoll->setMax(maxTime);
-    }
-
-    QDateTimeAxis *axisXPitch = qobject_cast<QDateTimeAxis*>(chartManager->getPitchChart()->axes(Qt::Horizontal).first());
-    if (axisXPitch) {
-        axisXPitch->setMin(minTime);
-        axisXPitch->setMax(maxTime);
-    }
-
-    chartManager->getRollChartView()->repaint();
-    chartManager->getPitchChartView()->repaint();
+    chartManager->setChartDuration(chartDuration);
 }
 
 /**
@@ -303,6 +583,7 @@ void MainWindow::applyTimeScale()
  */
 void MainWindow::decreaseTimeScale()
 {
+    chartDuration = chartManager->getChartDuration(); // The charts may have been zoomed with the mouse
     if (chartDuration > 5 * 1000) { // Ensure the duration doesn't go below 5 seconds
         chartDuration -= 5 * 1000; // Decrease by 5 seconds
         applyTimeScale();
@@ -317,6 +598,7 @@ void MainWindow::decreaseTimeScale()
  */
 void MainWindow::increaseTimeScale()
 {
+    chartDuration = chartManager->getChartDuration(); // The charts may have been zoomed with the mouse
     chartDuration += 5 * 1000; // Increase by 5 seconds
     applyTimeScale();
     qDebug() << "Time scale increased. New duration: " << chartDuration / 1000 << " seconds.";
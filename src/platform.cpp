@@ -1,29 +1,37 @@
 #include "platform.h"
-#include <QDebug>
+#include "Tracer.h"
 
 /**
  * @brief Constructs a Platform object.
  * @param parent The parent graphics item.
  *
- * Initializes the platform with default dimensions and angle.
+ * Initializes the platform with default dimensions and angle. The platform
+ * is painted once into a pixmap in item coordinates, at twice its size so
+ * it stays sharp when scaled, and rotating it only transforms that pixmap.
  */
 Platform::Platform(QGraphicsItem *parent)
     : QGraphicsRectItem(parent), m_angle(0)
 {
     setRect(-200, -20, 400, 40); // Set the dimensions of the platform
+    setCacheMode(QGraphicsItem::ItemCoordinateCache, (boundingRect().size() * 2).toSize());
 }
 
 /**
  * @brief Sets the angle of the platform.
  * @param angle The new angle of the platform.
  *
- * Updates the angle and applies the rotation to the platform.
+ * Updates the angle and applies the rotation to the platform. The angle is
+ * traced in the graphics category. Setting the current angle again does
+ * nothing, so the platform is only repainted when it actually turns.
  */
 void Platform::setAngle(double angle)
 {
+    if (angle == m_angle) {
+        return;
+    }
     m_angle = angle;
     setRotation(m_angle);
-    qDebug() << "Platform angle set to:" << m_angle; // Debugging angle
+    Tracer::debug(Tracer::Graphics, "Platform angle set to: %1", m_angle);
 }
 
 /**
@@ -32,7 +40,9 @@ void Platform::setAngle(double angle)
  * @param option The style options for the item.
  * @param widget The widget on which the item is drawn.
  *
- * This function calls the base class paint function to handle the default painting.
+ * This function calls the base class paint function to handle the default
+ * painting. It only runs when the cached pixmap is drawn, not on every
+ * frame.
  */
 void Platform::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
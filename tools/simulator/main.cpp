@@ -0,0 +1,347 @@
+#include "Cobs.h"
+#include "Crc16.h"
+#include "FrameParser.h"
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <random>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @struct Options
+ * @brief The settings of a simulation run, taken from the command line.
+ */
+struct Options
+{
+    double rate = 1000.0;      ///< Frames per second.
+    double amplitude = 30.0;   ///< Amplitude of the roll and pitch motion in degrees.
+    double frequency = 0.5;    ///< Frequency of the motion in Hz.
+    double noise = 0.5;        ///< Standard deviation of the noise added to every value in degrees.
+    double crcErrors = 0.0;    ///< Fraction of frames sent with a wrong CRC.
+    int burst = 1;             ///< Frames written together; the average rate is unchanged.
+    double pauseEvery = 0.0;   ///< Seconds between stalls of the sender, 0 for none.
+    double pause = 0.0;        ///< Length of a stall in milliseconds.
+    double duration = 0.0;     ///< Seconds to run, 0 to run until interrupted.
+    bool sequenced = false;    ///< Send sequence numbers and device time.
+    bool binary = false;       ///< Send COBS-framed binary packets instead of text lines.
+    const char *link = nullptr; ///< Path of a symbolic link to create to the terminal, or nullptr.
+};
+
+/**
+ * @struct Counters
+ * @brief What was sent since the last report.
+ */
+struct Counters
+{
+    unsigned long long frames = 0;    ///< Frames written.
+    unsigned long long corrupted = 0; ///< Frames written with a wrong CRC.
+    unsigned long long dropped = 0;   ///< Frames discarded because the terminal buffer was full.
+    unsigned long long bytes = 0;     ///< Bytes written.
+};
+
+/**
+ * @brief Cleared by SIGINT and SIGTERM to end the run.
+ */
+volatile std::sig_atomic_t running = 1;
+
+/**
+ * @brief Signal handler ending the run.
+ */
+void stop(int)
+{
+    running = 0;
+}
+
+/**
+ * @brief Gets the monotonic time.
+ * @return The time in nanoseconds.
+ */
+long long now()
+{
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<long long>(time.tv_sec) * 1000000000LL + time.tv_nsec;
+}
+
+/**
+ * @brief Sleeps until a monotonic time.
+ * @param time The time in nanoseconds.
+ */
+void sleepUntil(long long time)
+{
+    timespec deadline;
+    deadline.tv_sec = static_cast<time_t>(time / 1000000000LL);
+    deadline.tv_nsec = static_cast<long>(time % 1000000000LL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR && running) {
+    }
+}
+
+/**
+ * @brief Prints the command line options.
+ * @param program The name of the program.
+ */
+void usage(const char *program)
+{
+    std::printf("Usage: %s [options]\n"
+                "  --rate <Hz>          Frames per second (default 1000).\n"
+                "  --amplitude <deg>    Amplitude of the motion (default 30).\n"
+                "  --frequency <Hz>     Frequency of the motion (default 0.5).\n"
+                "  --noise <deg>        Standard deviation of the noise (default 0.5).\n"
+                "  --crc-errors <frac>  Fraction of frames with a wrong CRC (default 0).\n"
+                "  --burst <n>          Frames written at once, at the same average rate (default 1).\n"
+                "  --pause-every <s>    Stall the sender every s seconds (default never).\n"
+                "  --pause <ms>         Length of a stall (default 0).\n"
+                "  --duration <s>       Stop after s seconds (default never).\n"
+                "  --sequenced          Send sequence numbers and device time.\n"
+                "  --binary             Send COBS-framed binary packets.\n"
+                "  --link <path>        Create a symbolic link to the terminal.\n",
+                program);
+}
+
+/**
+ * @brief Reads the command line.
+ * @param argc The number of arguments.
+ * @param argv The arguments.
+ * @param options Receives the settings.
+ * @return True if all arguments are valid.
+ */
+bool parseOptions(int argc, char *argv[], Options &options)
+{
+    struct Numeric
+    {
+        const char *name;
+        double *value;
+    };
+    const Numeric numerics[] = {
+        { "--rate", &options.rate },
+        { "--amplitude", &options.amplitude },
+        { "--frequency", &options.frequency },
+        { "--noise", &options.noise },
+        { "--crc-errors", &options.crcErrors },
+        { "--pause-every", &options.pauseEvery },
+        { "--pause", &options.pause },
+        { "--duration", &options.duration },
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        const char *argument = argv[i];
+        const bool hasValue = i + 1 < argc;
+        bool known = false;
+        for (const Numeric &numeric : numerics) {
+            if (std::strcmp(argument, numeric.name) == 0 && hasValue) {
+                *numeric.value = std::atof(argv[++i]);
+                known = true;
+            }
+        }
+        if (known) {
+            continue;
+        }
+        if (std::strcmp(argument, "--burst") == 0 && hasValue) {
+            options.burst = std::atoi(argv[++i]);
+        } else if (std::strcmp(argument, "--link") == 0 && hasValue) {
+            options.link = argv[++i];
+        } else if (std::strcmp(argument, "--sequenced") == 0) {
+            options.sequenced = true;
+        } else if (std::strcmp(argument, "--binary") == 0) {
+            options.binary = true;
+        } else {
+            return false;
+        }
+    }
+    return options.rate > 0 && options.burst > 0 && options.crcErrors >= 0 && options.crcErrors <= 1;
+}
+
+/**
+ * @brief Creates a pseudo-terminal in raw mode.
+ * @param name Receives the path of the terminal device the application opens.
+ * @return The descriptor of the master side, or -1 on failure.
+ *
+ * The master side is non-blocking, so a reader that falls behind makes
+ * writes fail instead of stalling the sender, as an overrun UART would. The
+ * terminal side is kept open so the device survives the application
+ * closing and reopening it.
+ */
+int openTerminal(const char *&name)
+{
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0 || (name = ptsname(master)) == nullptr) {
+        return -1;
+    }
+    int terminal = open(name, O_RDWR | O_NOCTTY);
+    if (terminal < 0) {
+        return -1;
+    }
+    termios settings;
+    tcgetattr(terminal, &settings);
+    cfmakeraw(&settings); // No echo and no newline translation
+    tcsetattr(terminal, TCSANOW, &settings);
+
+    fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+    return master;
+}
+
+/**
+ * @brief Writes a frame in the configured wire format.
+ * @param frame The frame.
+ * @param binary True for a binary packet, false for a text line.
+ * @param corrupt True to send a wrong CRC.
+ * @param out Receives the encoded frame; must hold FrameParser::MaxLineLength bytes.
+ * @return The number of bytes written.
+ *
+ * Text lines are "b<roll> <pitch> <crc>" or, sequenced, "s<sequence>
+ * <time> <roll> <pitch> <crc>", ended by "\n\r" like the sensor board.
+ * A corrupted binary packet is decoded, has a bit of its CRC flipped and is
+ * encoded again, so it still frames correctly.
+ */
+std::size_t encode(const Frame &frame, bool binary, bool corrupt, char *out)
+{
+    if (binary) {
+        std::size_t length = FrameParser::encodePacket(frame, out);
+        if (corrupt) {
+            char payload[FrameParser::MaxPacketLength];
+            std::size_t payloadLength;
+            Cobs::decode(out, length - 1, payload, payloadLength);
+            payload[payloadLength - 1] ^= 0x01;
+            length = Cobs::encode(payload, payloadLength, out);
+            out[length++] = 0; // Delimiter
+        }
+        return length;
+    }
+
+    int length;
+    if (frame.sequenced) {
+        length = std::snprintf(out, FrameParser::MaxLineLength, "s%u %u %.2f %.2f",
+                               frame.sequence, frame.deviceTime, frame.values[0], frame.values[1]);
+    } else {
+        length = std::snprintf(out, FrameParser::MaxLineLength, "b%.2f %.2f", frame.values[0], frame.values[1]);
+    }
+    uint16_t crc = Crc16::compute(out, static_cast<std::size_t>(length));
+    if (corrupt) {
+        crc ^= 0x0001;
+    }
+    length += std::snprintf(out + length, FrameParser::MaxLineLength - length, " %04X\n\r", crc);
+    return static_cast<std::size_t>(length);
+}
+
+} // namespace
+
+/**
+ * @brief Runs the sensor simulator.
+ *
+ * Opens a pseudo-terminal, prints its name and sends roll and pitch frames
+ * of a sinusoidal motion with Gaussian noise at a fixed rate until
+ * interrupted. Frames are scheduled on absolute deadlines, so the rate does
+ * not drift with the time spent encoding. Bursts write several frames at
+ * once and stalls hold the sender back, after which the missed frames are
+ * written together, which exercises the receiver's handling of uneven
+ * arrival. Once per second the achieved rate and the numbers of corrupted
+ * and dropped frames are printed.
+ */
+int main(int argc, char *argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    const char *name = nullptr;
+    int master = openTerminal(name);
+    if (master < 0) {
+        std::perror("Cannot create a pseudo-terminal");
+        return 1;
+    }
+    if (options.link) {
+        unlink(options.link);
+        if (symlink(name, options.link) != 0) {
+            std::perror("Cannot create the link");
+        }
+    }
+    std::printf("Sending %g frames/s on %s\n", options.rate, options.link ? options.link : name);
+    std::fflush(stdout);
+
+    std::signal(SIGINT, stop);
+    std::signal(SIGTERM, stop);
+
+    std::mt19937 random(1);
+    std::normal_distribution<double> noise(0.0, options.noise > 0 ? options.noise : 1.0);
+    std::bernoulli_distribution crcError(options.crcErrors);
+    const double noiseScale = options.noise > 0 ? 1.0 : 0.0;
+
+    const double period = 1e9 / options.rate;
+    const long long start = now();
+    const long long end = options.duration > 0 ? start + static_cast<long long>(options.duration * 1e9) : 0;
+    const long long pauseInterval = static_cast<long long>(options.pauseEvery * 1e9);
+    long long nextPause = pauseInterval > 0 ? start + pauseInterval : 0;
+    long long nextReport = start + 1000000000LL;
+
+    static char buffer[1 << 20];
+    std::size_t bufferLength = 0;
+    unsigned long long sequence = 0;
+    Counters counters;
+
+    while (running && (end == 0 || now() < end)) {
+        const long long deadline = start + static_cast<long long>(static_cast<double>(sequence + options.burst - 1) * period);
+        sleepUntil(deadline);
+        if (nextPause != 0 && deadline >= nextPause) {
+            sleepUntil(deadline + static_cast<long long>(options.pause * 1e6));
+            nextPause += pauseInterval;
+        }
+
+        // Every frame up to the current time is due, more than one burst after a stall
+        const long long current = now();
+        std::size_t burstFrames = 0;
+        while (static_cast<double>(sequence) * period <= static_cast<double>(current - start)
+               && bufferLength + FrameParser::MaxLineLength <= sizeof(buffer)) {
+            const double time = static_cast<double>(sequence) * period / 1e9;
+            const double phase = 2.0 * M_PI * options.frequency * time;
+
+            Frame frame;
+            frame.channelCount = 2;
+            frame.values[0] = options.amplitude * std::sin(phase) + noiseScale * noise(random);
+            frame.values[1] = options.amplitude * std::cos(phase) + noiseScale * noise(random);
+            frame.sequenced = options.sequenced;
+            frame.sequence = static_cast<uint32_t>(sequence);
+            frame.deviceTime = static_cast<uint32_t>(static_cast<unsigned long long>(time * 1e6));
+
+            bool corrupt = crcError(random);
+            bufferLength += encode(frame, options.binary, corrupt, buffer + bufferLength);
+            counters.corrupted += corrupt ? 1 : 0;
+            ++counters.frames;
+            ++sequence;
+            ++burstFrames;
+        }
+
+        ssize_t written = write(master, buffer, bufferLength);
+        if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            counters.dropped += burstFrames; // Nobody is reading fast enough
+            counters.frames -= burstFrames;
+        } else if (written > 0) {
+            // A short write cuts the last frame, which the receiver rejects like an overrun
+            counters.bytes += static_cast<unsigned long long>(written);
+        }
+        bufferLength = 0;
+
+        if (current >= nextReport) {
+            std::printf("%llu frames/s, %llu bytes/s, %llu corrupted, %llu dropped\n",
+                        counters.frames, counters.bytes, counters.corrupted, counters.dropped);
+            std::fflush(stdout);
+            counters = Counters();
+            nextReport += 1000000000LL;
+        }
+    }
+
+    if (options.link) {
+        unlink(options.link);
+    }
+    close(master);
+    return 0;
+}
@@ -0,0 +1,22 @@
+# Synthetic attitude sensor on a pseudo-terminal, for load testing without
+# hardware. Build with qmake && make, start ./simulator --rate 5000 and point
+# the application at the printed device, e.g. aplikacja --port /dev/pts/3.
+
+TEMPLATE = app
+TARGET = simulator
+
+CONFIG += console c++17
+CONFIG -= app_bundle qt
+
+INCLUDEPATH += ../../inc
+
+SOURCES += \
+    main.cpp \
+    ../../src/Cobs.cpp \
+    ../../src/Crc16.cpp \
+    ../../src/FrameParser.cpp
+
+HEADERS += \
+    ../../inc/Cobs.h \
+    ../../inc/Crc16.h \
+    ../../inc/FrameParser.h
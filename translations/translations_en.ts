@@ -33,5 +33,143 @@
         <source>Width -</source>
         <translation>Width -</translation>
     </message>
+    <message>
+        <location filename="../ui/mainwindow.ui" line="105"/>
+        <source>OpenGL charts</source>
+        <translation>OpenGL charts</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="160"/>
+        <source>Raw</source>
+        <translation>Raw</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="161"/>
+        <source>Min/Max</source>
+        <translation>Min/Max</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="162"/>
+        <source>LTTB</source>
+        <translation>LTTB</translation>
+    </message>
+</context>
+<context>
+    <name>StatsMonitor</name>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="126"/>
+        <source>Bytes/s</source>
+        <translation>Bytes/s</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="127"/>
+        <source>Frames/s</source>
+        <translation>Frames/s</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="128"/>
+        <source>CRC failures</source>
+        <translation>CRC failures</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="129"/>
+        <source>Format errors</source>
+        <translation>Format errors</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="130"/>
+        <source>Dropped frames</source>
+        <translation>Dropped frames</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="131"/>
+        <source>Lost frames</source>
+        <translation>Lost frames</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="132"/>
+        <source>Recorded bytes/s</source>
+        <translation>Recorded bytes/s</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="133"/>
+        <source>Dropped trace messages</source>
+        <translation>Dropped trace messages</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="134"/>
+        <source>Parse time (us)</source>
+        <translation>Parse time (us)</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="135"/>
+        <source>Queue depth (samples)</source>
+        <translation>Queue depth (samples)</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="136"/>
+        <source>Read to drain (us)</source>
+        <translation>Read to drain (us)</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="137"/>
+        <source>Chart update (us)</source>
+        <translation>Chart update (us)</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="138"/>
+        <source>Repaint (us)</source>
+        <translation>Repaint (us)</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="139"/>
+        <source>Drain to repaint (us)</source>
+        <translation>Drain to repaint (us)</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="140"/>
+        <source>Display frames/s</source>
+        <translation>Display frames/s</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="141"/>
+        <source>Dropped display frames</source>
+        <translation>Dropped display frames</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="142"/>
+        <source>Frame jitter (us)</source>
+        <translation>Frame jitter (us)</translation>
+    </message>
+    <message>
+        <location filename="../src/StatsMonitor.cpp" line="180"/>
+        <source>Metric</source>
+        <translation>Metric</translation>
+    </message>
+    <message>
+        <location filename="../src/StatsMonitor.cpp" line="182"/>
+        <source>Value</source>
+        <translation>Value</translation>
+    </message>
+    <message>
+        <location filename="../src/StatsMonitor.cpp" line="184"/>
+        <source>Mean</source>
+        <translation>Mean</translation>
+    </message>
+    <message>
+        <location filename="../src/StatsMonitor.cpp" line="186"/>
+        <source>p50</source>
+        <translation>p50</translation>
+    </message>
+    <message>
+        <location filename="../src/StatsMonitor.cpp" line="188"/>
+        <source>p99</source>
+        <translation>p99</translation>
+    </message>
+    <message>
+        <location filename="../src/StatsMonitor.cpp" line="190"/>
+        <source>Max</source>
+        <translation>Max</translation>
+    </message>
 </context>
 </TS>
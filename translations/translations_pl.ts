@@ -33,5 +33,143 @@
         <source>Width -</source>
         <translation type="unfinished">Szer. belki -</translation>
     </message>
+    <message>
+        <location filename="../ui/mainwindow.ui" line="105"/>
+        <source>OpenGL charts</source>
+        <translation>Wykresy OpenGL</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="160"/>
+        <source>Raw</source>
+        <translation>Surowe</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="161"/>
+        <source>Min/Max</source>
+        <translation>Min/Maks</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="162"/>
+        <source>LTTB</source>
+        <translation>LTTB</translation>
+    </message>
+</context>
+<context>
+    <name>StatsMonitor</name>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="126"/>
+        <source>Bytes/s</source>
+        <translation>Bajty/s</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="127"/>
+        <source>Frames/s</source>
+        <translation>Ramki/s</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="128"/>
+        <source>CRC failures</source>
+        <translation>Błędy CRC</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="129"/>
+        <source>Format errors</source>
+        <translation>Błędy formatu</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="130"/>
+        <source>Dropped frames</source>
+        <translation>Odrzucone ramki</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="131"/>
+        <source>Lost frames</source>
+        <translation>Utracone ramki</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="132"/>
+        <source>Recorded bytes/s</source>
+        <translation>Zapisane bajty/s</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="133"/>
+        <source>Dropped trace messages</source>
+        <translation>Odrzucone komunikaty śledzenia</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="134"/>
+        <source>Parse time (us)</source>
+        <translation>Czas dekodowania (us)</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="135"/>
+        <source>Queue depth (samples)</source>
+        <translation>Długość kolejki (próbki)</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="136"/>
+        <source>Read to drain (us)</source>
+        <translation>Od odczytu do pobrania (us)</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="137"/>
+        <source>Chart update (us)</source>
+        <translation>Aktualizacja wykresów (us)</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="138"/>
+        <source>Repaint (us)</source>
+        <translation>Odświeżanie (us)</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="139"/>
+        <source>Drain to repaint (us)</source>
+        <translation>Od pobrania do odświeżenia (us)</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="140"/>
+        <source>Display frames/s</source>
+        <translation>Klatki ekranu/s</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="141"/>
+        <source>Dropped display frames</source>
+        <translation>Pominięte klatki ekranu</translation>
+    </message>
+    <message>
+        <location filename="../src/mainwindow.cpp" line="142"/>
+        <source>Frame jitter (us)</source>
+        <translation>Wahania klatek (us)</translation>
+    </message>
+    <message>
+        <location filename="../src/StatsMonitor.cpp" line="180"/>
+        <source>Metric</source>
+        <translation>Metryka</translation>
+    </message>
+    <message>
+        <location filename="../src/StatsMonitor.cpp" line="182"/>
+        <source>Value</source>
+        <translation>Wartość</translation>
+    </message>
+    <message>
+        <location filename="../src/StatsMonitor.cpp" line="184"/>
+        <source>Mean</source>
+        <translation>Średnia</translation>
+    </message>
+    <message>
+        <location filename="../src/StatsMonitor.cpp" line="186"/>
+        <source>p50</source>
+        <translation>p50</translation>
+    </message>
+    <message>
+        <location filename="../src/StatsMonitor.cpp" line="188"/>
+        <source>p99</source>
+        <translation>p99</translation>
+    </message>
+    <message>
+        <location filename="../src/StatsMonitor.cpp" line="190"/>
+        <source>Max</source>
+        <translation>Maks.</translation>
+    </message>
 </context>
 </TS>